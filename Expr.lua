@@ -0,0 +1,163 @@
+--
+--  Copyright (c) 2015, Facebook, Inc.
+--  All rights reserved.
+--
+--  This source code is licensed under the BSD-style license found in the
+--  LICENSE file in the root directory of this source tree. An additional grant
+--  of patent rights can be found in the PATENTS file in the same directory.
+
+-- Lazy elementwise expressions: x:lazy():cmul(y):add(c):exp():mul(s)
+-- records the ops instead of running them, and eval() runs the whole chain
+-- in a single pass over memory (THZTensor_(evalExpr)).
+
+local argcheck = require 'argcheck'
+local C = require 'ztorch.THZ'
+local torch = require 'torch'
+local ztorch = require 'ztorch.env'
+local ffi=require 'ffi'
+
+-- the THZ_EXPR_* opcodes of THZTensor.h
+local opcodes = {
+   load=0, const=1,
+   add=2, sub=3, mul=4, div=5, mulconj=6, pow=7,
+   neg=8, conj=9, exp=10, log=11, sqrt=12,
+   cos=13, sin=14, tan=15, acos=16, asin=17, atan=18,
+   cosh=19, sinh=20, tanh=21, proj=22,
+}
+local REGISTERS = 8
+local MAX_INPUTS = 16
+
+for _,Real in ipairs{'Float', 'Double'} do
+   local ztypename = 'torch.Z' .. Real .. 'Tensor'
+   local typename = 'torch.Z' .. Real .. 'Expr'
+   local THZTensor = 'THZ' .. Real .. 'Tensor'
+   local THZTensor_evalExpr = C[THZTensor .. '_evalExpr']
+   local complexArray = (Real == 'Float' and 'float' or 'double') .. ' _Complex[?]'
+   local tensorArray = THZTensor .. '*[?]'
+
+   -- a node of the expression tree: op, and its operands a and b, which are
+   -- nodes, or the tensor or constant of a load or const node
+   local Expr = {__typename = typename}
+   Expr.__index = Expr
+
+   local function node(op, a, b)
+      return setmetatable({op=op, a=a, b=b}, Expr)
+   end
+
+   local function operand(v)
+      if getmetatable(v) == Expr then
+         return v
+      elseif torch.type(v) == ztypename then
+         return node('load', v)
+      elseif type(v) == 'number' or ztorch.isComplex(v) then
+         return node('const', v)
+      end
+      error(string.format('%s or scalar expected, got %s', ztypename, torch.type(v)))
+   end
+
+   -- appends the code computing e into register reg, using the registers
+   -- above it as scratch; operands too deep for the registers left are
+   -- evaluated beforehand
+   local function compile(e, reg, prog)
+      local op = e.op
+      if op == 'load' then
+         local key = torch.pointer(e.a)
+         local idx = prog.inputIndex[key]
+         if not idx then
+            assert(#prog.inputs < MAX_INPUTS, 'too many tensors in one expression')
+            table.insert(prog.inputs, e.a)
+            idx = #prog.inputs-1
+            prog.inputIndex[key] = idx
+         end
+         table.insert(prog.code, {opcodes.load, reg, idx, 0})
+      elseif op == 'const' then
+         table.insert(prog.constants, e.a)
+         table.insert(prog.code, {opcodes.const, reg, #prog.constants-1, 0})
+      elseif e.b then
+         if reg+1 >= REGISTERS then
+            -- out of registers: e goes through a temporary of its own
+            compile(node('load', e:eval()), reg, prog)
+            return
+         end
+         compile(e.a, reg, prog)
+         compile(e.b, reg+1, prog)
+         table.insert(prog.code, {opcodes[op], reg, reg, reg+1})
+      else
+         compile(e.a, reg, prog)
+         table.insert(prog.code, {opcodes[op], reg, reg, 0})
+      end
+   end
+
+   -- runs the expression into dst, or into a new tensor; dst may be one of
+   -- the tensors of the expression
+   function Expr:eval(dst)
+      assert(dst == nil or torch.type(dst) == ztypename, ztypename .. ' expected')
+      local prog = {code={}, inputs={}, inputIndex={}, constants={}}
+      compile(self, 0, prog)
+      local code = {}
+      for _,ins in ipairs(prog.code) do
+         for _,v in ipairs(ins) do
+            table.insert(code, v)
+         end
+      end
+      dst = dst or torch['Z' .. Real .. 'Tensor']()
+      THZTensor_evalExpr(dst, ffi.new('int[?]', #code, code), #prog.code,
+                         ffi.new(tensorArray, #prog.inputs, prog.inputs), #prog.inputs,
+                         ffi.new(complexArray, #prog.constants, prog.constants), #prog.constants)
+      return dst
+   end
+
+   -- the ops mirror the in-place ZTensor methods of the same names
+   function Expr:add(value, src)
+      if src ~= nil then
+         return node('add', self, node('mul', operand(src), operand(value)))
+      end
+      return node('add', self, operand(value))
+   end
+
+   function Expr:mul(value)
+      return node('mul', self, operand(value))
+   end
+
+   function Expr:div(value)
+      return node('div', self, operand(value))
+   end
+
+   function Expr:cmul(src)
+      return node('mul', self, operand(src))
+   end
+
+   function Expr:cdiv(src)
+      return node('div', self, operand(src))
+   end
+
+   function Expr:cmulconj(src)
+      return node('mulconj', self, operand(src))
+   end
+
+   function Expr:pow(value)
+      return node('pow', self, operand(value))
+   end
+
+   function Expr:neg()
+      return node('neg', self)
+   end
+
+   for _,name in ipairs{'log', 'exp', 'cos', 'acos', 'cosh', 'sin', 'asin',
+                        'sinh', 'tan', 'atan', 'tanh', 'sqrt',
+                        'conj', 'proj'} do
+      Expr[name] = function(self)
+         return node(name, self)
+      end
+   end
+
+   local ZTensor = torch.getmetatable(ztypename)
+   ZTensor.lazy = argcheck{
+      nonamed=true,
+      {name="src", type=ztypename},
+      call =
+         function(src)
+            return node('load', src)
+         end
+   }
+end
@@ -0,0 +1,529 @@
+--
+--  Copyright (c) 2015, Facebook, Inc.
+--  All rights reserved.
+--
+--  This source code is licensed under the BSD-style license found in the
+--  LICENSE file in the root directory of this source tree. An additional grant
+--  of patent rights can be found in the PATENTS file in the same directory.
+
+local argcheck = require 'argcheck'
+local C = require 'ztorch.THZ'
+local torch = require 'torch'
+local ztorch = require 'ztorch.env'
+local ffi=require 'ffi'
+
+for _,Real in ipairs{'Float', 'Double'} do
+   local ztypename = 'torch.Z' .. Real .. 'Tensor'
+   local typename = 'torch.Z' .. Real .. 'SplitTensor'
+   local realtypename = 'torch.' .. Real .. 'Tensor'
+   local THZTensor = 'THZ' .. Real .. 'Tensor'
+   local THZSplitTensor = 'THZ' .. Real .. 'SplitTensor'
+   local THZTensor_copySplit = C[THZTensor .. '_copySplit']
+   local THZTensor_new = C[THZTensor .. '_new']
+   local THZTensor_free = C[THZTensor .. '_free']
+   local THZTensor_resize = C[THZTensor .. '_resize']
+   local THZSplitTensor_abs = C[THZSplitTensor .. '_abs']
+   local THZSplitTensor_add = C[THZSplitTensor .. '_add']
+   local THZSplitTensor_addcmul = C[THZSplitTensor .. '_addcmul']
+   local THZSplitTensor_cadd = C[THZSplitTensor .. '_cadd']
+   local THZSplitTensor_cmul = C[THZSplitTensor .. '_cmul']
+   local THZSplitTensor_conj = C[THZSplitTensor .. '_conj']
+   local THZSplitTensor_copy = C[THZSplitTensor .. '_copy']
+   local THZSplitTensor_copyZ = C[THZSplitTensor .. '_copyZ']
+   local THZSplitTensor_fill = C[THZSplitTensor .. '_fill']
+   local THZSplitTensor_free = C[THZSplitTensor .. '_free']
+   local THZSplitTensor_im = C[THZSplitTensor .. '_im']
+   local THZSplitTensor_isContiguous = C[THZSplitTensor .. '_isContiguous']
+   local THZSplitTensor_mul = C[THZSplitTensor .. '_mul']
+   local THZSplitTensor_nDimension = C[THZSplitTensor .. '_nDimension']
+   local THZSplitTensor_nElement = C[THZSplitTensor .. '_nElement']
+   local THZSplitTensor_narrow = C[THZSplitTensor .. '_narrow']
+   local THZSplitTensor_new = C[THZSplitTensor .. '_new']
+   local THZSplitTensor_newContiguous = C[THZSplitTensor .. '_newContiguous']
+   local THZSplitTensor_newNarrow = C[THZSplitTensor .. '_newNarrow']
+   local THZSplitTensor_newSelect = C[THZSplitTensor .. '_newSelect']
+   local THZSplitTensor_newSizeOf = C[THZSplitTensor .. '_newSizeOf']
+   local THZSplitTensor_newTranspose = C[THZSplitTensor .. '_newTranspose']
+   local THZSplitTensor_newWithParts = C[THZSplitTensor .. '_newWithParts']
+   local THZSplitTensor_newWithSize = C[THZSplitTensor .. '_newWithSize']
+   local THZSplitTensor_re = C[THZSplitTensor .. '_re']
+   local THZSplitTensor_resizeAs = C[THZSplitTensor .. '_resizeAs']
+   local THZSplitTensor_resizeAsZ = C[THZSplitTensor .. '_resizeAsZ']
+   local THZSplitTensor_select = C[THZSplitTensor .. '_select']
+   local THZSplitTensor_size = C[THZSplitTensor .. '_size']
+   local THZSplitTensor_sumall = C[THZSplitTensor .. '_sumall']
+   local THZSplitTensor_transpose = C[THZSplitTensor .. '_transpose']
+   local THZSplitTensor_zero = C[THZSplitTensor .. '_zero']
+   local THRealTensor_retain = C['TH' .. Real .. 'Tensor_retain']
+
+   -- real and complex scalars take the same path
+   local scalars = {{type='number', default=1}, {type='cdata', check=ztorch.isComplex}}
+
+   -- wraps a borrowed real part into a regular torch tensor
+   local function pushPart(part)
+      THRealTensor_retain(part)
+      return torch.pushudata(part, realtypename)
+   end
+
+   local SplitTensor = {}
+
+   SplitTensor.__new = argcheck{
+      nonamed=true,
+      call =
+         function()
+            local self = THZSplitTensor_new()
+            ffi.gc(self, THZSplitTensor_free)
+            return self
+         end
+   }
+
+   SplitTensor.__new = argcheck{
+      {name='size', type='torch.LongStorage'},
+      nonamed=true,
+      overload = SplitTensor.__new,
+      call =
+         function(size)
+            local self = THZSplitTensor_newWithSize(size:cdata())
+            ffi.gc(self, THZSplitTensor_free)
+            return self
+         end
+   }
+
+   SplitTensor.__new = argcheck{
+      {name='dim1', type='number'},
+      {name='dim2', type='number', opt=true},
+      {name='dim3', type='number', opt=true},
+      {name='dim4', type='number', opt=true},
+      nonamed=true,
+      overload = SplitTensor.__new,
+      call =
+         function(dim1, dim2, dim3, dim4)
+            local size = torch.LongStorage{dim1, dim2, dim3, dim4}
+            local self = THZSplitTensor_newWithSize(size:cdata())
+            ffi.gc(self, THZSplitTensor_free)
+            return self
+         end
+   }
+
+   SplitTensor.__new = argcheck{
+      {name='re', type=realtypename},
+      {name='im', type=realtypename},
+      nonamed=true,
+      overload = SplitTensor.__new,
+      call =
+         function(re, im)
+            local self = THZSplitTensor_newWithParts(re:cdata(), im:cdata())
+            ffi.gc(self, THZSplitTensor_free)
+            return self
+         end
+   }
+
+   SplitTensor.__new = argcheck{
+      {name='src', type=ztypename},
+      nonamed=true,
+      overload = SplitTensor.__new,
+      call =
+         function(src)
+            local self = THZSplitTensor_new()
+            ffi.gc(self, THZSplitTensor_free)
+            THZSplitTensor_resizeAsZ(self, src)
+            THZSplitTensor_copyZ(self, src)
+            return self
+         end
+   }
+
+   SplitTensor.new = SplitTensor.__new
+
+   -- access methods
+   SplitTensor.re = argcheck{
+      {name='self', type=typename},
+      nonamed=true,
+      call =
+         function(self)
+            return pushPart(THZSplitTensor_re(self))
+         end
+   }
+
+   SplitTensor.im = argcheck{
+      {name='self', type=typename},
+      nonamed=true,
+      call =
+         function(self)
+            return pushPart(THZSplitTensor_im(self))
+         end
+   }
+
+   SplitTensor.nDimension = argcheck{
+      {name='self', type=typename},
+      nonamed=true,
+      call =
+         function(self)
+            return tonumber(THZSplitTensor_nDimension(self))
+         end
+   }
+   SplitTensor.dim = SplitTensor.nDimension
+
+   SplitTensor.size = argcheck{
+      {name='self', type=typename},
+      {name='dim', type='number', opt=true},
+      nonamed=true,
+      call =
+         function(self, dim)
+            if dim then
+               return tonumber(THZSplitTensor_size(self, dim-1))
+            else
+               return torch.pushudata(THZSplitTensor_newSizeOf(self), 'torch.LongStorage')
+            end
+         end
+   }
+
+   SplitTensor.nElement = argcheck{
+      {name='self', type=typename},
+      nonamed=true,
+      call =
+         function(self)
+            return tonumber(THZSplitTensor_nElement(self))
+         end
+   }
+
+   SplitTensor.isContiguous = argcheck{
+      {name='self', type=typename},
+      nonamed=true,
+      call =
+         function(self)
+            return THZSplitTensor_isContiguous(self) == 1
+         end
+   }
+
+   SplitTensor.contiguous = argcheck{
+      {name='self', type=typename},
+      nonamed=true,
+      call =
+         function(self)
+            local tensor = THZSplitTensor_newContiguous(self)
+            ffi.gc(tensor, THZSplitTensor_free)
+            return tensor
+         end
+   }
+
+   SplitTensor.clone = argcheck{
+      {name='self', type=typename},
+      nonamed=true,
+      call =
+         function(self)
+            local tensor = THZSplitTensor_new()
+            ffi.gc(tensor, THZSplitTensor_free)
+            THZSplitTensor_resizeAs(tensor, self)
+            THZSplitTensor_copy(tensor, self)
+            return tensor
+         end
+   }
+
+   SplitTensor.resizeAs = argcheck{
+      {name='self', type=typename},
+      {name='src', type=typename},
+      nonamed=true,
+      call =
+         function(self, src)
+            THZSplitTensor_resizeAs(self, src)
+            return self
+         end
+   }
+
+   SplitTensor.resizeAs = argcheck{
+      {name='self', type=typename},
+      {name='src', type=ztypename},
+      nonamed=true,
+      overload = SplitTensor.resizeAs,
+      call =
+         function(self, src)
+            THZSplitTensor_resizeAsZ(self, src)
+            return self
+         end
+   }
+
+   -- views
+   SplitTensor.narrow = argcheck{
+      {name='self', type=typename},
+      {name='src', type=typename, opt=true},
+      {name='dim', type='number'},
+      {name='idx', type='number'},
+      {name='size', type='number'},
+      nonamed=true,
+      call =
+         function(self, src, dim, idx, size)
+            if src then
+               THZSplitTensor_narrow(self, src, dim-1, idx-1, size)
+               return self
+            else
+               local tensor = THZSplitTensor_newNarrow(self, dim-1, idx-1, size)
+               ffi.gc(tensor, THZSplitTensor_free)
+               return tensor
+            end
+         end
+   }
+
+   SplitTensor.select = argcheck{
+      {name='self', type=typename},
+      {name='src', type=typename, opt=true},
+      {name='dim', type='number'},
+      {name='idx', type='number'},
+      nonamed=true,
+      call =
+         function(self, src, dim, idx)
+            if src then
+               THZSplitTensor_select(self, src, dim-1, idx-1)
+               return self
+            else
+               local tensor = THZSplitTensor_newSelect(self, dim-1, idx-1)
+               ffi.gc(tensor, THZSplitTensor_free)
+               return tensor
+            end
+         end
+   }
+
+   SplitTensor.transpose = argcheck{
+      {name='self', type=typename},
+      {name='src', type=typename, opt=true},
+      {name='dim1', type='number'},
+      {name='dim2', type='number'},
+      nonamed=true,
+      call =
+         function(self, src, dim1, dim2)
+            if src then
+               THZSplitTensor_transpose(self, src, dim1-1, dim2-1)
+               return self
+            else
+               local tensor = THZSplitTensor_newTranspose(self, dim1-1, dim2-1)
+               ffi.gc(tensor, THZSplitTensor_free)
+               return tensor
+            end
+         end
+   }
+
+   SplitTensor.t = argcheck{
+      {name='self', type=typename},
+      nonamed=true,
+      call =
+         function(self)
+            assert(THZSplitTensor_nDimension(self) == 2, 'tensor to be transposed must be 2D')
+            local tensor = THZSplitTensor_newTranspose(self, 0, 1)
+            ffi.gc(tensor, THZSplitTensor_free)
+            return tensor
+         end
+   }
+
+   -- conversion
+   SplitTensor.copy = argcheck{
+      nonamed=true,
+      {name="dst", type=typename},
+      {name="src", type=typename},
+      call =
+         function(dst, src)
+            THZSplitTensor_copy(dst, src)
+            return dst
+         end
+   }
+
+   SplitTensor.copy = argcheck{
+      nonamed=true,
+      {name="dst", type=typename},
+      {name="src", type=ztypename},
+      overload=SplitTensor.copy,
+      call =
+         function(dst, src)
+            THZSplitTensor_copyZ(dst, src)
+            return dst
+         end
+   }
+
+   -- returns an interleaved copy
+   SplitTensor.interleaved = argcheck{
+      nonamed=true,
+      {name="src", type=typename},
+      call =
+         function(src)
+            local dst = THZTensor_new()
+            ffi.gc(dst, THZTensor_free)
+            local size = torch.pushudata(THZSplitTensor_newSizeOf(src), 'torch.LongStorage')
+            THZTensor_resize(dst, size:cdata(), nil)
+            THZTensor_copySplit(dst, src)
+            return dst
+         end
+   }
+
+   -- maths
+   for _,scalar in ipairs(scalars) do
+      SplitTensor.fill = argcheck{
+         nonamed=true,
+         {name="dst", type=typename},
+         {name="value", type=scalar.type, check=scalar.check},
+         overload=SplitTensor.fill,
+         call =
+            function(dst, value)
+               THZSplitTensor_fill(dst, value)
+               return dst
+            end
+      }
+
+      SplitTensor.add = argcheck{
+         nonamed=true,
+         {name="dst", type=typename, opt=true},
+         {name="src", type=typename},
+         {name="value", type=scalar.type, check=scalar.check},
+         overload=SplitTensor.add,
+         call =
+            function(dst, src, value)
+               dst = dst or src
+               THZSplitTensor_add(dst, src, value)
+               return dst
+            end
+      }
+
+      SplitTensor.add = argcheck{
+         nonamed=true,
+         {name="dst", type=typename, opt=true},
+         {name="src1", type=typename},
+         {name="value", type=scalar.type, check=scalar.check, default=scalar.default},
+         {name="src2", type=typename},
+         overload=SplitTensor.add,
+         call =
+            function(dst, src1, value, src2)
+               dst = dst or src1
+               THZSplitTensor_cadd(dst, src1, value, src2)
+               return dst
+            end
+      }
+
+      SplitTensor.mul = argcheck{
+         nonamed=true,
+         {name="dst", type=typename, opt=true},
+         {name="src", type=typename},
+         {name="value", type=scalar.type, check=scalar.check},
+         overload=SplitTensor.mul,
+         call =
+            function(dst, src, value)
+               dst = dst or src
+               THZSplitTensor_mul(dst, src, value)
+               return dst
+            end
+      }
+
+      SplitTensor.addcmul = argcheck{
+         nonamed=true,
+         {name="dst", type=typename, opt=true},
+         {name="src", type=typename},
+         {name="value", type=scalar.type, check=scalar.check, default=scalar.default},
+         {name="src1", type=typename},
+         {name="src2", type=typename},
+         overload=SplitTensor.addcmul,
+         call =
+            function(dst, src, value, src1, src2)
+               dst = dst or src
+               THZSplitTensor_addcmul(dst, src, value, src1, src2)
+               return dst
+            end
+      }
+   end
+
+   SplitTensor.zero = argcheck{
+      nonamed=true,
+      {name="dst", type=typename},
+      call =
+         function(dst)
+            THZSplitTensor_zero(dst)
+            return dst
+         end
+   }
+
+   SplitTensor.cmul = argcheck{
+      nonamed=true,
+      {name="dst", type=typename, opt=true},
+      {name="src1", type=typename},
+      {name="src2", type=typename},
+      call =
+         function(dst, src1, src2)
+            dst = dst or src1
+            THZSplitTensor_cmul(dst, src1, src2)
+            return dst
+         end
+   }
+
+   SplitTensor.conj = argcheck{
+      nonamed=true,
+      {name="dst", type=typename, opt=true},
+      {name="src", type=typename},
+      call =
+         function(dst, src)
+            dst = dst or src
+            THZSplitTensor_conj(dst, src)
+            return dst
+         end
+   }
+
+   SplitTensor.abs = argcheck{
+      nonamed=true,
+      {name="src", type=typename},
+      call =
+         function(src)
+            local dst = torch[Real .. 'Tensor']()
+            THZSplitTensor_abs(dst:cdata(), src)
+            return dst
+         end
+   }
+
+   SplitTensor.sum = argcheck{
+      nonamed=true,
+      {name="src", type=typename},
+      call =
+         function(src)
+            return THZSplitTensor_sumall(src)
+         end
+   }
+
+   function SplitTensor:__tostring()
+      return (tostring(self:interleaved()):gsub(ztypename, typename))
+   end
+
+   SplitTensor.__index = SplitTensor
+   SplitTensor.__version = 0
+   SplitTensor.__typename = typename
+   torch.metatype(typename, SplitTensor, THZSplitTensor .. '&')
+   ffi.metatype(THZSplitTensor, SplitTensor)
+
+   -- constructor metatable
+   local SplitTensor_ctr = {}
+   setmetatable(SplitTensor_ctr, {
+                   __call =
+                      function(self, ...)
+                         return SplitTensor.__new(...)
+                      end,
+                   __index = SplitTensor,
+                   __newindex = SplitTensor,
+                   __typename = typename,
+   })
+   torch['Z' .. Real .. 'SplitTensor'] = SplitTensor_ctr
+
+   -- ZTensor <-> SplitTensor conversions on the interleaved type
+   local ZTensor = torch.getmetatable(ztypename)
+   ZTensor.split = argcheck{
+      nonamed=true,
+      {name="src", type=ztypename},
+      call =
+         function(src)
+            return SplitTensor.__new(src)
+         end
+   }
+
+   ZTensor.copy = argcheck{
+      nonamed=true,
+      {name="dst", type=ztypename},
+      {name="src", type=typename},
+      overload=ZTensor.copy,
+      call =
+         function(dst, src)
+            THZTensor_copySplit(dst, src)
+            return dst
+         end
+   }
+end
@@ -24,6 +24,11 @@ for _,Real in ipairs{'Float', 'Double'} do
    local THZStorage_free = C[THZStorage .. '_free']
    local THZStorage_fill = C[THZStorage .. '_fill']
    local THZStorage_resize = C[THZStorage .. '_resize']
+   local THZStorage_isAligned = C[THZStorage .. '_isAligned']
+   local THZStorage_writeRaw = C[THZStorage .. '_writeRaw']
+   local THZStorage_readRaw = C[THZStorage .. '_readRaw']
+   local THZStorage_writeCompressed = C[THZStorage .. '_writeCompressed']
+   local THZStorage_readCompressed = C[THZStorage .. '_readCompressed']
    local THZStorage_copyZFloat = C[THZStorage .. '_copyZFloat']
    local THZStorage_copyZDouble = C[THZStorage .. '_copyZDouble']
    local THZStorage_copyByte = C[THZStorage .. '_copyByte']
@@ -50,11 +55,12 @@ for _,Real in ipairs{'Float', 'Double'} do
    ZStorage.__new = argcheck{
       {name="allocator", type="cdata"},
       {name="size", type="number", default=0},
+      {name="context", type="cdata", opt=true},
       overload = ZStorage.__new,
       nonamed = true,
       call =
-         function(allocator, size)
-            local self = THZStorage_newWithAllocator(size, allocator, nil)
+         function(allocator, size, context)
+            local self = THZStorage_newWithAllocator(size, allocator, context)
             ffi.gc(self, THZStorage_free)
             return self
          end
@@ -124,6 +130,14 @@ for _,Real in ipairs{'Float', 'Double'} do
          end
    }
 
+   ZStorage.isAligned = argcheck{
+      {name="self", type=typename},
+      call =
+         function(self)
+            return THZStorage_isAligned(self) == 1
+         end
+   }
+
    ZStorage.rawCopy = argcheck{
       {name="self", type=typename},
       {name="data", type="cdata"},
@@ -301,49 +315,40 @@ for _,Real in ipairs{'Float', 'Double'} do
          return ZStorage.__new()
       end
 
-   if Real == 'Float' then
-      function ZStorage:__write(file)
-         file:writeLong(self:size())
-         for i=1,self:size() do
-            local d = self[i]
-            file:writeFloat(d.re)
-            file:writeFloat(d.im)
-         end
-      end
-
-      function ZStorage:__read(file)
-         local size = file:readLong()
-         self:resize(size)
-         for i=1,self:size() do
-            local re,im
-            re = file:readFloat()
-            im = file:readFloat()
-            self[i] = ffi.new('complex', re, im)
-         end
-      end
-   else
-      function ZStorage:__write(file)
-         file:writeLong(self:size())
-         for i=1,self:size() do
-            local d = self[i]
-            file:writeDouble(d.re)
-            file:writeDouble(d.im)
-         end
+   -- the size, then either the real and imaginary parts of every element, as
+   -- THFile writes a [2*size] real storage, or their compressed blocks (see
+   -- ztorch.setCompression); version 0 has no payload kind
+   local RAW, COMPRESSED = 0, 1
+
+   function ZStorage:__write(file)
+      local mode, tolerance = ztorch.compression()
+      local thfile = ffi.cast('struct THFile__*', torch.pointer(file))
+      file:writeLong(self:size())
+      if mode == 'none' then
+         file:writeInt(RAW)
+         THZStorage_writeRaw(self, thfile)
+      else
+         file:writeInt(COMPRESSED)
+         THZStorage_writeCompressed(self, thfile, mode == 'lossy' and tolerance or -1)
       end
+   end
 
-      function ZStorage:__read(file)
-         local size = file:readLong()
-         self:resize(size)
-         for i=1,self:size() do
-            local re,im
-            re = file:readDouble()
-            im = file:readDouble()
-            self[i] = ffi.new('complex', re, im)
+   function ZStorage:__read(file, version)
+      local size = file:readLong()
+      local kind = (version or 0) > 0 and file:readInt() or RAW
+      local thfile = ffi.cast('struct THFile__*', torch.pointer(file))
+      self:resize(size)
+      if kind == COMPRESSED then
+         THZStorage_readCompressed(self, thfile)
+      else
+         local n = THZStorage_readRaw(self, thfile)
+         if n ~= size then
+            error(string.format('read error: read %d complex numbers instead of %d', tonumber(n), size))
          end
       end
    end
 
-   ZStorage.__version = 0
+   ZStorage.__version = 1
    torch.metatype(typename, ZStorage, THZStorage .. '&')
    ffi.metatype(THZStorage, ZStorage)
 
@@ -65,6 +65,13 @@ THZRealStorage& THZRealStorage_newWithDataAndAllocator(real* data, long size, TH
 void THZRealStorage_setFlag(THZRealStorage *storage, const char flag);
 void THZRealStorage_clearFlag(THZRealStorage *storage, const char flag);
 void THZRealStorage_retain(THZRealStorage *storage);
+int THZRealStorage_isAligned(const THZRealStorage *storage);
+void THZRealStorage_writeRaw(THZRealStorage *storage, struct THFile__ *file);
+long THZRealStorage_readRaw(THZRealStorage *storage, struct THFile__ *file);
+void THZRealStorage_writeCompressed(THZRealStorage *storage, struct THFile__ *file, double tolerance);
+void THZRealStorage_readCompressed(THZRealStorage *storage, struct THFile__ *file);
+struct THRealStorage *THZRealStorage_newScalarView(THZRealStorage *storage);
+THZRealStorage& THZRealStorage_newWithScalarStorage(struct THRealStorage *storage, long offset, long size);
 
 
 void THZRealStorage_free(THZRealStorage *storage);
@@ -155,6 +162,25 @@ void THZRealTensor_setStorage4d(THZRealTensor *self, THZRealStorage *storage_, l
                                     long size2_, long stride2_,
                                     long size3_, long stride3_);
 
+void THZRealTensor_writeMapped(THZRealTensor *self, const char *filename);
+THZRealTensor& THZRealTensor_newFromMappedFile(const char *filename, int shared);
+
+typedef struct THZRealTensorReader THZRealTensorReader;
+typedef struct THZRealTensorWriter THZRealTensorWriter;
+THZRealTensorReader *THZRealTensorReader_new(const char *filename);
+int THZRealTensorReader_nDimension(const THZRealTensorReader *self);
+long THZRealTensorReader_size(const THZRealTensorReader *self, int dim);
+long THZRealTensorReader_read(THZRealTensorReader *self, THZRealTensor *chunk, long nRows);
+void THZRealTensorReader_free(THZRealTensorReader *self);
+THZRealTensorWriter *THZRealTensorWriter_new(const char *filename, THLongStorage *size);
+void THZRealTensorWriter_write(THZRealTensorWriter *self, THZRealTensor *chunk);
+void THZRealTensorWriter_close(THZRealTensorWriter *self);
+void THZRealTensorWriter_free(THZRealTensorWriter *self);
+
+void THZRealTensor_reView(struct THRealTensor *r_, THZRealTensor *tensor);
+void THZRealTensor_imView(struct THRealTensor *r_, THZRealTensor *tensor);
+THZRealTensor& THZRealTensor_newViewOfReal(struct THRealTensor *src);
+
 void THZRealTensor_narrow(THZRealTensor *self, THZRealTensor *src, int dimension_, long firstIndex_, long size_);
 void THZRealTensor_select(THZRealTensor *self, THZRealTensor *src, int dimension_, long sliceIndex_);
 void THZRealTensor_transpose(THZRealTensor *self, THZRealTensor *src, int dimension1_, int dimension2_);
@@ -164,6 +190,7 @@ void THZRealTensor_squeeze(THZRealTensor *self, THZRealTensor *src);
 void THZRealTensor_squeeze1d(THZRealTensor *self, THZRealTensor *src, int dimension_);
 
 int THZRealTensor_isContiguous(const THZRealTensor *self);
+int THZRealTensor_isAligned(const THZRealTensor *self);
 int THZRealTensor_isSameSizeAs(const THZRealTensor *self, const THZRealTensor *src);
 long THZRealTensor_nElement(const THZRealTensor *self);
 
@@ -215,13 +242,26 @@ void THZRealTensor_div(THZRealTensor *r_, THZRealTensor *t, real value);
 
 void THZRealTensor_cadd(THZRealTensor *r_, THZRealTensor *t, real value, THZRealTensor *src);
 void THZRealTensor_cmul(THZRealTensor *r_, THZRealTensor *t, THZRealTensor *src);
+void THZRealTensor_cmulconj(THZRealTensor *r_, THZRealTensor *t, THZRealTensor *src);
 void THZRealTensor_cdiv(THZRealTensor *r_, THZRealTensor *t, THZRealTensor *src);
 
 void THZRealTensor_addcmul(THZRealTensor *r_, THZRealTensor *t, real value, THZRealTensor *src1, THZRealTensor *src2);
+void THZRealTensor_addcmulconj(THZRealTensor *r_, THZRealTensor *t, real value, THZRealTensor *src1, THZRealTensor *src2);
 void THZRealTensor_addcdiv(THZRealTensor *r_, THZRealTensor *t, real value, THZRealTensor *src1, THZRealTensor *src2);
 
+void THZRealTensor_evalExpr(THZRealTensor *r_, const int *code, int nInstructions, THZRealTensor **inputs, int nInputs, const real *constants, int nConstants);
+
 void THZRealTensor_addmv(THZRealTensor *r_, real beta, THZRealTensor *t, real alpha, THZRealTensor *mat, THZRealTensor *vec);
 void THZRealTensor_addmm(THZRealTensor *r_, real beta, THZRealTensor *t, real alpha, THZRealTensor *mat1, THZRealTensor *mat2);
+void THZRealTensor_addmm3m(THZRealTensor *r_, real beta, THZRealTensor *t, real alpha, THZRealTensor *mat1, THZRealTensor *mat2);
+void THZRealTensor_addmmBlocked(THZRealTensor *r_, real beta, THZRealTensor *t, real alpha, THZRealTensor *mat1, THZRealTensor *mat2);
+void THZRealTensor_baddbmm(THZRealTensor *result, real beta, THZRealTensor *t, real alpha, THZRealTensor *batch1, THZRealTensor *batch2);
+void THZRealTensor_addbmm(THZRealTensor *result, real beta, THZRealTensor *t, real alpha, THZRealTensor *batch1, THZRealTensor *batch2);
+void THZRealTensor_cmulMixed(THZRealTensor *r_, THZRealTensor *t, struct THRealTensor *src);
+void THZRealTensor_addmvMixedMat(THZRealTensor *r_, real beta, THZRealTensor *t, real alpha, struct THRealTensor *mat, THZRealTensor *vec);
+void THZRealTensor_addmvMixedVec(THZRealTensor *r_, real beta, THZRealTensor *t, real alpha, THZRealTensor *mat, struct THRealTensor *vec);
+void THZRealTensor_addmmMixedLeft(THZRealTensor *r_, real beta, THZRealTensor *t, real alpha, struct THRealTensor *mat1, THZRealTensor *mat2);
+void THZRealTensor_addmmMixedRight(THZRealTensor *r_, real beta, THZRealTensor *t, real alpha, THZRealTensor *mat1, struct THRealTensor *mat2);
 void THZRealTensor_addr(THZRealTensor *r_, real beta, THZRealTensor *t, real alpha, THZRealTensor *vec1, THZRealTensor *vec2);
 void THZRealTensor_addru(THZRealTensor *r_, real beta, THZRealTensor *t, real alpha, THZRealTensor *vec1, THZRealTensor *vec2);
 
@@ -304,6 +344,13 @@ void THZRealTensor_Double_arg(THDoubleTensor *r_, THZRealTensor *t);
 void THZRealTensor_Double_re(THDoubleTensor *r_, THZRealTensor *t);
 void THZRealTensor_Double_im(THDoubleTensor *r_, THZRealTensor *t);
 
+void THZRealTensor_polar(struct THRealTensor *mag, struct THRealTensor *phase, THZRealTensor *src);
+void THZRealTensor_fromPolar(THZRealTensor *r_, struct THRealTensor *mag, struct THRealTensor *phase);
+
+void THZRealTensor_abs2(struct THRealTensor *r_, THZRealTensor *t);
+void THZRealTensor_sumAbs2(struct THRealTensor *r_, THZRealTensor *t, int dimension);
+double THZRealTensor_sumAbs2all(THZRealTensor *t);
+
 void THZRealTensor_validXCorr2Dptr(real *r_,
                                     real alpha,
                                     real *t_, long ir, long ic,
@@ -386,6 +433,104 @@ void THZRealTensor_gesvd2(THZRealTensor *ru_, THZRealTensor *rs_, THZRealTensor
 void THZRealTensor_getri(THZRealTensor *ra_, THZRealTensor *a);
 void THZRealTensor_potri(THZRealTensor *ra_, THZRealTensor *a);
 void THZRealTensor_potrf(THZRealTensor *ra_, THZRealTensor *a);
+void THZRealTensor_fft(THZRealTensor *r_, THZRealTensor *t, int dimension);
+void THZRealTensor_ifft(THZRealTensor *r_, THZRealTensor *t, int dimension);
+void THZRealFFT_prewarm(long n, long stride, long batch, int sign);
+void THZRealFFT_clearCache(void);
+void THZRealFFT_setCacheCapacity(int capacity);
+int THZRealFFT_cacheCount(void);
+void THZRealTensor_uniform(THZRealTensor *self, double a, double b);
+void THZRealTensor_normal(THZRealTensor *self, double mean, double stdv);
+void THZRealTensor_complexNormal(THZRealTensor *self, real mean, double stdv);
+]])
+
+cdef([[
+typedef struct THZRealSplitTensor
+{
+    struct THRealTensor *__re;
+    struct THRealTensor *__im;
+    int __refcount;
+} THZRealSplitTensor;
+
+struct THRealTensor *THZRealSplitTensor_re(const THZRealSplitTensor *self);
+struct THRealTensor *THZRealSplitTensor_im(const THZRealSplitTensor *self);
+int THZRealSplitTensor_nDimension(const THZRealSplitTensor *self);
+long THZRealSplitTensor_size(const THZRealSplitTensor *self, int dim);
+struct THLongStorage *THZRealSplitTensor_newSizeOf(THZRealSplitTensor *self);
+long THZRealSplitTensor_nElement(const THZRealSplitTensor *self);
+int THZRealSplitTensor_isContiguous(const THZRealSplitTensor *self);
+int THZRealSplitTensor_isSameSizeAs(const THZRealSplitTensor *self, const THZRealSplitTensor *src);
+
+THZRealSplitTensor *THZRealSplitTensor_new(void);
+THZRealSplitTensor *THZRealSplitTensor_newWithSize(struct THLongStorage *size);
+THZRealSplitTensor *THZRealSplitTensor_newWithParts(struct THRealTensor *re, struct THRealTensor *im);
+THZRealSplitTensor *THZRealSplitTensor_newContiguous(THZRealSplitTensor *tensor);
+THZRealSplitTensor *THZRealSplitTensor_newNarrow(THZRealSplitTensor *tensor, int dimension_, long firstIndex_, long size_);
+THZRealSplitTensor *THZRealSplitTensor_newSelect(THZRealSplitTensor *tensor, int dimension_, long sliceIndex_);
+THZRealSplitTensor *THZRealSplitTensor_newTranspose(THZRealSplitTensor *tensor, int dimension1_, int dimension2_);
+
+void THZRealSplitTensor_resize(THZRealSplitTensor *self, struct THLongStorage *size);
+void THZRealSplitTensor_resizeAs(THZRealSplitTensor *self, THZRealSplitTensor *src);
+void THZRealSplitTensor_resizeAsZ(THZRealSplitTensor *self, THZRealTensor *src);
+
+void THZRealSplitTensor_narrow(THZRealSplitTensor *self, THZRealSplitTensor *src, int dimension_, long firstIndex_, long size_);
+void THZRealSplitTensor_select(THZRealSplitTensor *self, THZRealSplitTensor *src, int dimension_, long sliceIndex_);
+void THZRealSplitTensor_transpose(THZRealSplitTensor *self, THZRealSplitTensor *src, int dimension1_, int dimension2_);
+
+void THZRealSplitTensor_retain(THZRealSplitTensor *self);
+void THZRealSplitTensor_free(THZRealSplitTensor *self);
+
+void THZRealSplitTensor_copy(THZRealSplitTensor *self, THZRealSplitTensor *src);
+void THZRealSplitTensor_copyZ(THZRealSplitTensor *self, THZRealTensor *src);
+void THZRealTensor_copySplit(THZRealTensor *self, THZRealSplitTensor *src);
+
+void THZRealSplitTensor_fill(THZRealSplitTensor *r_, real value);
+void THZRealSplitTensor_zero(THZRealSplitTensor *r_);
+void THZRealSplitTensor_add(THZRealSplitTensor *r_, THZRealSplitTensor *t, real value);
+void THZRealSplitTensor_mul(THZRealSplitTensor *r_, THZRealSplitTensor *t, real value);
+void THZRealSplitTensor_cadd(THZRealSplitTensor *r_, THZRealSplitTensor *t, real value, THZRealSplitTensor *src);
+void THZRealSplitTensor_cmul(THZRealSplitTensor *r_, THZRealSplitTensor *t, THZRealSplitTensor *src);
+void THZRealSplitTensor_addcmul(THZRealSplitTensor *r_, THZRealSplitTensor *t, real value, THZRealSplitTensor *src1, THZRealSplitTensor *src2);
+void THZRealSplitTensor_conj(THZRealSplitTensor *r_, THZRealSplitTensor *t);
+void THZRealSplitTensor_abs(struct THRealTensor *r_, THZRealSplitTensor *t);
+accreal THZRealSplitTensor_sumall(THZRealSplitTensor *t);
+
+void THRealTensor_retain(struct THRealTensor *self);
+]])
+
+ffi.cdef([[
+int THZTensorFile_type(const char *filename);
+
+void THZRandom_manualSeed(uint64_t seed);
+uint64_t THZRandom_seed(void);
+uint64_t THZRandom_initialSeed(void);
+
+typedef struct THZCachingAllocatorStats
+{
+    long hits;
+    long misses;
+    long inUse;
+    long cached;
+    long highWater;
+} THZCachingAllocatorStats;
+
+void THZCachingAllocator_stats(THZCachingAllocatorStats *stats);
+void THZCachingAllocator_trim(void);
+void THZCachingAllocator_setLimit(long bytes);
+
+void THZAlignedAllocator_setHugePageThreshold(long bytes);
+long THZAlignedAllocator_hugePageThreshold(void);
+
+typedef struct THZNumaPolicy
+{
+    int mode;
+    unsigned long nodemask;
+} THZNumaPolicy;
+
+THAllocator THZNumaAllocator;
+
+void THZVector_setFastMath(int fast);
+int THZVector_fastMath(void);
 ]])
 
 local ok, C = pcall(ffi.load, 'torch_oss_THZ')
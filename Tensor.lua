@@ -18,10 +18,19 @@ for _,Real in ipairs{'Float', 'Double'} do
    local typename = 'torch.Z' .. Real .. 'Tensor'
    local Tensor = torch[Real .. 'Tensor']
    local THZTensor = 'THZ' .. Real .. 'Tensor'
+   local realTypename = 'torch.' .. Real .. 'Tensor'
    local THZTensor_Real_abs = C[THZTensor .. '_' .. Real .. '_abs']
    local THZTensor_Real_arg = C[THZTensor .. '_' .. Real .. '_arg']
    local THZTensor_Real_im = C[THZTensor .. '_' .. Real .. '_im']
    local THZTensor_Real_re = C[THZTensor .. '_' .. Real .. '_re']
+   local THZTensor_reView = C[THZTensor .. '_reView']
+   local THZTensor_imView = C[THZTensor .. '_imView']
+   local THZTensor_newViewOfReal = C[THZTensor .. '_newViewOf' .. Real]
+   local THZTensor_polar = C[THZTensor .. '_polar']
+   local THZTensor_fromPolar = C[THZTensor .. '_fromPolar']
+   local THZTensor_abs2 = C[THZTensor .. '_abs2']
+   local THZTensor_sumAbs2 = C[THZTensor .. '_sumAbs2']
+   local THZTensor_sumAbs2all = C[THZTensor .. '_sumAbs2all']
    local THZTensor_zabs = C[THZTensor .. '_zabs']
    local THZTensor_zarg = C[THZTensor .. '_zarg']
    local THZTensor_zim = C[THZTensor .. '_zim']
@@ -29,13 +38,18 @@ for _,Real in ipairs{'Float', 'Double'} do
    local THZTensor_add = C[THZTensor .. '_add']
    local THZTensor_addcdiv = C[THZTensor .. '_addcdiv']
    local THZTensor_addcmul = C[THZTensor .. '_addcmul']
+   local THZTensor_addcmulconj = C[THZTensor .. '_addcmulconj']
    local THZTensor_cadd = C[THZTensor .. '_cadd']
    local THZTensor_cat = C[THZTensor .. '_cat']
    local THZTensor_cdiv = C[THZTensor .. '_cdiv']
    local THZTensor_cmul = C[THZTensor .. '_cmul']
+   local THZTensor_cmulMixed = C[THZTensor .. '_cmulMixed']
+   local THZTensor_cmulconj = C[THZTensor .. '_cmulconj']
+   local THZTensor_complexNormal = C[THZTensor .. '_complexNormal']
    local THZTensor_conv2Dcmul = C[THZTensor .. '_conv2Dcmul']
    local THZTensor_conv2Dmul = C[THZTensor .. '_conv2Dmul']
    local THZTensor_conv2Dmv = C[THZTensor .. '_conv2Dmv']
+   local THZTensor_conv2Dmm = C[THZTensor .. '_conv2Dmm']
    local THZTensor_conv3Dcmul = C[THZTensor .. '_conv3Dcmul']
    local THZTensor_conv3Dmul = C[THZTensor .. '_conv3Dmul']
    local THZTensor_conv3Dmv = C[THZTensor .. '_conv3Dmv']
@@ -60,6 +74,8 @@ for _,Real in ipairs{'Float', 'Double'} do
    local THZTensor_gels = C[THZTensor .. '_gels']
    local THZTensor_gesv = C[THZTensor .. '_gesv']
    local THZTensor_gesvd = C[THZTensor .. '_gesvd']
+   local THZTensor_isAligned = C[THZTensor .. '_isAligned']
+   local THZTensor_writeMapped = C[THZTensor .. '_writeMapped']
    local THZTensor_isContiguous = C[THZTensor .. '_isContiguous']
    local THZTensor_max = C[THZTensor .. '_max']
    local THZTensor_maxall = C[THZTensor .. '_maxall']
@@ -81,6 +97,7 @@ for _,Real in ipairs{'Float', 'Double'} do
    local THZTensor_newWithStorage = C[THZTensor .. '_newWithStorage']
    local THZTensor_newWithTensor = C[THZTensor .. '_newWithTensor']
    local THZTensor_norm = C[THZTensor .. '_norm']
+   local THZTensor_normal = C[THZTensor .. '_normal']
    local THZTensor_normall = C[THZTensor .. '_normall']
    local THZTensor_pow = C[THZTensor .. '_pow']
    local THZTensor_prod = C[THZTensor .. '_prod']
@@ -103,9 +120,11 @@ for _,Real in ipairs{'Float', 'Double'} do
    local THZTensor_tril = C[THZTensor .. '_tril']
    local THZTensor_triu = C[THZTensor .. '_triu']
    local THZTensor_unfold = C[THZTensor .. '_unfold']
+   local THZTensor_uniform = C[THZTensor .. '_uniform']
    local THZTensor_var = C[THZTensor .. '_var']
    local THZTensor_varall = C[THZTensor .. '_varall']
    local THZTensor_zero = C[THZTensor .. '_zero']
+   local THZFFT_prewarm = C['THZ' .. Real .. 'FFT_prewarm']
    local THZStorage = 'THZ' .. Real .. 'Storage'
    local THZStorage_free = C[THZStorage .. '_free']
    local THZStorage_retain = C[THZStorage .. '_retain']
@@ -547,6 +566,27 @@ for _,Real in ipairs{'Float', 'Double'} do
       end
    }
 
+   -- views sharing storage with src, unlike re and im which copy
+   ZTensor.realView = argcheck{
+      nonamed=true,
+      {name="src", type=typename},
+      call = function(src)
+         local dst = Tensor.new()
+         THZTensor_reView(dst:cdata(), src)
+         return dst
+      end
+   }
+
+   ZTensor.imagView = argcheck{
+      nonamed=true,
+      {name="src", type=typename},
+      call = function(src)
+         local dst = Tensor.new()
+         THZTensor_imView(dst:cdata(), src)
+         return dst
+      end
+   }
+
    -- Add re and im functions to torch.FloatTensor and torch.DoubleTensor
    for _,BaseReal in ipairs{'Float', 'Double'} do
       local basename = 'torch.' .. BaseReal .. 'Tensor'
@@ -568,6 +608,19 @@ for _,Real in ipairs{'Float', 'Double'} do
       end
    end
 
+   -- complexView on the real tensor of the same precision: the inverse of
+   -- realView and imagView, [..., 2] pairs seen as complex numbers
+   rawset(torch.getmetatable('torch.' .. Real .. 'Tensor'), 'complexView', argcheck{
+      {name='src', type='torch.' .. Real .. 'Tensor'},
+      nonamed=true,
+      call =
+         function(src)
+            local self = THZTensor_newViewOfReal(src:cdata())
+            ffi.gc(self, THZTensor_free)
+            return self
+         end
+   })
+
    ZTensor.abs = argcheck{
       nonamed=true,
       {name="src", type=typename},
@@ -608,6 +661,73 @@ for _,Real in ipairs{'Float', 'Double'} do
       end
    }
 
+   -- magnitude and phase in one pass: mag, phase = x:polar()
+   ZTensor.polar = argcheck{
+      nonamed=true,
+      {name="src", type=typename},
+      call = function(src)
+         local mag, phase = Tensor.new(), Tensor.new()
+         THZTensor_polar(mag:cdata(), phase:cdata(), src)
+         return mag, phase
+      end
+   }
+   ZTensor.polar = argcheck{
+      nonamed=true,
+      {name="src", type=typename},
+      {name="mag", type=realTypename},
+      {name="phase", type=realTypename},
+      overload=ZTensor.polar,
+      call = function(src, mag, phase)
+         THZTensor_polar(mag:cdata(), phase:cdata(), src)
+         return mag, phase
+      end
+   }
+
+   -- |src|^2 elementwise, into a real tensor
+   ZTensor.abs2 = argcheck{
+      nonamed=true,
+      {name="src", type=typename},
+      {name="dst", type=realTypename, opt=true},
+      call = function(src, dst)
+         dst = dst or Tensor.new()
+         THZTensor_abs2(dst:cdata(), src)
+         return dst
+      end
+   }
+
+   -- the sum of |src|^2: over the whole tensor, or along dim into a real tensor
+   ZTensor.sumAbs2 = argcheck{
+      nonamed=true,
+      {name="src", type=typename},
+      call = function(src)
+         return THZTensor_sumAbs2all(src)
+      end
+   }
+   ZTensor.sumAbs2 = argcheck{
+      nonamed=true,
+      {name="src", type=typename},
+      {name="dim", type="number"},
+      {name="dst", type=realTypename, opt=true},
+      overload=ZTensor.sumAbs2,
+      call = function(src, dim, dst)
+         dst = dst or Tensor.new()
+         THZTensor_sumAbs2(dst:cdata(), src, dim-1)
+         return dst
+      end
+   }
+
+   -- dst = mag * exp(i * phase)
+   ZTensor.fromPolar = argcheck{
+      nonamed=true,
+      {name="dst", type=typename},
+      {name="mag", type=realTypename},
+      {name="phase", type=realTypename},
+      call = function(dst, mag, phase)
+         THZTensor_fromPolar(dst, mag:cdata(), phase:cdata())
+         return dst
+      end
+   }
+
    for _,name in ipairs{'log', 'exp', 'cos', 'acos', 'cosh', 'sin', 'asin',
                         'sinh', 'tan', 'atan', 'tanh', 'sqrt',
                         'conj', 'proj'} do
@@ -635,7 +755,7 @@ for _,Real in ipairs{'Float', 'Double'} do
       call =
          function(dst, src, value)
             dst = dst or src
-            THZTensor_pow(dst, src)
+            THZTensor_pow(dst, src, value)
             return dst
          end
    }
@@ -765,6 +885,15 @@ for _,Real in ipairs{'Float', 'Double'} do
          end
    }
 
+   ZTensor.isAligned = argcheck{
+      nonamed=true,
+      {name='self', type=typename},
+      call =
+         function(self)
+            return THZTensor_isAligned(self) == 1
+         end
+   }
+
    ZTensor.nElement = argcheck{
       nonamed=true,
       {name='self', type=typename},
@@ -964,6 +1093,34 @@ for _,Real in ipairs{'Float', 'Double'} do
          end
    }
 
+   ZTensor.cmul = argcheck{
+      nonamed=true,
+      {name="dst", type=typename, opt=true},
+      {name="src1", type=typename},
+      {name="src2", type=realTypename},
+      overload=ZTensor.cmul,
+      call =
+         function(dst, src1, src2)
+            dst = dst or src1
+            THZTensor_cmulMixed(dst, src1, src2:cdata())
+            return dst
+         end
+   }
+
+   -- dst = src1 * conj(src2)
+   ZTensor.cmulconj = argcheck{
+      nonamed=true,
+      {name="dst", type=typename, opt=true},
+      {name="src1", type=typename},
+      {name="src2", type=typename},
+      call =
+         function(dst, src1, src2)
+            dst = dst or src1
+            THZTensor_cmulconj(dst, src1, src2)
+            return dst
+         end
+   }
+
 
    ZTensor.div = argcheck{
       nonamed=true,
@@ -1019,6 +1176,22 @@ for _,Real in ipairs{'Float', 'Double'} do
          end
    }
 
+   -- dst = src + value * src1 * conj(src2)
+   ZTensor.addcmulconj = argcheck{
+      nonamed=true,
+      {name="dst", type=typename, opt=true},
+      {name="src", type=typename},
+      {name="value", type="number", default=1},
+      {name="src1", type=typename},
+      {name="src2", type=typename},
+      call =
+         function(dst, src, value, src1, src2)
+            dst = dst or src
+            THZTensor_addcmulconj(dst, src, value, src1, src2)
+            return dst
+         end
+   }
+
    ZTensor.addcdiv = argcheck{
       nonamed=true,
       {name="dst", type=typename, opt=true},
@@ -1220,29 +1393,37 @@ for _,Real in ipairs{'Float', 'Double'} do
    for _, f in ipairs{
       {name="mv", addname="addmv", arg1="mat", arg2="vec"},
       {name="mm", addname="addmm", arg1="mat", arg2="mat"},
+      {name="mm3m", addname="addmm3m", arg1="mat", arg2="mat"},
+      {addname="addmmBlocked", arg1="mat", arg2="mat"},
       {name="ger", addname="addr", arg1="vec1", arg2="vec2"},
-      {name="geru", addname="addru", arg1="vec1", arg2="vec2"}} do
+      {name="geru", addname="addru", arg1="vec1", arg2="vec2"},
+      {name="bmm", addname="baddbmm", arg1="batch1", arg2="batch2"},
+      {addname="addbmm", arg1="batch1", arg2="batch2"}} do
 
       local func = C[THZTensor .. "_" .. f.addname]
 
-      ZTensor[f.name] = argcheck{
-         nonamed=true,
-         {name=f.arg1, type=typename},
-         {name=f.arg2, type=typename},
-         call =
-            function(arg1, arg2)
-               local res
-               if f.name == 'mv' then
-                  res = ZTensor.new(arg1:size(1)):zero()
-               elseif f.name == 'mm' then
-                  res = ZTensor.new(arg1:size(1), arg2:size(2)):zero()
-               elseif f.name == 'ger' or f.name == 'geru' then
-                  res = ZTensor.new(arg1:size(1), arg2:size(1)):zero()
+      if f.name then
+         ZTensor[f.name] = argcheck{
+            nonamed=true,
+            {name=f.arg1, type=typename},
+            {name=f.arg2, type=typename},
+            call =
+               function(arg1, arg2)
+                  local res
+                  if f.name == 'mv' then
+                     res = ZTensor.new(arg1:size(1)):zero()
+                  elseif f.name == 'mm' or f.name == 'mm3m' then
+                     res = ZTensor.new(arg1:size(1), arg2:size(2)):zero()
+                  elseif f.name == 'ger' or f.name == 'geru' then
+                     res = ZTensor.new(arg1:size(1), arg2:size(1)):zero()
+                  elseif f.name == 'bmm' then
+                     res = ZTensor.new(arg1:size(1), arg1:size(2), arg2:size(3)):zero()
+                  end
+                  func(res, 0, res, 1, arg1, arg2)
+                  return res
                end
-               func(res, 0, res, 1, arg1, arg2)
-               return res
-            end
-      }
+         }
+      end
 
       ZTensor[f.addname] = argcheck{
          nonamed=true,
@@ -1275,6 +1456,72 @@ for _,Real in ipairs{'Float', 'Double'} do
       }
    end
 
+   -- products with a real operand, which is used as is instead of being
+   -- copied into a complex tensor
+   for _, f in ipairs{
+      {name="mv", addname="addmv", suffix="MixedMat", arg1=realTypename, arg2=typename},
+      {name="mv", addname="addmv", suffix="MixedVec", arg1=typename, arg2=realTypename},
+      {name="mm", addname="addmm", suffix="MixedLeft", arg1=realTypename, arg2=typename},
+      {name="mm", addname="addmm", suffix="MixedRight", arg1=typename, arg2=realTypename}} do
+
+      local func = C[THZTensor .. "_" .. f.addname .. f.suffix]
+      local realArg1 = (f.arg1 == realTypename)
+
+      local function call(dst, beta, src, alpha, arg1, arg2)
+         if realArg1 then
+            func(dst, beta, src, alpha, arg1:cdata(), arg2)
+         else
+            func(dst, beta, src, alpha, arg1, arg2:cdata())
+         end
+         return dst
+      end
+
+      ZTensor[f.name] = argcheck{
+         nonamed=true,
+         {name="arg1", type=f.arg1},
+         {name="arg2", type=f.arg2},
+         overload=ZTensor[f.name],
+         call =
+            function(arg1, arg2)
+               local res
+               if f.name == 'mv' then
+                  res = ZTensor.new(arg1:size(1)):zero()
+               else
+                  res = ZTensor.new(arg1:size(1), arg2:size(2)):zero()
+               end
+               return call(res, 0, res, 1, arg1, arg2)
+            end
+      }
+
+      ZTensor[f.addname] = argcheck{
+         nonamed=true,
+         {name="dst", type=typename, opt=true},
+         {name="beta", type='number', default=1},
+         {name="src", type=typename},
+         {name="alpha", type='number', default=1},
+         {name="arg1", type=f.arg1},
+         {name="arg2", type=f.arg2},
+         overload=ZTensor[f.addname],
+         call =
+            function(dst, beta, src, alpha, arg1, arg2)
+               return call(dst or src, beta, src, alpha, arg1, arg2)
+            end
+      }
+      ZTensor[f.addname] = argcheck{
+         nonamed=true,
+         {name="src", type=typename},
+         {name="beta", type='number'},
+         {name="alpha", type='number'},
+         {name="arg1", type=f.arg1},
+         {name="arg2", type=f.arg2},
+         overload=ZTensor[f.addname],
+         call =
+            function(src, beta, alpha, arg1, arg2)
+               return call(src, beta, src, alpha, arg1, arg2)
+            end
+      }
+   end
+
    ZTensor.conv2 = argcheck{
       nonamed=true,
       {name="dst", type=typename, opt=true},
@@ -1291,8 +1538,10 @@ for _,Real in ipairs{'Float', 'Double'} do
                THZTensor_conv2Dcmul(dst, 0, 1, src1, src2, 1, 1, opt, 'C')
             elseif src1.__nDimension == 3 and src2.__nDimension == 4 then
                THZTensor_conv2Dmv(dst, 0, 1, src1, src2, 1, 1, opt, 'C')
+            elseif src1.__nDimension == 4 and src2.__nDimension == 4 then
+               THZTensor_conv2Dmm(dst, 0, 1, src1, src2, 1, 1, opt, 'C')
             else
-               error('invalid source dimensions (expected: 2/2 or 3/3 or 3/4')
+               error('invalid source dimensions (expected: 2/2 or 3/3 or 3/4 or 4/4')
             end
             return dst
          end
@@ -1314,8 +1563,10 @@ for _,Real in ipairs{'Float', 'Double'} do
                THZTensor_conv2Dcmul(dst, 0, 1, src1, src2, 1, 1, opt, 'X')
             elseif src1.__nDimension == 3 and src2.__nDimension == 4 then
                THZTensor_conv2Dmv(dst, 0, 1, src1, src2, 1, 1, opt, 'X')
+            elseif src1.__nDimension == 4 and src2.__nDimension == 4 then
+               THZTensor_conv2Dmm(dst, 0, 1, src1, src2, 1, 1, opt, 'X')
             else
-               error('invalid source dimensions (expected: 2/2 or 3/3 or 3/4')
+               error('invalid source dimensions (expected: 2/2 or 3/3 or 3/4 or 4/4')
             end
             return dst
          end
@@ -1535,6 +1786,41 @@ for _,Real in ipairs{'Float', 'Double'} do
 
    end
 
+   -- transforms along dim (the last one by default), batched over the others
+   for _, name in ipairs{'fft', 'ifft'} do
+      local func = C[THZTensor .. '_' .. name]
+      ZTensor[name] = argcheck{
+         nonamed=true,
+         {name="dst", type=typename, opt=true},
+         {name="src", type=typename},
+         {name="dim", type="number", opt=true},
+         call =
+            function(dst, src, dim)
+               dst = dst or src
+               dim = dim or src:dim()
+               func(dst, src, dim-1)
+               return dst
+            end
+      }
+   end
+
+   -- builds and caches the plan fft/ifft will use on src along dim
+   ZTensor.prewarmFFT = argcheck{
+      nonamed=true,
+      {name="src", type=typename},
+      {name="dim", type="number", opt=true},
+      {name="inverse", type="boolean", default=false},
+      call =
+         function(src, dim, inverse)
+            dim = dim or src:dim()
+            local n = src:size(dim)
+            if n > 1 then
+               THZFFT_prewarm(n, src:stride(dim), src:nElement() / n, inverse and 1 or -1)
+            end
+            return src
+         end
+   }
+
    ZTensor.copy = argcheck{
       nonamed=true,
       name = "copy",
@@ -1650,6 +1936,18 @@ for _,Real in ipairs{'Float', 'Double'} do
          return ZTensor.__new()
       end
 
+   -- see ztorch.loadMapped
+   ZTensor.writeMapped = argcheck{
+      {name='self', type=typename},
+      {name='filename', type='string'},
+      nonamed=true,
+      call =
+         function(self, filename)
+            THZTensor_writeMapped(self, filename)
+            return self
+         end
+   }
+
    function ZTensor:__write(file)
       file:writeObject(self:size())
       file:writeObject(self:stride())
@@ -1793,6 +2091,15 @@ for _,Real in ipairs{'Float', 'Double'} do
          r:resizeAs(t1)
          r:zero()
          r:add(t2, t1)
+      elseif type_t1 == typename and type_t2 == realTypename then
+         if t1.__nDimension == 2 and t2:nDimension() == 1 then
+            return t1:mv(t2)
+         elseif t1.__nDimension == 2 and t2:nDimension() == 2 then
+            return t1:mm(t2)
+         else
+            error(string.format('multiplication between %dD and %dD tensors not yet supported',
+                                t1.__nDimension, t2:nDimension()))
+         end
       elseif type_t1 == typename and type_t2 == typename then
          if t1.__nDimension == 1 and t2.__nDimension == 1 then
             return t1:dot(t2)
@@ -1827,6 +2134,8 @@ for _,Real in ipairs{'Float', 'Double'} do
 
    ---------------------------------------------------------------------------------------
    -- RNG functions
+   -- normal, uniform and complexNormal draw from ztorch's own generator
+   -- (see ztorch.manualSeed), the others go through a real tensor
    ZTensor.normal = argcheck{
       nonamed=true,
       name = "normal",
@@ -1835,11 +2144,7 @@ for _,Real in ipairs{'Float', 'Double'} do
       {name="stdv", type='number', default=1},
       call =
          function(src, mean, stdv)
-            local size = src:size():totable()
-            size[#size+1] = 2
-            local size2 = torch.LongStorage(size)
-            local f = Tensor.new(size2):normal(mean, stdv)
-            src:copy(f)
+            THZTensor_normal(src, mean, stdv)
             return src
          end
    }
@@ -1848,15 +2153,37 @@ for _,Real in ipairs{'Float', 'Double'} do
       nonamed=true,
       name = "uniform",
       {name="src", type=typename},
+      {name="a", type='number', default=0},
+      {name="b", type='number', default=1},
+      call =
+         function(src, a, b)
+            THZTensor_uniform(src, a, b)
+            return src
+         end
+   }
+
+   ZTensor.complexNormal = argcheck{
+      nonamed=true,
+      name = "complexNormal",
+      {name="src", type=typename},
       {name="mean", type='number', default=0},
       {name="stdv", type='number', default=1},
       call =
          function(src, mean, stdv)
-            local size = src:size():totable()
-            size[#size+1] = 2
-            local size2 = torch.LongStorage(size)
-            local f = Tensor.new(size2):uniform(mean, stdv)
-            src:copy(f)
+            THZTensor_complexNormal(src, mean, stdv)
+            return src
+         end
+   }
+
+   ZTensor.complexNormal = argcheck{
+      nonamed=true,
+      {name="src", type=typename},
+      {name="mean", type="cdata", check=ztorch.isComplex},
+      {name="stdv", type='number', default=1},
+      overload=ZTensor.complexNormal,
+      call =
+         function(src, mean, stdv)
+            THZTensor_complexNormal(src, mean, stdv)
             return src
          end
    }
@@ -30,6 +30,8 @@ end
 
 require 'ztorch.Storage'
 require 'ztorch.Tensor'
+require 'ztorch.SplitTensor'
+require 'ztorch.Expr'
 
 ztorch.re = argcheck{
    {name='value', type='number'},
@@ -48,6 +50,224 @@ ztorch.im = argcheck{
       end
 }
 
+-- FFT plans are cached per precision, keyed by length, stride, batch and direction
+function ztorch.clearFFTCache()
+   C.THZFloatFFT_clearCache()
+   C.THZDoubleFFT_clearCache()
+end
+ztorch.setFFTCacheCapacity = argcheck{
+   {name='capacity', type='number'},
+   nonamed=true,
+   call =
+      function(capacity)
+         C.THZFloatFFT_setCacheCapacity(capacity)
+         C.THZDoubleFFT_setCacheCapacity(capacity)
+      end
+}
+-- returns the number of cached float and double plans
+function ztorch.fftCacheCount()
+   return C.THZFloatFFT_cacheCount(), C.THZDoubleFFT_cacheCount()
+end
+
+-- normal, uniform and complexNormal of complex tensors use a counter-based
+-- generator of their own, reproducible for a given seed whatever the number
+-- of threads
+ztorch.manualSeed = argcheck{
+   {name='seed', type='number'},
+   nonamed=true,
+   call =
+      function(seed)
+         C.THZRandom_manualSeed(seed)
+      end
+}
+function ztorch.seed()
+   return tonumber(C.THZRandom_seed())
+end
+function ztorch.initialSeed()
+   return tonumber(C.THZRandom_initialSeed())
+end
+
+-- statistics of the caching allocator used for internal temporaries
+function ztorch.allocatorStats()
+   local s = ffi.new('THZCachingAllocatorStats')
+   C.THZCachingAllocator_stats(s)
+   return {hits = tonumber(s.hits), misses = tonumber(s.misses),
+           inUse = tonumber(s.inUse), cached = tonumber(s.cached),
+           highWater = tonumber(s.highWater)}
+end
+function ztorch.trimAllocator()
+   C.THZCachingAllocator_trim()
+end
+ztorch.setAllocatorLimit = argcheck{
+   {name='bytes', type='number'},
+   nonamed=true,
+   call =
+      function(bytes)
+         C.THZCachingAllocator_setLimit(bytes)
+      end
+}
+
+-- storages of at least this many bytes ask for transparent huge pages (0: never)
+ztorch.setHugePageThreshold = argcheck{
+   {name='bytes', type='number'},
+   nonamed=true,
+   call =
+      function(bytes)
+         C.THZAlignedAllocator_setHugePageThreshold(bytes)
+      end
+}
+function ztorch.hugePageThreshold()
+   return tonumber(C.THZAlignedAllocator_hugePageThreshold())
+end
+
+-- fast math mode: exp, log, sqrt, pow, abs and arg of contiguous tensors use
+-- approximate vectorized kernels, within a few ulps except for pow with a
+-- large c or log z (lib/THZ/THZVector.h)
+ztorch.setFastMath = argcheck{
+   {name='fast', type='boolean'},
+   nonamed=true,
+   call =
+      function(fast)
+         C.THZVector_setFastMath(fast and 1 or 0)
+      end
+}
+function ztorch.fastMath()
+   return C.THZVector_fastMath() ~= 0
+end
+
+-- torch.save and writeObject write complex storages 'none' (as they are),
+-- 'lossless' (compressed) or 'lossy' (quantized to 16 bits where that moves
+-- no real or imaginary part by more than tolerance, compressed)
+local compressionModes = {none = true, lossless = true, lossy = true}
+local compression = {mode = 'none', tolerance = 0}
+ztorch.setCompression = argcheck{
+   {name='mode', type='string'},
+   {name='tolerance', type='number', default=0},
+   nonamed=true,
+   call =
+      function(mode, tolerance)
+         assert(compressionModes[mode], 'unknown compression mode ' .. mode)
+         assert(mode ~= 'lossy' or tolerance > 0, 'lossy compression needs a positive tolerance')
+         compression.mode, compression.tolerance = mode, tolerance
+      end
+}
+function ztorch.compression()
+   return compression.mode, compression.tolerance
+end
+
+-- huge page, NUMA placed storages:
+--   torch.ZFloatStorage(ztorch.numaAllocator, size, ztorch.numaPolicy('interleave'))
+-- policies are interned, so that they outlive the storages that use them
+ztorch.numaAllocator = C.THZNumaAllocator
+local numaModes = {['local'] = 0, interleave = 1, bind = 2}
+local numaPolicies = {}
+ztorch.numaPolicy = argcheck{
+   {name='mode', type='string', default='interleave'},
+   {name='nodes', type='table', default={}},
+   nonamed=true,
+   call =
+      function(mode, nodes)
+         assert(numaModes[mode], 'unknown NUMA mode ' .. mode)
+         local mask = 0ULL
+         for _, node in ipairs(nodes) do
+            mask = bit.bor(mask, bit.lshift(1ULL, node))
+         end
+         local key = mode .. ':' .. tostring(mask)
+         if not numaPolicies[key] then
+            numaPolicies[key] = ffi.new('THZNumaPolicy', numaModes[mode], mask)
+         end
+         return numaPolicies[key]
+      end
+}
+
+-- opens a file written by tensor:writeMapped without reading it: the pages
+-- of the tensor are read when touched, and with shared its writes go to the file
+ztorch.loadMapped = argcheck{
+   {name='filename', type='string'},
+   {name='shared', type='boolean', default=false},
+   nonamed=true,
+   call =
+      function(filename, shared)
+         local Real = ({'Float', 'Double'})[C.THZTensorFile_type(filename)]
+         assert(Real, filename .. ' is not a tensor file')
+         local self = C['THZ' .. Real .. 'Tensor_newFromMappedFile'](filename, shared and 1 or 0)
+         ffi.gc(self, C['THZ' .. Real .. 'Tensor_free'])
+         return self
+      end
+}
+
+-- iterates over a file written by tensor:writeMapped or ztorch.chunkWriter
+-- in chunks of rows along the first dimension, reading it in order:
+--   for chunk, first in ztorch.chunks('archive.zt', 4096) do ... end
+-- chunk is narrow(1, first, rows) of the tensor in the file (fewer rows at the
+-- end); the next chunk is fetched in the background while chunk is being
+-- processed. Two buffers take turns, so a chunk stays valid for one more step.
+ztorch.chunks = argcheck{
+   {name='filename', type='string'},
+   {name='rows', type='number'},
+   nonamed=true,
+   call =
+      function(filename, rows)
+         assert(rows > 0, 'the number of rows must be positive')
+         local Real = ({'Float', 'Double'})[C.THZTensorFile_type(filename)]
+         assert(Real, filename .. ' is not a tensor file')
+         local THZTensorReader = 'THZ' .. Real .. 'TensorReader'
+         local reader = ffi.gc(C[THZTensorReader .. '_new'](filename), C[THZTensorReader .. '_free'])
+         local read = C[THZTensorReader .. '_read']
+         local ZTensor = torch['Z' .. Real .. 'Tensor']
+         local buffers = {ZTensor(), ZTensor()}
+         local first, k = 1, 1
+         return function()
+            if not reader then
+               return nil
+            end
+            k = 3 - k
+            local n = tonumber(read(reader, buffers[k], rows))
+            if n == 0 then
+               -- close the file without waiting for the collector
+               C[THZTensorReader .. '_free'](ffi.gc(reader, nil))
+               reader = nil
+               return nil
+            end
+            first = first + n
+            return buffers[k], first - n
+         end
+      end
+}
+
+-- writes a tensor of the given size to a file, in chunks of rows along the
+-- first dimension:
+--   local writer = ztorch.chunkWriter('out.zt', 'torch.ZFloatTensor', torch.LongStorage{n, 513})
+--   writer:write(chunk) ... writer:close()
+-- close raises an error unless the chunks add up to the whole tensor
+for _, Real in ipairs{'Float', 'Double'} do
+   local THZTensorWriter = 'THZ' .. Real .. 'TensorWriter'
+   ffi.metatype(THZTensorWriter, {
+      __index = {
+         write = function(self, chunk)
+            C[THZTensorWriter .. '_write'](self, chunk)
+            return self
+         end,
+         close = function(self)
+            C[THZTensorWriter .. '_close'](self)
+         end
+      }
+   })
+end
+ztorch.chunkWriter = argcheck{
+   {name='filename', type='string'},
+   {name='typename', type='string'},
+   {name='size', type='torch.LongStorage'},
+   nonamed=true,
+   call =
+      function(filename, typename, size)
+         local Real = typename:match('^torch%.Z(%a+)Tensor$')
+         assert(Real == 'Float' or Real == 'Double', 'not a complex tensor type: ' .. typename)
+         local THZTensorWriter = 'THZ' .. Real .. 'TensorWriter'
+         return ffi.gc(C[THZTensorWriter .. '_new'](filename, size:cdata()), C[THZTensorWriter .. '_free'])
+      end
+}
+
 -- HACK: until we get torch.isTypeOf to work with complex tensors and storages
 function torch.isTensor(obj)
    local typename = torch.typename(obj)
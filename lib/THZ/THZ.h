@@ -9,6 +9,9 @@
 #endif
 
 #include "THZVector.h"
+#include "THZFFT.h"
+#include "THZRandom.h"
+#include "THZAllocator.h"
 #include "THZStorage.h"
 #include "THZTensor.h"
 
@@ -0,0 +1,625 @@
+#include "THZAllocator.h"
+
+#ifdef _WIN32
+#include <malloc.h>
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#define THZ_THREAD_LOCAL __declspec(thread)
+#else
+#define THZ_THREAD_LOCAL __thread
+#endif
+
+#ifdef _WIN32
+#define THZ_KEY_CALLBACK WINAPI
+#else
+#define THZ_KEY_CALLBACK
+#endif
+
+#ifdef HAVE_MMAP
+#include <sys/mman.h>
+#endif
+
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/syscall.h>
+#endif
+
+/* ---- aligned allocator ---- */
+
+static long THZAlignedAllocator_hugeThreshold = 0;
+
+static long THZAlignedAllocator_alignment(long size)
+{
+  if(THZAlignedAllocator_hugeThreshold > 0 && size >= THZAlignedAllocator_hugeThreshold)
+    return THZ_HUGE_PAGE_SIZE;
+  return THZ_ALIGNMENT;
+}
+
+static void THZAlignedAllocator_advise(void *ptr, long size)
+{
+#if defined(HAVE_MMAP) && defined(MADV_HUGEPAGE)
+  if(THZAlignedAllocator_alignment(size) == THZ_HUGE_PAGE_SIZE)
+    madvise(ptr, size, MADV_HUGEPAGE); /* only advice: failure is harmless */
+#endif
+}
+
+#if defined(_WIN32)
+
+static void *THZAlignedAllocator_raw(long size, long alignment)
+{
+  return _aligned_malloc(size, alignment);
+}
+
+static void *THZAlignedAllocator_rawRealloc(void *ptr, long size, long alignment)
+{
+  return _aligned_realloc(ptr, size, alignment);
+}
+
+static void THZAlignedAllocator_rawFree(void *ptr)
+{
+  _aligned_free(ptr);
+}
+
+#else
+
+/* posix_memalign blocks go back with free() and may be realloc'ed, the
+   result of which is only realigned when realloc moved it badly */
+static void *THZAlignedAllocator_raw(long size, long alignment)
+{
+  void *ptr;
+  if(posix_memalign(&ptr, alignment, size) != 0)
+    return NULL;
+  return ptr;
+}
+
+static void *THZAlignedAllocator_rawRealloc(void *ptr, long size, long alignment)
+{
+  void *moved = realloc(ptr, size);
+  void *aligned;
+
+  if(!moved || ((size_t)moved % alignment) == 0)
+    return moved;
+  aligned = THZAlignedAllocator_raw(size, alignment);
+  if(aligned)
+    memcpy(aligned, moved, size);
+  free(moved);
+  return aligned;
+}
+
+static void THZAlignedAllocator_rawFree(void *ptr)
+{
+  free(ptr);
+}
+
+#endif
+
+static void *THZAlignedAllocator_malloc(void *ctx, long size)
+{
+  void *ptr;
+
+  THArgCheck(size >= 0, 2, "invalid size %ld", size);
+  if(size == 0)
+    return NULL;
+
+  ptr = THZAlignedAllocator_raw(size, THZAlignedAllocator_alignment(size));
+  if(!ptr)
+    THError("$ Torch: not enough memory: you tried to allocate %ldGB. Buy new RAM!", size/1073741824);
+  THZAlignedAllocator_advise(ptr, size);
+  return ptr;
+}
+
+static void *THZAlignedAllocator_realloc(void *ctx, void *ptr, long size)
+{
+  void *newptr;
+
+  if(!ptr)
+    return THZAlignedAllocator_malloc(ctx, size);
+  if(size == 0)
+  {
+    THZAlignedAllocator_rawFree(ptr);
+    return NULL;
+  }
+  THArgCheck(size > 0, 3, "invalid size %ld", size);
+
+  newptr = THZAlignedAllocator_rawRealloc(ptr, size, THZAlignedAllocator_alignment(size));
+  if(!newptr)
+    THError("$ Torch: not enough memory: you tried to reallocate %ldGB. Buy new RAM!", size/1073741824);
+  THZAlignedAllocator_advise(newptr, size);
+  return newptr;
+}
+
+static void THZAlignedAllocator_free(void *ctx, void *ptr)
+{
+  THZAlignedAllocator_rawFree(ptr);
+}
+
+THAllocator THZAlignedAllocator = {
+  THZAlignedAllocator_malloc,
+  THZAlignedAllocator_realloc,
+  THZAlignedAllocator_free
+};
+
+void THZAlignedAllocator_setHugePageThreshold(long bytes)
+{
+  THArgCheck(bytes >= 0, 1, "the threshold must be non-negative");
+  THZAlignedAllocator_hugeThreshold = bytes;
+}
+
+long THZAlignedAllocator_hugePageThreshold(void)
+{
+  return THZAlignedAllocator_hugeThreshold;
+}
+
+/* ---- NUMA allocator ---- */
+
+#if defined(__linux__) && defined(HAVE_MMAP)
+
+/* values of linux/mempolicy.h, not always installed */
+#define THZ_MPOL_BIND 2
+#define THZ_MPOL_INTERLEAVE 3
+
+/* the mapping starts with a header holding its length, the data follows */
+#define THZ_NUMA_HEADER THZ_ALIGNMENT
+
+static void THZNumaAllocator_place(void *addr, long length, THZNumaPolicy *policy)
+{
+#if defined(SYS_mbind) && defined(SYS_getcpu)
+  THZNumaPolicy interleave = {THZ_NUMA_INTERLEAVE, 0};
+  unsigned long nodemask;
+  int mode;
+
+  if(!policy)
+    policy = &interleave;
+  if(policy->mode == THZ_NUMA_LOCAL)
+    return;
+
+  nodemask = policy->nodemask;
+  if(policy->mode == THZ_NUMA_BIND)
+  {
+    mode = THZ_MPOL_BIND;
+    if(nodemask == 0)
+    {
+      unsigned cpu, node;
+      if(syscall(SYS_getcpu, &cpu, &node, NULL) != 0)
+        return;
+      nodemask = 1UL << node;
+    }
+  }
+  else
+  {
+    mode = THZ_MPOL_INTERLEAVE;
+    if(nodemask == 0)
+      nodemask = ~0UL; /* the kernel keeps the nodes that have memory */
+  }
+  syscall(SYS_mbind, addr, length, mode, &nodemask, sizeof(nodemask)*8, 0);
+#endif
+}
+
+static void *THZNumaAllocator_malloc(void *ctx, long size)
+{
+  long length, slack;
+  char *map, *start;
+
+  THArgCheck(size >= 0, 2, "invalid size %ld", size);
+  if(size == 0)
+    return NULL;
+
+  /* map a huge page more than needed, to unmap what lies before the first
+     2MB boundary and after the end */
+  length = (THZ_NUMA_HEADER + size + THZ_HUGE_PAGE_SIZE - 1) & ~(THZ_HUGE_PAGE_SIZE - 1);
+  map = mmap(NULL, length + THZ_HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if(map == MAP_FAILED)
+    THError("$ Torch: not enough memory: you tried to allocate %ldGB. Buy new RAM!", size/1073741824);
+  start = (char*)(((size_t)map + THZ_HUGE_PAGE_SIZE - 1) & ~(size_t)(THZ_HUGE_PAGE_SIZE - 1));
+  slack = start - map;
+  if(slack > 0)
+    munmap(map, slack);
+  if(THZ_HUGE_PAGE_SIZE - slack > 0)
+    munmap(start + length, THZ_HUGE_PAGE_SIZE - slack);
+
+#ifdef MADV_HUGEPAGE
+  madvise(start, length, MADV_HUGEPAGE);
+#endif
+  THZNumaAllocator_place(start, length, ctx);
+
+  *(long*)start = length;
+  return start + THZ_NUMA_HEADER;
+}
+
+static void THZNumaAllocator_free(void *ctx, void *ptr)
+{
+  char *start;
+
+  if(!ptr)
+    return;
+  start = (char*)ptr - THZ_NUMA_HEADER;
+  munmap(start, *(long*)start);
+}
+
+static void *THZNumaAllocator_realloc(void *ctx, void *ptr, long size)
+{
+  void *data;
+  long old;
+
+  if(!ptr)
+    return THZNumaAllocator_malloc(ctx, size);
+  if(size == 0)
+  {
+    THZNumaAllocator_free(ctx, ptr);
+    return NULL;
+  }
+
+  old = *(long*)((char*)ptr - THZ_NUMA_HEADER) - THZ_NUMA_HEADER;
+  data = THZNumaAllocator_malloc(ctx, size);
+  memcpy(data, ptr, THMin(old, size));
+  THZNumaAllocator_free(ctx, ptr);
+  return data;
+}
+
+THAllocator THZNumaAllocator = {
+  THZNumaAllocator_malloc,
+  THZNumaAllocator_realloc,
+  THZNumaAllocator_free
+};
+
+#else
+
+THAllocator THZNumaAllocator = {
+  THZAlignedAllocator_malloc,
+  THZAlignedAllocator_realloc,
+  THZAlignedAllocator_free
+};
+
+#endif
+
+int THZAllocator_isAligned(THAllocator *allocator)
+{
+  return allocator == &THZAlignedAllocator || allocator == &THZCachingAllocator ||
+    allocator == &THZNumaAllocator;
+}
+
+/* ---- caching allocator ---- */
+
+#define THZ_CACHE_MIN_SHIFT 8
+#define THZ_CACHE_MAX_SHIFT 30
+#define THZ_CACHE_NCLASSES ((THZ_CACHE_MAX_SHIFT - THZ_CACHE_MIN_SHIFT)*4 + 1)
+#define THZ_CACHE_DEFAULT_LIMIT (1L << 30)
+
+/* every block starts with this header, padded to THZ_CACHE_HEADER bytes so
+   that the data keeps the alignment of THZAlignedAllocator */
+typedef struct THZCachedBlock
+{
+    long capacity;                 /* bytes after the header */
+    int sizeClass;                 /* -1 for blocks too large to cache */
+    struct THZCachedBlock *next;   /* free list link */
+} THZCachedBlock;
+
+#define THZ_CACHE_HEADER THZ_ALIGNMENT
+#define THZ_CACHE_DATA(block) ((void*)((char*)(block) + THZ_CACHE_HEADER))
+#define THZ_CACHE_BLOCK(ptr) ((THZCachedBlock*)((char*)(ptr) - THZ_CACHE_HEADER))
+
+/* hits, misses and inUse count what the owner thread did; inUse goes
+   negative in a thread that frees blocks allocated by another one */
+typedef struct THZThreadCache
+{
+    int lock;
+    THZCachedBlock *blocks[THZ_CACHE_NCLASSES];
+    long cached;
+    long hits;
+    long misses;
+    long inUse;
+    struct THZThreadCache *next;
+} THZThreadCache;
+
+static THZ_THREAD_LOCAL THZThreadCache *THZThreadCache_mine = NULL;
+
+/* the lock guards the list of thread caches and the counters of the caches
+   of exited threads; a thread cache is only touched by its owner, and by
+   stats() and trim() under its own lock, so that lock is not contended.
+   The footprint (inUse + cached) only changes when blocks come from or go
+   back to the system, and is kept with atomics. */
+static int THZCachingAllocator_lock = 0;
+static THZThreadCache *THZThreadCache_all = NULL;
+static THZThreadCache THZThreadCache_exited;
+static volatile long THZCachingAllocator_footprint = 0;
+static volatile long THZCachingAllocator_highWater = 0;
+static long THZCachingAllocator_limit = THZ_CACHE_DEFAULT_LIMIT;
+
+static void THZCachingAllocator_acquire(int *lock)
+{
+  while(!THAtomicCompareAndSwap(lock, 0, 1));
+}
+
+static void THZCachingAllocator_release(int *lock)
+{
+  THAtomicSet(lock, 0);
+}
+
+/* the class of a request of size bytes and the capacity of its blocks;
+   -1 (capacity = size) when too large to cache */
+static int THZCachingAllocator_sizeClass(long size, long *capacity)
+{
+  int shift = THZ_CACHE_MIN_SHIFT;
+  long base, quarter, k;
+
+  if(size <= (1L << THZ_CACHE_MIN_SHIFT))
+  {
+    *capacity = 1L << THZ_CACHE_MIN_SHIFT;
+    return 0;
+  }
+  if(size > (1L << THZ_CACHE_MAX_SHIFT))
+  {
+    *capacity = size;
+    return -1;
+  }
+  while((1L << (shift+1)) < size)
+    shift++;
+  base = 1L << shift;
+  quarter = base/4;
+  k = (size - base + quarter - 1)/quarter;
+  *capacity = base + k*quarter;
+  return (shift - THZ_CACHE_MIN_SHIFT)*4 + (int)k;
+}
+
+#ifdef _MSC_VER
+static long THZCachingAllocator_add(volatile long *a, long value)
+{
+  return _InterlockedExchangeAdd(a, value) + value;
+}
+
+static int THZCachingAllocator_swap(volatile long *a, long oldvalue, long newvalue)
+{
+  return _InterlockedCompareExchange(a, newvalue, oldvalue) == oldvalue;
+}
+#else
+static long THZCachingAllocator_add(volatile long *a, long value)
+{
+  return __sync_add_and_fetch(a, value);
+}
+
+static int THZCachingAllocator_swap(volatile long *a, long oldvalue, long newvalue)
+{
+  return __sync_bool_compare_and_swap(a, oldvalue, newvalue);
+}
+#endif
+
+/* bytes taken from (positive) or given back to the system */
+static void THZCachingAllocator_grow(long bytes)
+{
+  long footprint = THZCachingAllocator_add(&THZCachingAllocator_footprint, bytes);
+  long highWater = THZCachingAllocator_highWater;
+  while(footprint > highWater && !THZCachingAllocator_swap(&THZCachingAllocator_highWater, highWater, footprint))
+    highWater = THZCachingAllocator_highWater;
+}
+
+/* returns the cached blocks of cache to the system, and the number of bytes
+   freed; the caller holds the lock of cache, or has unlinked it */
+static long THZThreadCache_empty(THZThreadCache *cache)
+{
+  long freed = 0;
+  int i;
+
+  for(i = 0; i < THZ_CACHE_NCLASSES; i++)
+  {
+    while(cache->blocks[i])
+    {
+      THZCachedBlock *block = cache->blocks[i];
+      cache->blocks[i] = block->next;
+      freed += block->capacity;
+      THZAlignedAllocator_free(NULL, block);
+    }
+  }
+  cache->cached = 0;
+  return freed;
+}
+
+/* run at the exit of a thread that has a cache, by a thread-specific key:
+   the cache is emptied and unlinked, and its counters move to the exited
+   ones, so that threads that come and go do not hold on to their blocks */
+static void THZ_KEY_CALLBACK THZThreadCache_exit(void *ptr)
+{
+  THZThreadCache *cache = ptr;
+  THZThreadCache **link;
+  long freed;
+
+  if(!cache)
+    return;
+
+  THZCachingAllocator_acquire(&THZCachingAllocator_lock);
+  for(link = &THZThreadCache_all; *link != cache; link = &(*link)->next);
+  *link = cache->next;
+  THZThreadCache_exited.hits += cache->hits;
+  THZThreadCache_exited.misses += cache->misses;
+  THZThreadCache_exited.inUse += cache->inUse;
+  THZCachingAllocator_release(&THZCachingAllocator_lock);
+
+  freed = THZThreadCache_empty(cache);
+  THZCachingAllocator_grow(-freed);
+  THFree(cache);
+  /* a later destructor of this thread may still free a block: it gets a
+     new cache, which the key destructors are run again for */
+  THZThreadCache_mine = NULL;
+}
+
+#ifdef _WIN32
+static DWORD THZThreadCache_key = FLS_OUT_OF_INDEXES;
+#define THZThreadCache_hasKey() (THZThreadCache_key != FLS_OUT_OF_INDEXES)
+#define THZThreadCache_newKey() (THZThreadCache_key = FlsAlloc(THZThreadCache_exit))
+#define THZThreadCache_setKey(cache) FlsSetValue(THZThreadCache_key, cache)
+#else
+static pthread_key_t THZThreadCache_key;
+static int THZThreadCache_keyed = 0;
+#define THZThreadCache_hasKey() THZThreadCache_keyed
+#define THZThreadCache_newKey() (THZThreadCache_keyed = (pthread_key_create(&THZThreadCache_key, THZThreadCache_exit) == 0))
+#define THZThreadCache_setKey(cache) pthread_setspecific(THZThreadCache_key, cache)
+#endif
+
+static THZThreadCache *THZThreadCache_get(void)
+{
+  if(!THZThreadCache_mine)
+  {
+    THZThreadCache *cache = THAlloc(sizeof(THZThreadCache));
+    memset(cache, 0, sizeof(THZThreadCache));
+    THZCachingAllocator_acquire(&THZCachingAllocator_lock);
+    if(!THZThreadCache_hasKey())
+      THZThreadCache_newKey();
+    cache->next = THZThreadCache_all;
+    THZThreadCache_all = cache;
+    THZCachingAllocator_release(&THZCachingAllocator_lock);
+    if(THZThreadCache_hasKey())
+      THZThreadCache_setKey(cache);
+    THZThreadCache_mine = cache;
+  }
+  return THZThreadCache_mine;
+}
+
+static void *THZCachingAllocator_malloc(void *ctx, long size)
+{
+  THZCachedBlock *block = NULL;
+  THZThreadCache *cache;
+  long capacity;
+  int sizeClass;
+
+  if(size <= 0)
+    return NULL;
+
+  sizeClass = THZCachingAllocator_sizeClass(size, &capacity);
+  cache = THZThreadCache_get();
+  THZCachingAllocator_acquire(&cache->lock);
+  if(sizeClass >= 0)
+  {
+    block = cache->blocks[sizeClass];
+    if(block)
+    {
+      cache->blocks[sizeClass] = block->next;
+      cache->cached -= capacity;
+    }
+  }
+  if(block)
+    cache->hits++;
+  else
+    cache->misses++;
+  cache->inUse += capacity;
+  THZCachingAllocator_release(&cache->lock);
+
+  if(!block)
+  {
+    block = THZAlignedAllocator_malloc(NULL, THZ_CACHE_HEADER + capacity);
+    block->capacity = capacity;
+    block->sizeClass = sizeClass;
+    THZCachingAllocator_grow(capacity);
+  }
+  return THZ_CACHE_DATA(block);
+}
+
+static void THZCachingAllocator_free(void *ctx, void *ptr)
+{
+  THZCachedBlock *block;
+  THZThreadCache *cache;
+  long capacity;
+  int kept = 0;
+
+  if(!ptr)
+    return;
+
+  block = THZ_CACHE_BLOCK(ptr);
+  capacity = block->capacity;
+  cache = THZThreadCache_get();
+  THZCachingAllocator_acquire(&cache->lock);
+  if(block->sizeClass >= 0 && cache->cached + capacity <= THZCachingAllocator_limit)
+  {
+    block->next = cache->blocks[block->sizeClass];
+    cache->blocks[block->sizeClass] = block;
+    cache->cached += capacity;
+    kept = 1;
+  }
+  cache->inUse -= capacity;
+  THZCachingAllocator_release(&cache->lock);
+
+  if(!kept)
+  {
+    THZAlignedAllocator_free(NULL, block);
+    THZCachingAllocator_grow(-capacity);
+  }
+}
+
+static void *THZCachingAllocator_realloc(void *ctx, void *ptr, long size)
+{
+  THZCachedBlock *block;
+  long capacity;
+  int sizeClass;
+  void *data;
+
+  if(!ptr)
+    return THZCachingAllocator_malloc(ctx, size);
+  if(size <= 0)
+  {
+    THZCachingAllocator_free(ctx, ptr);
+    return NULL;
+  }
+
+  block = THZ_CACHE_BLOCK(ptr);
+  sizeClass = THZCachingAllocator_sizeClass(size, &capacity);
+  if(sizeClass >= 0 && sizeClass == block->sizeClass)
+    return ptr;
+
+  data = THZCachingAllocator_malloc(ctx, size);
+  memcpy(data, ptr, THMin(size, block->capacity));
+  THZCachingAllocator_free(ctx, ptr);
+  return data;
+}
+
+THAllocator THZCachingAllocator = {
+  THZCachingAllocator_malloc,
+  THZCachingAllocator_realloc,
+  THZCachingAllocator_free
+};
+
+void THZCachingAllocator_stats(THZCachingAllocatorStats *stats)
+{
+  THZThreadCache *cache;
+
+  memset(stats, 0, sizeof(THZCachingAllocatorStats));
+  THZCachingAllocator_acquire(&THZCachingAllocator_lock);
+  stats->hits = THZThreadCache_exited.hits;
+  stats->misses = THZThreadCache_exited.misses;
+  stats->inUse = THZThreadCache_exited.inUse;
+  for(cache = THZThreadCache_all; cache; cache = cache->next)
+  {
+    THZCachingAllocator_acquire(&cache->lock);
+    stats->hits += cache->hits;
+    stats->misses += cache->misses;
+    stats->inUse += cache->inUse;
+    stats->cached += cache->cached;
+    THZCachingAllocator_release(&cache->lock);
+  }
+  THZCachingAllocator_release(&THZCachingAllocator_lock);
+  stats->highWater = THZCachingAllocator_highWater;
+}
+
+void THZCachingAllocator_trim(void)
+{
+  THZThreadCache *cache;
+  long freed = 0;
+
+  THZCachingAllocator_acquire(&THZCachingAllocator_lock);
+  for(cache = THZThreadCache_all; cache; cache = cache->next)
+  {
+    THZCachingAllocator_acquire(&cache->lock);
+    freed += THZThreadCache_empty(cache);
+    THZCachingAllocator_release(&cache->lock);
+  }
+  THZCachingAllocator_release(&THZCachingAllocator_lock);
+  THZCachingAllocator_grow(-freed);
+}
+
+void THZCachingAllocator_setLimit(long bytes)
+{
+  THArgCheck(bytes >= 0, 1, "the limit must be non-negative");
+  THZCachingAllocator_limit = bytes;
+}
@@ -0,0 +1,88 @@
+#ifndef THZ_ALLOCATOR_INC
+#define THZ_ALLOCATOR_INC
+
+#include "THZGeneral.h"
+#include "THAllocator.h"
+
+/* The blocks of THZAlignedAllocator and THZCachingAllocator start on a
+   multiple of THZ_ALIGNMENT bytes: a cache line, and a full AVX-512
+   register. */
+#define THZ_ALIGNMENT 64
+#define THZ_HUGE_PAGE_SIZE (2L << 20)
+
+/* The default allocator of THZStorage. Blocks of at least the huge page
+   threshold are aligned on THZ_HUGE_PAGE_SIZE instead, and advised to be
+   backed by transparent huge pages where the system supports it. */
+THZ_API THAllocator THZAlignedAllocator;
+
+/* 0 (the default) never asks for huge pages */
+THZ_API void THZAlignedAllocator_setHugePageThreshold(long bytes);
+THZ_API long THZAlignedAllocator_hugePageThreshold(void);
+
+/* whether every block of allocator is THZ_ALIGNMENT-aligned */
+THZ_API int THZAllocator_isAligned(THAllocator *allocator);
+
+/* An allocator for large storages on NUMA machines. Its blocks are mapped
+   directly from the system, 2MB-aligned and advised MADV_HUGEPAGE, and get
+   the page placement policy of the THZNumaPolicy passed as allocator
+   context (NULL: interleave over all nodes):
+
+   THZ_NUMA_LOCAL       pages land on the node of the thread that first
+                        touches them; THZStorage_(fill) and THZTensor_(fill)
+                        touch in parallel with an explicit static schedule,
+                        which splits the blocks among threads as the
+                        elementwise loops do under the default schedule of
+                        libgomp and the LLVM runtime, so zero() after
+                        allocating puts each page next to the thread that
+                        will work on it
+   THZ_NUMA_INTERLEAVE  pages go round-robin over the nodes of nodemask
+                        (0: all nodes)
+   THZ_NUMA_BIND        pages are restricted to the nodes of nodemask
+                        (0: the node of the allocating thread)
+
+   The policy is read when a block is (re)allocated, and placement failures
+   only cost speed: without NUMA support in the kernel, or off Linux, the
+   blocks come from THZAlignedAllocator. */
+#define THZ_NUMA_LOCAL      0
+#define THZ_NUMA_INTERLEAVE 1
+#define THZ_NUMA_BIND       2
+
+typedef struct THZNumaPolicy
+{
+    int mode;
+    unsigned long nodemask;  /* bit i for node i */
+} THZNumaPolicy;
+
+THZ_API THAllocator THZNumaAllocator;
+
+/* A caching THAllocator for scratch buffers.
+
+   Requests are rounded up to a size class (four per power of two, from
+   256 bytes to 1 GB; larger blocks are neither rounded nor cached). Freed
+   blocks go to a cache owned by the freeing thread, up to a per-thread
+   limit, and later requests of the same class on that thread take them
+   back without going to malloc. A thread's cache goes back to the system
+   when the thread exits. THZTensor_(newScratch*) build tensors on
+   it, and the internal temporaries of the maths, convolution and lapack
+   routines use those. */
+THZ_API THAllocator THZCachingAllocator;
+
+typedef struct THZCachingAllocatorStats
+{
+    long hits;       /* allocations served from a cache */
+    long misses;     /* allocations that went to malloc */
+    long inUse;      /* bytes handed out and not freed yet */
+    long cached;     /* bytes held in the caches */
+    long highWater;  /* largest inUse + cached seen */
+} THZCachingAllocatorStats;
+
+THZ_API void THZCachingAllocator_stats(THZCachingAllocatorStats *stats);
+
+/* returns the cached blocks of every thread to the system */
+THZ_API void THZCachingAllocator_trim(void);
+
+/* bytes each thread may keep cached (default 1 GB), until trim() or the
+   exit of the thread; 0 disables caching */
+THZ_API void THZCachingAllocator_setLimit(long bytes);
+
+#endif
@@ -1,4 +1,18 @@
 #include "THZBlas.h"
+#include "THZVector.h"
+#include "THZAllocator.h"
+
+/* Blocking of the portable gemm. A kc x nc panel of op(b) is packed once per
+   outer step and stays in L3, each mc x kc block of op(a) in L2, and the
+   micro-kernel streams MR x kc and kc x NR slivers of both through L1. */
+#define THZ_GEMM_KC 256
+#define THZ_GEMM_MC 96
+#define THZ_GEMM_NC 3072
+
+/* products up to this many multiply-adds keep the plain loops, larger ones
+   than THZ_GEMM_OMP_THRESHOLD use several threads */
+#define THZ_GEMM_SMALL 4096
+#define THZ_GEMM_OMP_THRESHOLD 65536
 
 #include "generic/THZBlas.c"
 #include "THZGenerateAllTypes.h"
@@ -5,6 +5,9 @@
 
 #define THZBlas_(NAME) TH_CONCAT_4(THZ,Real,Blas_,NAME)
 
+/* TH's BLAS for the real type matching a complex type */
+#define THRealBlas_(NAME) TH_CONCAT_4(TH,Real,Blas_,NAME)
+
 #include "generic/THZBlas.h"
 #include "THZGenerateAllTypes.h"
 
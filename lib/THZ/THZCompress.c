@@ -0,0 +1,198 @@
+#include "THZCompress.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#define THZ_LZ_HASH_LOG 14
+#define THZ_LZ_MIN_MATCH 4
+#define THZ_LZ_MAX_OFFSET 65535
+
+/* as in LZ4, the code ends with at least THZ_LZ_LAST_LITERALS literals and
+   no match starts in the last THZ_LZ_MF_LIMIT bytes */
+#define THZ_LZ_LAST_LITERALS 5
+#define THZ_LZ_MF_LIMIT 12
+
+/* after 2^THZ_LZ_SKIP_LOG misses in a row the search steps over 2 bytes,
+   then 3..., so that incompressible blocks go by quickly */
+#define THZ_LZ_SKIP_LOG 6
+
+void THZCompress_shuffle(const unsigned char *src, size_t n, size_t width, unsigned char *dst)
+{
+  size_t i, j;
+
+  for(j = 0; j < width; j++)
+    for(i = 0; i < n; i++)
+      dst[j*n+i] = src[i*width+j];
+}
+
+void THZCompress_unshuffle(const unsigned char *src, size_t n, size_t width, unsigned char *dst)
+{
+  size_t i, j;
+
+  for(j = 0; j < width; j++)
+    for(i = 0; i < n; i++)
+      dst[i*width+j] = src[j*n+i];
+}
+
+static THZ_INLINE uint32_t THZCompress_read32(const unsigned char *p)
+{
+  uint32_t v;
+  memcpy(&v, p, 4);
+  return v;
+}
+
+static THZ_INLINE uint32_t THZCompress_hash(uint32_t v)
+{
+  return (v*2654435761u) >> (32-THZ_LZ_HASH_LOG);
+}
+
+/* the part of a length that does not fit in its nibble: bytes of 255, then
+   the rest */
+static unsigned char *THZCompress_putLength(unsigned char *op, size_t len)
+{
+  while(len >= 255)
+  {
+    *op++ = 255;
+    len -= 255;
+  }
+  *op++ = (unsigned char)len;
+  return op;
+}
+
+/* appends nlit literals and, if mlen > 0, a match; NULL if oend is hit */
+static unsigned char *THZCompress_putSequence(unsigned char *op, unsigned char *oend,
+                                              const unsigned char *literals, size_t nlit,
+                                              size_t offset, size_t mlen)
+{
+  unsigned char *token = op;
+
+  if((size_t)(oend - op) < 1 + nlit/255 + 1 + nlit + 2 + mlen/255 + 1)
+    return NULL;
+
+  op++;
+  if(nlit >= 15)
+  {
+    *token = 15 << 4;
+    op = THZCompress_putLength(op, nlit-15);
+  }
+  else
+    *token = (unsigned char)(nlit << 4);
+  memcpy(op, literals, nlit);
+  op += nlit;
+
+  if(mlen > 0)
+  {
+    *op++ = (unsigned char)(offset & 255);
+    *op++ = (unsigned char)(offset >> 8);
+    mlen -= THZ_LZ_MIN_MATCH;
+    if(mlen >= 15)
+    {
+      *token |= 15;
+      op = THZCompress_putLength(op, mlen-15);
+    }
+    else
+      *token |= (unsigned char)mlen;
+  }
+  return op;
+}
+
+size_t THZCompress_encode(const unsigned char *src, size_t n, unsigned char *dst, size_t capacity)
+{
+  uint32_t table[1 << THZ_LZ_HASH_LOG]; /* position+1 of the last 4 bytes with that hash */
+  unsigned char *op = dst, *oend = dst + capacity;
+  size_t i = 0, anchor = 0;
+
+  memset(table, 0, sizeof(table));
+  if(n >= THZ_LZ_MF_LIMIT)
+  {
+    const size_t limit = n - THZ_LZ_MF_LIMIT;
+    const size_t mend = n - THZ_LZ_LAST_LITERALS;
+
+    while(i <= limit)
+    {
+      uint32_t v = THZCompress_read32(src+i);
+      uint32_t h = THZCompress_hash(v);
+      size_t ref = table[h];
+
+      table[h] = (uint32_t)(i+1);
+      if(ref > 0 && i-(ref-1) <= THZ_LZ_MAX_OFFSET && THZCompress_read32(src+ref-1) == v)
+      {
+        size_t r = ref-1, len = THZ_LZ_MIN_MATCH;
+
+        while(i+len < mend && src[r+len] == src[i+len])
+          len++;
+        op = THZCompress_putSequence(op, oend, src+anchor, i-anchor, i-r, len);
+        if(!op)
+          return 0;
+        i += len;
+        anchor = i;
+      }
+      else
+        i += 1 + ((i-anchor) >> THZ_LZ_SKIP_LOG);
+    }
+  }
+
+  op = THZCompress_putSequence(op, oend, src+anchor, n-anchor, 0, 0);
+  return (op ? (size_t)(op-dst) : 0);
+}
+
+/* reads the continuation of a length into *len; -1 past the end */
+static THZ_INLINE int THZCompress_getLength(const unsigned char *src, size_t n, size_t *ip, size_t *len)
+{
+  unsigned char b;
+
+  do
+  {
+    if(*ip >= n)
+      return -1;
+    b = src[(*ip)++];
+    *len += b;
+  } while(b == 255);
+  return 0;
+}
+
+int THZCompress_decode(const unsigned char *src, size_t n, unsigned char *dst, size_t size)
+{
+  size_t ip = 0, op = 0;
+
+  for(;;)
+  {
+    size_t nlit, mlen, offset, k;
+    unsigned char token;
+
+    if(ip >= n)
+      return -1;
+    token = src[ip++];
+
+    nlit = token >> 4;
+    if(nlit == 15 && THZCompress_getLength(src, n, &ip, &nlit))
+      return -1;
+    if(nlit > n-ip || nlit > size-op)
+      return -1;
+    memcpy(dst+op, src+ip, nlit);
+    ip += nlit;
+    op += nlit;
+    if(ip == n)
+      break;
+
+    if(n-ip < 2)
+      return -1;
+    offset = src[ip] | ((size_t)src[ip+1] << 8);
+    ip += 2;
+    if(offset == 0 || offset > op)
+      return -1;
+
+    mlen = token & 15;
+    if(mlen == 15 && THZCompress_getLength(src, n, &ip, &mlen))
+      return -1;
+    mlen += THZ_LZ_MIN_MATCH;
+    if(mlen > size-op)
+      return -1;
+    /* byte by byte: the match may overlap the bytes it produces */
+    for(k = 0; k < mlen; k++)
+      dst[op+k] = dst[op-offset+k];
+    op += mlen;
+  }
+
+  return (op == size ? 0 : -1);
+}
@@ -0,0 +1,39 @@
+#ifndef THZ_COMPRESS_INC
+#define THZ_COMPRESS_INC
+
+#include "THZGeneral.h"
+
+/* Compressed storage payloads (THZStorage_(writeCompressed)).
+
+   The elements are cut into blocks of THZ_COMPRESS_BLOCK complex numbers,
+   compressed independently on the OpenMP threads, THZ_COMPRESS_GROUP
+   blocks at a time. A block is byte-shuffled (byte j of every scalar goes
+   to plane j, so that the sign and exponent bytes, which vary little
+   across a spectrum, end up next to each other) and then run through a
+   small LZ77 codec. Blocks that do not shrink are stored shuffled. */
+#define THZ_COMPRESS_BLOCK 16384
+#define THZ_COMPRESS_GROUP 64
+
+/* every block starts with: a byte of THZ_COMPRESS_* flags, 7 bytes of
+   padding and the quantization step, as a double */
+#define THZ_COMPRESS_HEADER 16
+#define THZ_COMPRESS_QUANTIZED 1
+#define THZ_COMPRESS_STORED 2
+
+/* Lossy blocks hold every real and imaginary part as round(x/step) in 16
+   bits, with step = max|x|/THZ_COMPRESS_QMAX over the block. */
+#define THZ_COMPRESS_QMAX 32767
+
+/* dst[j*n+i] = byte j of the i-th of the n elements of width bytes at src */
+THZ_API void THZCompress_shuffle(const unsigned char *src, size_t n, size_t width, unsigned char *dst);
+THZ_API void THZCompress_unshuffle(const unsigned char *src, size_t n, size_t width, unsigned char *dst);
+
+/* LZ77 with the sequence layout of LZ4: a token holding the literal and
+   match lengths, the literals, and a 16 bit offset back into the output.
+   encode returns the length of the code, or 0 if it does not fit in
+   capacity bytes. decode returns 0 if src decodes to exactly size bytes,
+   -1 if it is corrupt. */
+THZ_API size_t THZCompress_encode(const unsigned char *src, size_t n, unsigned char *dst, size_t capacity);
+THZ_API int THZCompress_decode(const unsigned char *src, size_t n, unsigned char *dst, size_t size);
+
+#endif
@@ -0,0 +1,12 @@
+#include "THZFFT.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#include "generic/THZFFT.c"
+#include "THZGenerateAllTypes.h"
@@ -0,0 +1,25 @@
+#ifndef THZ_FFT_INC
+#define THZ_FFT_INC
+
+#include "THZGeneral.h"
+
+#define THZFFT_(NAME)   TH_CONCAT_4(THZ,Real,FFT_,NAME)
+#define THZFFTPlan      TH_CONCAT_3(THZ,Real,FFTPlan)
+#define THZFFTCachedPlan TH_CONCAT_3(THZ,Real,FFTCachedPlan)
+
+/* prime factors up to this radix are handled by the mixed-radix
+   Stockham passes, larger ones switch the whole length to Bluestein */
+#define THZ_FFT_MAX_RADIX 13
+#define THZ_FFT_MAX_FACTORS 64
+
+/* batched tensor transforms go parallel over lines above this many elements */
+#define THZ_FFT_OMP_THRESHOLD 16384
+
+/* plan cache capacity (entries per precision): default and upper bound */
+#define THZ_FFT_CACHE_DEFAULT 16
+#define THZ_FFT_CACHE_MAX 256
+
+#include "generic/THZFFT.h"
+#include "THZGenerateAllTypes.h"
+
+#endif
@@ -0,0 +1,36 @@
+#include "THZRandom.h"
+
+#include <time.h>
+
+static uint64_t THZRandom_key = 5489;
+static uint64_t THZRandom_counter = 0;
+
+void THZRandom_manualSeed(uint64_t seed)
+{
+  THZRandom_key = seed;
+  THZRandom_counter = 0;
+}
+
+uint64_t THZRandom_seed(void)
+{
+  uint64_t s = (uint64_t)time(NULL) ^ ((uint64_t)clock() << 32);
+  THZRandom_manualSeed(s);
+  return s;
+}
+
+uint64_t THZRandom_initialSeed(void)
+{
+  return THZRandom_key;
+}
+
+uint64_t THZRandom_reserve(uint64_t nblocks, uint64_t *key)
+{
+  uint64_t first;
+#pragma omp critical(THZRandom)
+  {
+    first = THZRandom_counter;
+    THZRandom_counter += nblocks;
+    *key = THZRandom_key;
+  }
+  return first;
+}
@@ -0,0 +1,72 @@
+#ifndef THZ_RANDOM_INC
+#define THZ_RANDOM_INC
+
+#include "THZGeneral.h"
+#include <stdint.h>
+
+/* Counter-based random numbers (Philox4x32-10, Salmon et al., SC'11).
+
+   Block c of the stream of key k is philox(c, k): four independent 32 bit
+   words, computed from c and k alone. A tensor fill reserves as many
+   consecutive counters as it needs and derives element i from counter
+   first + i/per_block, so the numbers depend on the seed and on the order
+   of the fills only, never on how the elements are spread over threads. */
+
+/* tensor fills hand chunks of this many elements to the OpenMP threads,
+   going parallel above THZ_RANDOM_OMP_THRESHOLD elements */
+#define THZ_RANDOM_CHUNK 1024
+#define THZ_RANDOM_OMP_THRESHOLD 8192
+
+/* sets the key and rewinds the stream */
+THZ_API void THZRandom_manualSeed(uint64_t seed);
+
+/* seeds from the clock and returns the seed used */
+THZ_API uint64_t THZRandom_seed(void);
+
+/* the seed of the current stream */
+THZ_API uint64_t THZRandom_initialSeed(void);
+
+/* reserves nblocks consecutive counters, returning the first one; the key
+   of the stream is stored in *key */
+THZ_API uint64_t THZRandom_reserve(uint64_t nblocks, uint64_t *key);
+
+#define THZ_PHILOX_M0 0xD2511F53u
+#define THZ_PHILOX_M1 0xCD9E8D57u
+#define THZ_PHILOX_W0 0x9E3779B9u
+#define THZ_PHILOX_W1 0xBB67AE85u
+
+static THZ_INLINE void THZRandom_philox(uint64_t counter, uint64_t key, uint32_t out[4])
+{
+  uint32_t c0 = (uint32_t)counter, c1 = (uint32_t)(counter >> 32), c2 = 0, c3 = 0;
+  uint32_t k0 = (uint32_t)key, k1 = (uint32_t)(key >> 32);
+  int r;
+
+  for(r = 0; r < 10; r++)
+  {
+    uint64_t p0 = (uint64_t)THZ_PHILOX_M0 * c0;
+    uint64_t p1 = (uint64_t)THZ_PHILOX_M1 * c2;
+    c0 = (uint32_t)(p1 >> 32) ^ c1 ^ k0;
+    c1 = (uint32_t)p1;
+    c2 = (uint32_t)(p0 >> 32) ^ c3 ^ k1;
+    c3 = (uint32_t)p0;
+    k0 += THZ_PHILOX_W0;
+    k1 += THZ_PHILOX_W1;
+  }
+  out[0] = c0;
+  out[1] = c1;
+  out[2] = c2;
+  out[3] = c3;
+}
+
+/* uniform in [0, 1): 24 random bits for a float, 53 for a double */
+static THZ_INLINE float THZRandom_toFloat(uint32_t x)
+{
+  return (x >> 8) * (1.0f/16777216.0f);
+}
+
+static THZ_INLINE double THZRandom_toDouble(uint32_t hi, uint32_t lo)
+{
+  return ((hi >> 5) * 67108864.0 + (lo >> 6)) * (1.0/9007199254740992.0);
+}
+
+#endif
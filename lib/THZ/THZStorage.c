@@ -1,7 +1,14 @@
 #include "THZStorage.h"
+#include "THZCompress.h"
+#include "THZVector.h"
+
+#include <stdint.h>
 
 #include "generic/THZStorage.c"
 #include "THZGenerateAllTypes.h"
 
 #include "generic/THZStorageCopy.c"
 #include "THZGenerateAllTypes.h"
+
+#include "generic/THZStorageCompress.c"
+#include "THZGenerateAllTypes.h"
@@ -3,14 +3,24 @@
 
 #include "THZGeneral.h"
 #include "THAllocator.h"
+#include "THZAllocator.h"
 
 #define THZStorage        TH_CONCAT_3(THZ,Real,Storage)
 #define THZStorage_(NAME) TH_CONCAT_4(THZ,Real,Storage_,NAME)
 
+#define THRealStorage        TH_CONCAT_3(TH,Real,Storage)
+#define THRealStorage_(NAME) TH_CONCAT_4(TH,Real,Storage_,NAME)
+
+#define THFile_writeRealRaw TH_CONCAT_3(THFile_write,Real,Raw)
+#define THFile_readRealRaw  TH_CONCAT_3(THFile_read,Real,Raw)
+
 #include "generic/THZStorage.h"
 #include "THZGenerateAllTypes.h"
 
 #include "generic/THZStorageCopy.h"
 #include "THZGenerateAllTypes.h"
 
+#include "generic/THZStorageCompress.h"
+#include "THZGenerateAllTypes.h"
+
 #endif
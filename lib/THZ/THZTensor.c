@@ -1,8 +1,132 @@
 #include "THZGeneral.h"
 #include "THZTensor.h"
+#include "THZTensorApply.h"
 #include "THZVector.h"
 #include "THZBlas.h"
 #include "THZLapack.h"
+#include "THZFFT.h"
+#include "THZRandom.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#ifdef HAVE_POSIX_FADVISE
+#include <fcntl.h>
+#endif
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+/* the fixed part of the header of a mapped tensor file */
+typedef struct THZFileHeader
+{
+    char magic[8];
+    int32_t version;
+    int32_t type;
+    int32_t nDimension;
+    int32_t reserved;
+    int64_t offset;
+} THZFileHeader;
+
+#define THZ_FILE_MAGIC "THZTENSR"
+#define THZ_FILE_VERSION 1
+#define THZ_FILE_ALIGNMENT 64
+#define THZ_FILE_MAX_DIMS 1024
+
+/* reads and checks the fixed part of the header, 0 when not a tensor file */
+static int THZFileHeader_read(FILE *f, THZFileHeader *header)
+{
+  return fread(header, sizeof(THZFileHeader), 1, f) == 1 &&
+    memcmp(header->magic, THZ_FILE_MAGIC, 8) == 0 &&
+    header->version == THZ_FILE_VERSION &&
+    (header->type == THZ_FILE_ZFLOAT || header->type == THZ_FILE_ZDOUBLE) &&
+    header->nDimension >= 0 && header->nDimension <= THZ_FILE_MAX_DIMS &&
+    header->offset >= (int64_t)(sizeof(THZFileHeader) + 2*sizeof(int64_t)*header->nDimension) &&
+    header->offset % THZ_FILE_ALIGNMENT == 0;
+}
+
+/* reads the sizes and strides that follow the fixed part of the header */
+static int THZFileHeader_readShape(FILE *f, const THZFileHeader *header, long *size, long *stride)
+{
+  int64_t v;
+  int d;
+
+  for(d = 0; d < header->nDimension; d++)
+  {
+    if(fread(&v, sizeof(v), 1, f) != 1 || v < 0)
+      return 0;
+    size[d] = v;
+  }
+  for(d = 0; d < header->nDimension; d++)
+  {
+    if(fread(&v, sizeof(v), 1, f) != 1 || v < 0)
+      return 0;
+    stride[d] = v;
+  }
+  return 1;
+}
+
+/* writes the header of a contiguous tensor of the given sizes and the
+   padding up to the payload, returns 0 on a write error */
+static int THZFileHeader_write(FILE *f, int type, int nDimension, const long *size)
+{
+  THZFileHeader header;
+  int64_t *dims;
+  char zeros[THZ_FILE_ALIGNMENT];
+  long headerSize = sizeof(THZFileHeader) + 2*sizeof(int64_t)*nDimension;
+  long z;
+  int d, ok;
+
+  memcpy(header.magic, THZ_FILE_MAGIC, 8);
+  header.version = THZ_FILE_VERSION;
+  header.type = type;
+  header.nDimension = nDimension;
+  header.reserved = 0;
+  header.offset = (headerSize + THZ_FILE_ALIGNMENT - 1) / THZ_FILE_ALIGNMENT * THZ_FILE_ALIGNMENT;
+  ok = fwrite(&header, sizeof(header), 1, f) == 1;
+
+  /* sizes, then the strides of the contiguous payload */
+  dims = THAlloc(sizeof(int64_t)*(2*nDimension+1));
+  for(d = nDimension-1, z = 1; d >= 0; d--)
+  {
+    dims[d] = size[d];
+    dims[nDimension+d] = z;
+    z *= size[d];
+  }
+  ok = ok && fwrite(dims, sizeof(int64_t), 2*nDimension, f) == (size_t)(2*nDimension);
+  THFree(dims);
+
+  memset(zeros, 0, sizeof(zeros));
+  ok = ok && fwrite(zeros, 1, header.offset - headerSize, f) == (size_t)(header.offset - headerSize);
+  return ok;
+}
+
+/* Access pattern hints for streamed tensor files: the next chunk is read
+   ahead by the kernel while the current one is being processed, and the
+   pages of chunks already consumed are dropped from the page cache. */
+static void THZTensorFile_advise(FILE *f, long offset, long length, int willNeed)
+{
+#ifdef HAVE_POSIX_FADVISE
+  posix_fadvise(fileno(f), offset, length, willNeed ? POSIX_FADV_WILLNEED : POSIX_FADV_DONTNEED);
+#endif
+}
+
+int THZTensorFile_type(const char *filename)
+{
+  THZFileHeader header;
+  FILE *f = fopen(filename, "rb");
+  int type = 0;
+
+  if(f)
+  {
+    if(THZFileHeader_read(f, &header))
+      type = header.type;
+    fclose(f);
+  }
+  return type;
+}
 
 #include "generic/THZTensor.c"
 #include "THZGenerateAllTypes.h"
@@ -16,5 +140,20 @@
 #include "generic/THZTensorConv.c"
 #include "THZGenerateAllTypes.h"
 
+#include "generic/THZTensorFFT.c"
+#include "THZGenerateAllTypes.h"
+
+#include "generic/THZTensorFile.c"
+#include "THZGenerateAllTypes.h"
+
+#include "generic/THZTensorRandom.c"
+#include "THZGenerateAllTypes.h"
+
 #include "generic/THZTensorLapack.c"
 #include "THZGenerateAllTypes.h"
+
+#include "generic/THZSplitTensor.c"
+#include "THZGenerateAllTypes.h"
+
+#include "generic/THZTensorExpr.c"
+#include "THZGenerateAllTypes.h"
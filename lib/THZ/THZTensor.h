@@ -6,6 +6,68 @@
 #define THZTensor          TH_CONCAT_3(THZ,Real,Tensor)
 #define THZTensor_(NAME)   TH_CONCAT_4(THZ,Real,Tensor_,NAME)
 
+#define THZSplitTensor        TH_CONCAT_3(THZ,Real,SplitTensor)
+#define THZSplitTensor_(NAME) TH_CONCAT_4(THZ,Real,SplitTensor_,NAME)
+
+#define THZTensorReader        TH_CONCAT_3(THZ,Real,TensorReader)
+#define THZTensorReader_(NAME) TH_CONCAT_4(THZ,Real,TensorReader_,NAME)
+#define THZTensorWriter        TH_CONCAT_3(THZ,Real,TensorWriter)
+#define THZTensorWriter_(NAME) TH_CONCAT_4(THZ,Real,TensorWriter_,NAME)
+
+/* the real tensor type matching the scalar type of a complex type */
+#define THRealTensor        TH_CONCAT_3(TH,Real,Tensor)
+#define THRealTensor_(NAME) TH_CONCAT_4(TH,Real,Tensor_,NAME)
+
+/* Mapped tensor files, in native byte order:
+
+     char    magic[8]      "THZTENSR"
+     int32   version       1
+     int32   type          THZ_FILE_ZFLOAT or THZ_FILE_ZDOUBLE
+     int32   nDimension
+     int32   reserved      0
+     int64   offset        of the payload in bytes, a multiple of 64
+     int64   size[nDimension]
+     int64   stride[nDimension]   in elements
+     (zeros up to offset, then the payload) */
+#define THZ_FILE_ZFLOAT  1
+#define THZ_FILE_ZDOUBLE 2
+
+/* the type of the tensor in a mapped file, 0 when not such a file */
+THZ_API int THZTensorFile_type(const char *filename);
+
+/* Instructions of the fused elementwise programs run by
+   THZTensor_(evalExpr): four ints {op, dst, a, b} each, over
+   THZ_EXPR_REGISTERS registers holding a block of elements apiece. LOAD and
+   CONST set register dst to input tensor a and to constant a, the unary ops
+   set dst to op(a), the binary ones to a op b. MULCONJ is a*conj(b). */
+#define THZ_EXPR_REGISTERS 8
+#define THZ_EXPR_MAX_INPUTS 16
+
+#define THZ_EXPR_LOAD    0
+#define THZ_EXPR_CONST   1
+#define THZ_EXPR_ADD     2
+#define THZ_EXPR_SUB     3
+#define THZ_EXPR_MUL     4
+#define THZ_EXPR_DIV     5
+#define THZ_EXPR_MULCONJ 6
+#define THZ_EXPR_POW     7
+#define THZ_EXPR_NEG     8
+#define THZ_EXPR_CONJ    9
+#define THZ_EXPR_EXP     10
+#define THZ_EXPR_LOG     11
+#define THZ_EXPR_SQRT    12
+#define THZ_EXPR_COS     13
+#define THZ_EXPR_SIN     14
+#define THZ_EXPR_TAN     15
+#define THZ_EXPR_ACOS    16
+#define THZ_EXPR_ASIN    17
+#define THZ_EXPR_ATAN    18
+#define THZ_EXPR_COSH    19
+#define THZ_EXPR_SINH    20
+#define THZ_EXPR_TANH    21
+#define THZ_EXPR_PROJ    22
+#define THZ_EXPR_NOPS    23
+
 /* basics */
 #include "generic/THZTensor.h"
 #include "THZGenerateAllTypes.h"
@@ -21,8 +83,28 @@
 #include "generic/THZTensorConv.h"
 #include "THZGenerateAllTypes.h"
 
+/* fourier transforms */
+#include "generic/THZTensorFFT.h"
+#include "THZGenerateAllTypes.h"
+
+/* mapped files */
+#include "generic/THZTensorFile.h"
+#include "THZGenerateAllTypes.h"
+
+/* random fills */
+#include "generic/THZTensorRandom.h"
+#include "THZGenerateAllTypes.h"
+
 /* lapack support */
 #include "generic/THZTensorLapack.h"
 #include "THZGenerateAllTypes.h"
 
+/* planar (split real/imaginary) tensors */
+#include "generic/THZSplitTensor.h"
+#include "THZGenerateAllTypes.h"
+
+/* fused elementwise expressions */
+#include "generic/THZTensorExpr.h"
+#include "THZGenerateAllTypes.h"
+
 #endif
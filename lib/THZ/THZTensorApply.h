@@ -0,0 +1,230 @@
+#ifndef THZ_TENSOR_APPLY_INC
+#define THZ_TENSOR_APPLY_INC
+
+#include "THZGeneral.h"
+
+/* Parallel elementwise iteration over one to three tensors holding the same
+   number of elements (their shapes may differ, as with TH_TENSOR_APPLY).
+
+   Each tensor is first collapsed: dimensions of size 1 are dropped and a
+   dimension is merged into the next one when stride[d] == stride[d+1]*size[d+1],
+   so a contiguous tensor becomes a single run and a transposed matrix stays
+   two-dimensional. The linear index space is then cut into chunks of
+   THZ_APPLY_CHUNK elements shared among the OpenMP threads. A chunk seeks
+   every tensor to its first element and walks them run by run, a run ending
+   wherever one of the tensors reaches the end of its innermost dimension.
+
+   CODE sees TENSOR_data pointing to the current element of TENSOR, and
+   THZ_APPLY_INDEX, the linear index of that element. It runs once per
+   element, possibly on several threads at once, so it must neither break
+   out of the loop, nor raise an error, nor depend on the order of the
+   elements: reductions and mask compactions stay on TH_TENSOR_APPLY. */
+
+/* every collapsed dimension has at least two elements, so no tensor that
+   fits in memory comes near this */
+#define THZ_APPLY_MAX_DIMS 64
+
+#define THZ_APPLY_CHUNK 4096
+
+/* strided elements are dearer than contiguous ones, threads pay off sooner
+   than THZ_OMP_OVERHEAD_THZRESHOLD */
+#define THZ_APPLY_OMP_THRESHOLD 32768
+
+typedef struct THZApplyShape
+{
+    int dim;
+    long size[THZ_APPLY_MAX_DIMS];
+    long stride[THZ_APPLY_MAX_DIMS];
+} THZApplyShape;
+
+/* collapses the given shape into s, returns its number of elements */
+static THZ_INLINE long THZApplyShape_init(THZApplyShape *s, int nDimension, const long *size, const long *stride)
+{
+  long n = (nDimension > 0);
+  int d;
+
+  s->dim = 0;
+  for(d = 0; d < nDimension; d++)
+  {
+    n *= size[d];
+    if(size[d] == 1)
+      continue;
+    if(s->dim > 0 && s->stride[s->dim-1] == stride[d]*size[d])
+    {
+      s->size[s->dim-1] *= size[d];
+      s->stride[s->dim-1] = stride[d];
+    }
+    else
+    {
+      s->size[s->dim] = size[d];
+      s->stride[s->dim] = stride[d];
+      s->dim++;
+    }
+  }
+  if(s->dim == 0)
+  {
+    s->size[0] = 1;
+    s->stride[0] = 1;
+    s->dim = 1;
+  }
+  return n;
+}
+
+/* sets counter to the position of the element of linear index `index' and
+   returns its offset */
+static THZ_INLINE long THZApplyShape_seek(const THZApplyShape *s, long index, long *counter)
+{
+  long offset = 0;
+  int d;
+
+  for(d = s->dim-1; d >= 0; d--)
+  {
+    counter[d] = index % s->size[d];
+    index /= s->size[d];
+    offset += counter[d]*s->stride[d];
+  }
+  return offset;
+}
+
+/* called once the innermost counter has reached its size: moves counter to
+   the start of the next run and returns the offset to add to the pointer,
+   which stands one past the end of the run */
+static THZ_INLINE long THZApplyShape_carry(const THZApplyShape *s, long *counter)
+{
+  long offset = 0;
+  int d = s->dim-1;
+
+  while(d > 0 && counter[d] == s->size[d])
+  {
+    offset -= counter[d]*s->stride[d];
+    counter[d] = 0;
+    d--;
+    counter[d]++;
+    offset += s->stride[d];
+  }
+  return offset;
+}
+
+#define THZ_APPLY_INDEX (THZ_APPLY_i + THZ_APPLY_k)
+
+#define __THZ_APPLY_INIT(TYPE, TENSOR)                                  \
+  THZApplyShape TENSOR##_shape;                                         \
+  long TENSOR##_n = THZApplyShape_init(&TENSOR##_shape, TENSOR->nDimension, TENSOR->size, TENSOR->stride); \
+  TYPE *TENSOR##_base = (TENSOR##_n > 0 ? TENSOR->storage->data + TENSOR->storageOffset : NULL); \
+  const int TENSOR##_last = TENSOR##_shape.dim-1;                       \
+  const long TENSOR##_stride = TENSOR##_shape.stride[TENSOR##_last];
+
+#define __THZ_APPLY_SEEK(TYPE, TENSOR)                                  \
+  long TENSOR##_counter[THZ_APPLY_MAX_DIMS];                            \
+  TYPE *TENSOR##_data = TENSOR##_base + THZApplyShape_seek(&TENSOR##_shape, THZ_APPLY_i, TENSOR##_counter);
+
+#define __THZ_APPLY_RUN(TENSOR)                                         \
+  if(TENSOR##_shape.size[TENSOR##_last] - TENSOR##_counter[TENSOR##_last] < THZ_APPLY_len) \
+    THZ_APPLY_len = TENSOR##_shape.size[TENSOR##_last] - TENSOR##_counter[TENSOR##_last];
+
+#define __THZ_APPLY_ADVANCE(TENSOR)                                     \
+  TENSOR##_counter[TENSOR##_last] += THZ_APPLY_len;                     \
+  if(TENSOR##_counter[TENSOR##_last] == TENSOR##_shape.size[TENSOR##_last]) \
+    TENSOR##_data += THZApplyShape_carry(&TENSOR##_shape, TENSOR##_counter);
+
+/* the chunk loop; runs along which every tensor has unit stride get a loop
+   of their own so that the compiler can vectorize CODE there */
+#define __THZ_APPLY_LOOP(SEEK, RUN, UNIT, STEP_UNIT, STEP, ADVANCE, ...) \
+  {                                                                     \
+    long THZ_APPLY_chunk;                                               \
+    _Pragma("omp parallel for if(THZ_APPLY_n > THZ_APPLY_OMP_THRESHOLD) private(THZ_APPLY_chunk)") \
+    for(THZ_APPLY_chunk = 0; THZ_APPLY_chunk < (THZ_APPLY_n + THZ_APPLY_CHUNK - 1)/THZ_APPLY_CHUNK; THZ_APPLY_chunk++) \
+    {                                                                   \
+      long THZ_APPLY_i = THZ_APPLY_chunk*THZ_APPLY_CHUNK;               \
+      long THZ_APPLY_end = (THZ_APPLY_n - THZ_APPLY_i < THZ_APPLY_CHUNK ? THZ_APPLY_n : THZ_APPLY_i + THZ_APPLY_CHUNK); \
+      SEEK                                                              \
+      for(;;)                                                           \
+      {                                                                 \
+        long THZ_APPLY_len = THZ_APPLY_end - THZ_APPLY_i, THZ_APPLY_k;  \
+        RUN                                                             \
+        if(UNIT)                                                        \
+        {                                                               \
+          for(THZ_APPLY_k = 0; THZ_APPLY_k < THZ_APPLY_len; THZ_APPLY_k++) \
+          {                                                             \
+            __VA_ARGS__                                                 \
+            STEP_UNIT                                                   \
+          }                                                             \
+        }                                                               \
+        else                                                            \
+        {                                                               \
+          for(THZ_APPLY_k = 0; THZ_APPLY_k < THZ_APPLY_len; THZ_APPLY_k++) \
+          {                                                             \
+            __VA_ARGS__                                                 \
+            STEP                                                        \
+          }                                                             \
+        }                                                               \
+        THZ_APPLY_i += THZ_APPLY_len;                                   \
+        if(THZ_APPLY_i == THZ_APPLY_end)                                \
+          break;                                                        \
+        ADVANCE                                                         \
+      }                                                                 \
+    }                                                                   \
+  }
+
+#define __THZ_APPLY_CHECK(T1, T2)                                       \
+  if(T1##_n != T2##_n)                                                  \
+    THError("inconsistent tensor size: %ld elements against %ld", T1##_n, T2##_n);
+
+#define THZ_TENSOR_APPLY(TYPE, TENSOR, CODE)                            \
+  {                                                                     \
+    __THZ_APPLY_INIT(TYPE, TENSOR)                                      \
+    const long THZ_APPLY_n = TENSOR##_n;                                \
+    __THZ_APPLY_LOOP(__THZ_APPLY_SEEK(TYPE, TENSOR),                    \
+                     __THZ_APPLY_RUN(TENSOR),                           \
+                     TENSOR##_stride == 1,                              \
+                     TENSOR##_data++;,                                  \
+                     TENSOR##_data += TENSOR##_stride;,                 \
+                     __THZ_APPLY_ADVANCE(TENSOR),                       \
+                     CODE)                                              \
+  }
+
+#define THZ_TENSOR_APPLY2(TYPE1, TENSOR1, TYPE2, TENSOR2, CODE)         \
+  {                                                                     \
+    __THZ_APPLY_INIT(TYPE1, TENSOR1)                                    \
+    __THZ_APPLY_INIT(TYPE2, TENSOR2)                                    \
+    const long THZ_APPLY_n = TENSOR1##_n;                               \
+    __THZ_APPLY_CHECK(TENSOR1, TENSOR2)                                 \
+    __THZ_APPLY_LOOP(__THZ_APPLY_SEEK(TYPE1, TENSOR1)                   \
+                     __THZ_APPLY_SEEK(TYPE2, TENSOR2),                  \
+                     __THZ_APPLY_RUN(TENSOR1)                           \
+                     __THZ_APPLY_RUN(TENSOR2),                          \
+                     TENSOR1##_stride == 1 && TENSOR2##_stride == 1,    \
+                     TENSOR1##_data++; TENSOR2##_data++;,               \
+                     TENSOR1##_data += TENSOR1##_stride;                \
+                     TENSOR2##_data += TENSOR2##_stride;,               \
+                     __THZ_APPLY_ADVANCE(TENSOR1)                       \
+                     __THZ_APPLY_ADVANCE(TENSOR2),                      \
+                     CODE)                                              \
+  }
+
+#define THZ_TENSOR_APPLY3(TYPE1, TENSOR1, TYPE2, TENSOR2, TYPE3, TENSOR3, CODE) \
+  {                                                                     \
+    __THZ_APPLY_INIT(TYPE1, TENSOR1)                                    \
+    __THZ_APPLY_INIT(TYPE2, TENSOR2)                                    \
+    __THZ_APPLY_INIT(TYPE3, TENSOR3)                                    \
+    const long THZ_APPLY_n = TENSOR1##_n;                               \
+    __THZ_APPLY_CHECK(TENSOR1, TENSOR2)                                 \
+    __THZ_APPLY_CHECK(TENSOR1, TENSOR3)                                 \
+    __THZ_APPLY_LOOP(__THZ_APPLY_SEEK(TYPE1, TENSOR1)                   \
+                     __THZ_APPLY_SEEK(TYPE2, TENSOR2)                   \
+                     __THZ_APPLY_SEEK(TYPE3, TENSOR3),                  \
+                     __THZ_APPLY_RUN(TENSOR1)                           \
+                     __THZ_APPLY_RUN(TENSOR2)                           \
+                     __THZ_APPLY_RUN(TENSOR3),                          \
+                     TENSOR1##_stride == 1 && TENSOR2##_stride == 1 && TENSOR3##_stride == 1, \
+                     TENSOR1##_data++; TENSOR2##_data++; TENSOR3##_data++;, \
+                     TENSOR1##_data += TENSOR1##_stride;                \
+                     TENSOR2##_data += TENSOR2##_stride;                \
+                     TENSOR3##_data += TENSOR3##_stride;,               \
+                     __THZ_APPLY_ADVANCE(TENSOR1)                       \
+                     __THZ_APPLY_ADVANCE(TENSOR2)                       \
+                     __THZ_APPLY_ADVANCE(TENSOR3),                      \
+                     CODE)                                              \
+  }
+
+#endif
@@ -0,0 +1,101 @@
+#include "THZVector.h"
+#include "vector/simd.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <cpuid.h>
+
+static unsigned long long THZ_xgetbv(void)
+{
+  unsigned int eax, edx;
+  __asm__ __volatile__("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+  return ((unsigned long long)edx << 32) | eax;
+}
+
+/* AVX2 and AVX-512 also need the OS to save the wider registers, which
+   xgetbv reports */
+static int THZ_detectSimdExtensions(void)
+{
+  unsigned int eax, ebx, ecx, edx;
+  unsigned int features;
+  unsigned long long xcr0 = 0;
+  int simd = 0;
+
+  if(!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+    return 0;
+  features = ecx;
+
+  if(features & bit_SSE3)
+    simd |= THZ_SIMD_SSE3;
+
+  if(!(features & bit_OSXSAVE))
+    return simd;
+  xcr0 = THZ_xgetbv();
+
+  if(!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx))
+    return simd;
+
+  /* xmm and ymm state, plus fma and avx2 */
+  if((xcr0 & 0x6) == 0x6 && (ebx & bit_AVX2) && (features & bit_FMA))
+    simd |= THZ_SIMD_AVX2;
+
+  /* opmask, upper zmm and hi16 zmm state */
+  if((xcr0 & 0xE6) == 0xE6 && (ebx & bit_AVX512F))
+    simd |= THZ_SIMD_AVX512;
+
+  return simd;
+}
+#else
+static int THZ_detectSimdExtensions(void)
+{
+  return 0;
+}
+#endif
+
+static int THZ_simdExtensions = -1;
+
+int THZVector_simdExtensions(void)
+{
+  if(THZ_simdExtensions < 0)
+    THZ_simdExtensions = THZ_detectSimdExtensions();
+  return THZ_simdExtensions;
+}
+
+static int THZ_fastMath = 0;
+
+void THZVector_setFastMath(int fast)
+{
+  THZ_fastMath = (fast != 0);
+}
+
+int THZVector_fastMath(void)
+{
+  return THZ_fastMath;
+}
+
+/* portable fast math kernels, for THZVectorDispatch.c */
+#define real float complex
+#define SIMD_NAME(NAME) THZFloatVector_##NAME##_DEFAULT
+#define SIMD_LINKAGE static
+#include "vector/fastmath_kernels.h"
+#undef real
+#undef SIMD_NAME
+
+#define real double complex
+#define SIMD_NAME(NAME) THZDoubleVector_##NAME##_DEFAULT
+#define SIMD_LINKAGE static
+#define SIMD_DOUBLE
+#include "vector/fastmath_kernels.h"
+#undef real
+#undef SIMD_NAME
+
+#include "generic/THZVectorDispatch.c"
+#include "THZGenerateAllTypes.h"
+
+#if defined(__GNUC__)
+__attribute__((constructor))
+#endif
+static void THZVector_startup(void)
+{
+  THZFloatVector_vectorDispatchInit();
+  THZDoubleVector_vectorDispatchInit();
+}
@@ -5,7 +5,54 @@
 
 #define THZVector_(NAME) TH_CONCAT_4(THZ,Real,Vector_,NAME)
 
+/* Shape of the tile of c updated by THZVector_(gemmKernel): THZ_GEMM_MR
+   rows by THZ_GEMM_NR columns. The SIMD kernels are written for it. */
+#define THZ_GEMM_MR_Float 8
+#define THZ_GEMM_MR_Double 4
+#define THZ_GEMM_MR TH_CONCAT_2(THZ_GEMM_MR_, Real)
+#define THZ_GEMM_NR 3
+
+/* contiguous ops hand blocks of this many elements to the THZVector kernels,
+   the blocks being spread over the OpenMP threads once there are more than
+   THZ_OMP_OVERHEAD_THZRESHOLD elements */
+#define THZ_VECTOR_BLOCK 4096
+#define THZ_OMP_OVERHEAD_THZRESHOLD 100000
+
+/* Fast math mode, off by default: exp, log, sqrt, pow, abs and arg of
+   contiguous tensors (THZTensor_(exp)..., THZTensor_(zabs), THZTensor_(zarg),
+   THZTensor_(Float_abs) of ZFloatTensor and THZTensor_(Double_abs) of
+   ZDoubleTensor..., THZTensor_(polar), THZTensor_(fromPolar)), and exp, log
+   and sqrt in THZTensor_(evalExpr), go
+   through the THZVector_(fast*) kernels instead of libm. Maximum errors
+   measured on random inputs, in ulps of the modulus of the result:
+
+                    float   double
+     abs             1.5     1.5
+     arg             2.5     2.5
+     exp             2.5     2.5
+     log             1.5     1.5    (ulps of 1 when |log z| < 1)
+     sqrt            2       2
+     fromPolar       2       2
+     pow(z, c)       3.5     3.5    m <= 1, for m = |c| max(1, |log z|)
+                     4 m     4 m    beyond that
+
+   pow computes c log z in working precision: its absolute error, that of
+   log z times |c| plus the rounding of the product, becomes the relative
+   error of the result, hence the growth with m. Beyond m = 1 pow was
+   measured up to 3.5 m, for real and complex c of modulus 1/8 to 44 and z
+   near the unit circle, near the negative real axis, or uniform in
+   [-1000, 1000]^2.
+   exp and pow assume finite results and |im| below 6000 for float, 1.6e6
+   for double, and lose precision on subnormal results. abs, arg, log and
+   sqrt keep their accuracy over the whole range, subnormal parts included,
+   and handle zeros, infinities and NaNs as libm does. */
+THZ_API void THZVector_setFastMath(int fast);
+THZ_API int THZVector_fastMath(void);
+
 #include "generic/THZVector.c"
 #include "THZGenerateAllTypes.h"
 
+#include "generic/THZVectorDispatch.h"
+#include "THZGenerateAllTypes.h"
+
 #endif
@@ -97,3 +97,54 @@ CHECK_SSE(CXX "SSE2" " ;-msse2;/arch:SSE2")
 CHECK_SSE(CXX "SSE3" " ;-msse3;/arch:SSE3")
 CHECK_SSE(CXX "SSE4_1" " ;-msse4.1;-msse4;/arch:SSE4")
 CHECK_SSE(CXX "SSE4_2" " ;-msse4.2;-msse4;/arch:SSE4")
+
+# Wider extensions are picked at runtime from cpuid, so the build machine
+# only has to be able to compile them, not to run them.
+INCLUDE(CheckCSourceCompiles)
+
+SET(AVX2_CODE "
+  #include <immintrin.h>
+
+  int main()
+  {
+    __m256 a = _mm256_set1_ps(0);
+    a = _mm256_fmaddsub_ps(a, a, a);
+    return (int)_mm256_cvtss_f32(a);
+  }")
+
+SET(AVX512_CODE "
+  #include <immintrin.h>
+
+  int main()
+  {
+    __m512d a = _mm512_set1_pd(0);
+    a = _mm512_fmaddsub_pd(a, _mm512_permute_pd(a, 0x55), a);
+    return (int)_mm512_reduce_add_pd(a);
+  }")
+
+MACRO(CHECK_SIMD_COMPILES type flags)
+  SET(__FLAG_I 1)
+  SET(CMAKE_REQUIRED_FLAGS_SAVE ${CMAKE_REQUIRED_FLAGS})
+  FOREACH(__FLAG ${flags})
+    IF(NOT C_${type}_FOUND)
+      SET(CMAKE_REQUIRED_FLAGS ${__FLAG})
+      CHECK_C_SOURCE_COMPILES("${${type}_CODE}" C_HAS_${type}_${__FLAG_I})
+      IF(C_HAS_${type}_${__FLAG_I})
+        SET(C_${type}_FOUND TRUE CACHE BOOL "C ${type} support")
+        SET(C_${type}_FLAGS "${__FLAG}" CACHE STRING "C ${type} flags")
+      ENDIF()
+      MATH(EXPR __FLAG_I "${__FLAG_I}+1")
+    ENDIF()
+  ENDFOREACH()
+  SET(CMAKE_REQUIRED_FLAGS ${CMAKE_REQUIRED_FLAGS_SAVE})
+
+  IF(NOT C_${type}_FOUND)
+    SET(C_${type}_FOUND FALSE CACHE BOOL "C ${type} support")
+    SET(C_${type}_FLAGS "" CACHE STRING "C ${type} flags")
+  ENDIF()
+
+  MARK_AS_ADVANCED(C_${type}_FOUND C_${type}_FLAGS)
+ENDMACRO()
+
+CHECK_SIMD_COMPILES("AVX2" "-mavx2 -mfma;/arch:AVX2")
+CHECK_SIMD_COMPILES("AVX512" "-mavx512f;/arch:AVX512")
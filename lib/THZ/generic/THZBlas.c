@@ -25,6 +25,14 @@ THZ_EXTERNC void zger_(int *m, int *n, double complex *alpha, double complex *x,
 THZ_EXTERNC void cgerc_(int *m, int *n, float complex *alpha, float complex *x, int *incx, float complex *y, int *incy, float complex *a, int *lda);
 THZ_EXTERNC void zgemm_(char *transa, char *transb, int *m, int *n, int *k, double complex *alpha, double complex *a, int *lda, double complex *b, int *ldb, double complex *beta, double complex *c, int *ldc);
 THZ_EXTERNC void cgemm_(char *transa, char *transb, int *m, int *n, int *k, float complex *alpha, float complex *a, int *lda, float complex *b, int *ldb, float complex *beta, float complex *c, int *ldc);
+#ifdef USE_GEMM3M
+THZ_EXTERNC void zgemm3m_(char *transa, char *transb, int *m, int *n, int *k, double complex *alpha, double complex *a, int *lda, double complex *b, int *ldb, double complex *beta, double complex *c, int *ldc);
+THZ_EXTERNC void cgemm3m_(char *transa, char *transb, int *m, int *n, int *k, float complex *alpha, float complex *a, int *lda, float complex *b, int *ldb, float complex *beta, float complex *c, int *ldc);
+#endif
+#ifdef USE_MKL
+THZ_EXTERNC void zgemm_batch_(char *transa, char *transb, int *m, int *n, int *k, double complex *alpha, double complex **a, int *lda, double complex **b, int *ldb, double complex *beta, double complex **c, int *ldc, int *group_count, int *group_size);
+THZ_EXTERNC void cgemm_batch_(char *transa, char *transb, int *m, int *n, int *k, float complex *alpha, float complex **a, int *lda, float complex **b, int *ldb, float complex *beta, float complex **c, int *ldc, int *group_count, int *group_size);
+#endif
 
 
 
@@ -305,10 +313,165 @@ void THZBlas_(geru)(long m, long n, real alpha, real *x, long incx, real *y, lon
   }
 }
 
+/* Packs rows [0, mc) x columns [0, kc) of op(a), scaled by alpha, into
+   panels of THZ_GEMM_MR rows stored column after column, zero padding the
+   last panel. a points at the first element of the block. */
+static void THZBlas_(gemmPackA)(int trans, int conjugate, long mc, long kc, real alpha, const real *a, long lda, real *ap, int parallel)
+{
+  long npanels = (mc + THZ_GEMM_MR - 1) / THZ_GEMM_MR;
+  long p;
+
+#pragma omp parallel for if(parallel) private(p)
+  for(p = 0; p < npanels; p++)
+  {
+    real *ap_ = ap + p*THZ_GEMM_MR*kc;
+    long i0 = p*THZ_GEMM_MR;
+    long mr = (mc - i0 < THZ_GEMM_MR ? mc - i0 : THZ_GEMM_MR);
+    long i, l;
+    for(l = 0; l < kc; l++)
+    {
+      for(i = 0; i < mr; i++)
+      {
+        real v = (trans ? a[l+(i0+i)*lda] : a[(i0+i)+l*lda]);
+        ap_[i] = alpha*(conjugate ? CONJ(v) : v);
+      }
+      for(; i < THZ_GEMM_MR; i++)
+        ap_[i] = 0;
+      ap_ += THZ_GEMM_MR;
+    }
+  }
+}
+
+/* Same for op(b), rows [0, kc) x columns [0, nc), in panels of THZ_GEMM_NR
+   columns stored row after row */
+static void THZBlas_(gemmPackB)(int trans, int conjugate, long kc, long nc, const real *b, long ldb, real *bp, int parallel)
+{
+  long npanels = (nc + THZ_GEMM_NR - 1) / THZ_GEMM_NR;
+  long p;
+
+#pragma omp parallel for if(parallel) private(p)
+  for(p = 0; p < npanels; p++)
+  {
+    real *bp_ = bp + p*THZ_GEMM_NR*kc;
+    long j0 = p*THZ_GEMM_NR;
+    long nr = (nc - j0 < THZ_GEMM_NR ? nc - j0 : THZ_GEMM_NR);
+    long j, l;
+    for(l = 0; l < kc; l++)
+    {
+      for(j = 0; j < nr; j++)
+      {
+        real v = (trans ? b[(j0+j)+l*ldb] : b[l+(j0+j)*ldb]);
+        bp_[j] = (conjugate ? CONJ(v) : v);
+      }
+      for(; j < THZ_GEMM_NR; j++)
+        bp_[j] = 0;
+      bp_ += THZ_GEMM_NR;
+    }
+  }
+}
+
+/* c = alpha*op(a)*op(b) + beta*c without a BLAS library: the operands are
+   packed block by block (see THZ_GEMM_KC/MC/NC) and the tiles of each
+   mc x nc block of c, THZ_GEMM_MR x THZ_GEMM_NR each, are shared among
+   threads and updated by THZVector_(gemmKernel). Tiles cut by the edges of c
+   go through a scratch tile. beta == 0 overwrites c, as BLAS does. */
+static void THZBlas_(gemmPacked)(int transa, int conja, int transb, int conjb, long m, long n, long k, real alpha, real *a, long lda, real *b, long ldb, real beta, real *c, long ldc)
+{
+  int parallel = ((double)m*n*k > THZ_GEMM_OMP_THRESHOLD);
+  long kcMax = (k < THZ_GEMM_KC ? k : THZ_GEMM_KC);
+  long mcMax = (m < THZ_GEMM_MC ? m : THZ_GEMM_MC);
+  long ncMax = (n < THZ_GEMM_NC ? n : THZ_GEMM_NC);
+  real *ap, *bp;
+  long i, j, ic, jc, pc;
+
+  if(beta != 1)
+  {
+    for(j = 0; j < n; j++)
+    {
+      real *c_ = c + j*ldc;
+      if(beta == 0)
+        for(i = 0; i < m; i++)
+          c_[i] = 0;
+      else
+        for(i = 0; i < m; i++)
+          c_[i] *= beta;
+    }
+  }
+
+  if(alpha == 0 || k == 0)
+    return;
+
+  ap = THZCachingAllocator.malloc(NULL, sizeof(real)*((mcMax + THZ_GEMM_MR - 1) / THZ_GEMM_MR)*THZ_GEMM_MR*kcMax);
+  bp = THZCachingAllocator.malloc(NULL, sizeof(real)*((ncMax + THZ_GEMM_NR - 1) / THZ_GEMM_NR)*THZ_GEMM_NR*kcMax);
+
+  for(jc = 0; jc < n; jc += THZ_GEMM_NC)
+  {
+    long nc = (n - jc < THZ_GEMM_NC ? n - jc : THZ_GEMM_NC);
+    long npanels = (nc + THZ_GEMM_NR - 1) / THZ_GEMM_NR;
+
+    for(pc = 0; pc < k; pc += THZ_GEMM_KC)
+    {
+      long kc = (k - pc < THZ_GEMM_KC ? k - pc : THZ_GEMM_KC);
+
+      THZBlas_(gemmPackB)(transb, conjb, kc, nc, (transb ? b + jc + pc*ldb : b + pc + jc*ldb), ldb, bp, parallel);
+
+      for(ic = 0; ic < m; ic += THZ_GEMM_MC)
+      {
+        long mc = (m - ic < THZ_GEMM_MC ? m - ic : THZ_GEMM_MC);
+        long mpanels = (mc + THZ_GEMM_MR - 1) / THZ_GEMM_MR;
+        long tile;
+
+        THZBlas_(gemmPackA)(transa, conja, mc, kc, alpha, (transa ? a + pc + ic*lda : a + ic + pc*lda), lda, ap, parallel);
+
+#pragma omp parallel for if(parallel) private(tile)
+        for(tile = 0; tile < npanels*mpanels; tile++)
+        {
+          long ir = (tile % mpanels)*THZ_GEMM_MR;
+          long jr = (tile / mpanels)*THZ_GEMM_NR;
+          long mr = (mc - ir < THZ_GEMM_MR ? mc - ir : THZ_GEMM_MR);
+          long nr = (nc - jr < THZ_GEMM_NR ? nc - jr : THZ_GEMM_NR);
+          real *c_ = c + (ic + ir) + (jc + jr)*ldc;
+
+          if(mr == THZ_GEMM_MR && nr == THZ_GEMM_NR)
+            THZVector_(gemmKernel)(kc, ap + ir*kc, bp + jr*kc, c_, ldc);
+          else
+          {
+            real edge[THZ_GEMM_MR*THZ_GEMM_NR];
+            long ii, jj;
+            for(ii = 0; ii < THZ_GEMM_MR*THZ_GEMM_NR; ii++)
+              edge[ii] = 0;
+            THZVector_(gemmKernel)(kc, ap + ir*kc, bp + jr*kc, edge, THZ_GEMM_MR);
+            for(jj = 0; jj < nr; jj++)
+              for(ii = 0; ii < mr; ii++)
+                c_[jj*ldc+ii] += edge[jj*THZ_GEMM_MR+ii];
+          }
+        }
+      }
+    }
+  }
+
+  THZCachingAllocator.free(NULL, ap);
+  THZCachingAllocator.free(NULL, bp);
+}
+
+/* gemm that always runs the packed kernel above, even when THZ is built
+   with a BLAS library */
+void THZBlas_(gemmBlocked)(char transa, char transb, long m, long n, long k, real alpha, real *a, long lda, real *b, long ldb, real beta, real *c, long ldc)
+{
+  int conja = ((transa == 'c') || (transa == 'C'));
+  int conjb = ((transb == 'c') || (transb == 'C'));
+  int transa_ = ((transa == 't') || (transa == 'T') || conja);
+  int transb_ = ((transb == 't') || (transb == 'T') || conjb);
+
+  THZBlas_(gemmPacked)(transa_, conja, transb_, conjb, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+}
+
 void THZBlas_(gemm)(char transa, char transb, long m, long n, long k, real alpha, real *a, long lda, real *b, long ldb, real beta, real *c, long ldc)
 {
-  int transa_ = ((transa == 't') || (transa == 'T'));
-  int transb_ = ((transb == 't') || (transb == 'T'));
+  int conja = ((transa == 'c') || (transa == 'C'));
+  int conjb = ((transb == 'c') || (transb == 'C'));
+  int transa_ = ((transa == 't') || (transa == 'T') || conja);
+  int transb_ = ((transb == 't') || (transb == 'T') || conjb);
 
   if(n == 1)
     ldc = m;
@@ -353,6 +516,11 @@ void THZBlas_(gemm)(char transa, char transb, long m, long n, long k, real alpha
     return;
   }
 #endif
+  if(conja || conjb || (double)m*n*k > THZ_GEMM_SMALL)
+  {
+    THZBlas_(gemmPacked)(transa_, conja, transb_, conjb, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+    return;
+  }
   {
     long i, j, l;
     if(!transa_ && !transb_)
@@ -367,7 +535,7 @@ void THZBlas_(gemm)(char transa, char transb, long m, long n, long k, real alpha
           for(l = 0; l < k; l++)
             sum += a_[l*lda]*b_[l];
           b_ += ldb;
-          c[j*ldc+i] = beta*c[j*ldc+i]+alpha*sum;
+          c[j*ldc+i] = (beta == 0 ? 0 : beta*c[j*ldc+i])+alpha*sum;
         }
         a_++;
       }
@@ -384,7 +552,7 @@ void THZBlas_(gemm)(char transa, char transb, long m, long n, long k, real alpha
           for(l = 0; l < k; l++)
             sum += a_[l]*b_[l];
           b_ += ldb;
-          c[j*ldc+i] = beta*c[j*ldc+i]+alpha*sum;
+          c[j*ldc+i] = (beta == 0 ? 0 : beta*c[j*ldc+i])+alpha*sum;
         }
         a_ += lda;
       }
@@ -401,7 +569,7 @@ void THZBlas_(gemm)(char transa, char transb, long m, long n, long k, real alpha
           for(l = 0; l < k; l++)
             sum += a_[l*lda]*b_[l*ldb];
           b_++;
-          c[j*ldc+i] = beta*c[j*ldc+i]+alpha*sum;
+          c[j*ldc+i] = (beta == 0 ? 0 : beta*c[j*ldc+i])+alpha*sum;
         }
         a_++;
       }
@@ -418,7 +586,7 @@ void THZBlas_(gemm)(char transa, char transb, long m, long n, long k, real alpha
           for(l = 0; l < k; l++)
             sum += a_[l]*b_[l*ldb];
           b_++;
-          c[j*ldc+i] = beta*c[j*ldc+i]+alpha*sum;
+          c[j*ldc+i] = (beta == 0 ? 0 : beta*c[j*ldc+i])+alpha*sum;
         }
         a_ += lda;
       }
@@ -426,4 +594,193 @@ void THZBlas_(gemm)(char transa, char transb, long m, long n, long k, real alpha
   }
 }
 
+#if defined(USE_BLAS) && (defined(THZ_REAL_IS_DOUBLE) || defined(THZ_REAL_IS_FLOAT))
+/* 3M product with the parts of op(a) and op(b) split into planar buffers,
+   for the real gemm of TH */
+static void THZBlas_(gemm3mSplit)(int transa, int conja, int transb, int conjb, long m, long n, long k, real alpha, real *a, long lda, real *b, long ldb, real beta, real *c, long ldc)
+{
+  realscalar *ar = THZCachingAllocator.malloc(NULL, sizeof(realscalar)*(2*(m*k + k*n) + 3*m*n));
+  realscalar *ai = ar + m*k;
+  realscalar *br = ai + m*k;
+  realscalar *bi = br + k*n;
+  realscalar *p1 = bi + k*n;
+  realscalar *p2 = p1 + m*n;
+  realscalar *p3 = p2 + m*n;
+  long i, j, l;
+
+#pragma omp parallel for if(m*k > THZ_GEMM_OMP_THRESHOLD) private(l, i)
+  for(l = 0; l < k; l++)
+  {
+    for(i = 0; i < m; i++)
+    {
+      real v = (transa ? a[l+i*lda] : a[i+l*lda]);
+      ar[i+l*m] = CREAL(v);
+      ai[i+l*m] = (conja ? -CIMAG(v) : CIMAG(v));
+    }
+  }
+
+#pragma omp parallel for if(k*n > THZ_GEMM_OMP_THRESHOLD) private(j, l)
+  for(j = 0; j < n; j++)
+  {
+    for(l = 0; l < k; l++)
+    {
+      real v = (transb ? b[j+l*ldb] : b[l+j*ldb]);
+      br[l+j*k] = CREAL(v);
+      bi[l+j*k] = (conjb ? -CIMAG(v) : CIMAG(v));
+    }
+  }
+
+  THRealBlas_(gemm)('n', 'n', m, n, k, 1, ar, m, br, k, 0, p1, m);
+  THRealBlas_(gemm)('n', 'n', m, n, k, 1, ai, m, bi, k, 0, p2, m);
+  for(i = 0; i < m*k; i++)
+    ar[i] += ai[i];
+  for(i = 0; i < k*n; i++)
+    br[i] += bi[i];
+  THRealBlas_(gemm)('n', 'n', m, n, k, 1, ar, m, br, k, 0, p3, m);
+
+#pragma omp parallel for if(m*n > THZ_GEMM_OMP_THRESHOLD) private(j, i)
+  for(j = 0; j < n; j++)
+  {
+    for(i = 0; i < m; i++)
+    {
+      realscalar t1 = p1[i+j*m], t2 = p2[i+j*m], t3 = p3[i+j*m];
+      real v = (t1 - t2) + (t3 - t1 - t2)*I;
+      c[i+j*ldc] = (beta == 0 ? 0 : beta*c[i+j*ldc]) + alpha*v;
+    }
+  }
+
+  THZCachingAllocator.free(NULL, ar);
+}
+#endif
+
+/* c = alpha*op(a)*op(b) + beta*c with three real matrix products instead of
+   four (the 3M method): for a = ar + i*ai and b = br + i*bi,
+     re(a*b) = ar*br - ai*bi
+     im(a*b) = (ar + ai)*(br + bi) - ar*br - ai*bi
+   MKL and OpenBLAS provide it as cgemm3m/zgemm3m; with another BLAS the
+   parts are split for three real gemms. The imaginary part cancels, so its
+   error grows like k*eps*(|ar|+|ai|)*(|br|+|bi|) instead of k*eps*|a|*|b|,
+   up to twice as large; hence it is opt-in. Without BLAS the real products
+   are no faster than the complex one and this is gemm. */
+void THZBlas_(gemm3m)(char transa, char transb, long m, long n, long k, real alpha, real *a, long lda, real *b, long ldb, real beta, real *c, long ldc)
+{
+  int conja = ((transa == 'c') || (transa == 'C'));
+  int conjb = ((transb == 'c') || (transb == 'C'));
+  int transa_ = ((transa == 't') || (transa == 'T') || conja);
+  int transb_ = ((transb == 't') || (transb == 'T') || conjb);
+
+  if(n == 1)
+    ldc = m;
+
+  if(transa_)
+  {
+    if(m == 1)
+      lda = k;
+  }
+  else
+  {
+    if(k == 1)
+      lda = m;
+  }
+
+  if(transb_)
+  {
+    if(k == 1)
+      ldb = n;
+  }
+  else
+  {
+    if(n == 1)
+      ldb = k;
+  }
+
+#if defined(USE_GEMM3M) && (defined(THZ_REAL_IS_DOUBLE) || defined(THZ_REAL_IS_FLOAT))
+  if( (m <= INT_MAX) && (n <= INT_MAX) && (k <= INT_MAX) && (lda <= INT_MAX)  && (ldb <= INT_MAX) && (ldc <= INT_MAX) )
+  {
+    int i_m = (int)m;
+    int i_n = (int)n;
+    int i_k = (int)k;
+    int i_lda = (int)lda;
+    int i_ldb = (int)ldb;
+    int i_ldc = (int)ldc;
+
+#if defined(THZ_REAL_IS_DOUBLE)
+    zgemm3m_(&transa, &transb, &i_m, &i_n, &i_k, &alpha, a, &i_lda, b, &i_ldb, &beta, c, &i_ldc);
+#else
+    cgemm3m_(&transa, &transb, &i_m, &i_n, &i_k, &alpha, a, &i_lda, b, &i_ldb, &beta, c, &i_ldc);
+#endif
+    return;
+  }
+#endif
+#if defined(USE_BLAS) && (defined(THZ_REAL_IS_DOUBLE) || defined(THZ_REAL_IS_FLOAT))
+  if(m > 0 && n > 0 && k > 0 && alpha != 0)
+  {
+    THZBlas_(gemm3mSplit)(transa_, conja, transb_, conjb, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+    return;
+  }
+#endif
+  THZBlas_(gemm)(transa, transb, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+}
+
+/* c[i] = alpha * op(a[i]) * op(b[i]) + beta * c[i] for i < batchCount, all
+   products sharing one shape. MKL runs the whole batch in one call; other
+   builds spread the products over OpenMP threads. */
+void THZBlas_(gemmBatch)(char transa, char transb, long m, long n, long k, real alpha, real **a, long lda, real **b, long ldb, real beta, real **c, long ldc, long batchCount)
+{
+  long i;
+
+#if defined(USE_MKL) && (defined(THZ_REAL_IS_DOUBLE) || defined(THZ_REAL_IS_FLOAT))
+  int transa_ = ((transa == 't') || (transa == 'T'));
+  int transb_ = ((transb == 't') || (transb == 'T'));
+
+  if(n == 1)
+    ldc = m;
+
+  if(transa_)
+  {
+    if(m == 1)
+      lda = k;
+  }
+  else
+  {
+    if(k == 1)
+      lda = m;
+  }
+
+  if(transb_)
+  {
+    if(k == 1)
+      ldb = n;
+  }
+  else
+  {
+    if(n == 1)
+      ldb = k;
+  }
+
+  if( (m <= INT_MAX) && (n <= INT_MAX) && (k <= INT_MAX) && (lda <= INT_MAX) && (ldb <= INT_MAX) && (ldc <= INT_MAX) && (batchCount <= INT_MAX) )
+  {
+    int i_m = (int)m;
+    int i_n = (int)n;
+    int i_k = (int)k;
+    int i_lda = (int)lda;
+    int i_ldb = (int)ldb;
+    int i_ldc = (int)ldc;
+    int i_group_count = 1;
+    int i_group_size = (int)batchCount;
+
+#if defined(THZ_REAL_IS_DOUBLE)
+    zgemm_batch_(&transa, &transb, &i_m, &i_n, &i_k, &alpha, a, &i_lda, b, &i_ldb, &beta, c, &i_ldc, &i_group_count, &i_group_size);
+#else
+    cgemm_batch_(&transa, &transb, &i_m, &i_n, &i_k, &alpha, a, &i_lda, b, &i_ldb, &beta, c, &i_ldc, &i_group_count, &i_group_size);
+#endif
+    return;
+  }
+#endif
+
+#pragma omp parallel for if(batchCount > 1) private(i)
+  for(i = 0; i < batchCount; i++)
+    THZBlas_(gemm)(transa, transb, m, n, k, alpha, a[i], lda, b[i], ldb, beta, c[i], ldc);
+}
+
 #endif
@@ -25,5 +25,8 @@ THZ_API void THZBlas_(geru)(long m, long n, real alpha, real *x, long incx, real
 
 /* Level 3 */
 THZ_API void THZBlas_(gemm)(char transa, char transb, long m, long n, long k, real alpha, real *a, long lda, real *b, long ldb, real beta, real *c, long ldc);
+THZ_API void THZBlas_(gemmBlocked)(char transa, char transb, long m, long n, long k, real alpha, real *a, long lda, real *b, long ldb, real beta, real *c, long ldc);
+THZ_API void THZBlas_(gemm3m)(char transa, char transb, long m, long n, long k, real alpha, real *a, long lda, real *b, long ldb, real beta, real *c, long ldc);
+THZ_API void THZBlas_(gemmBatch)(char transa, char transb, long m, long n, long k, real alpha, real **a, long lda, real **b, long ldb, real beta, real **c, long ldc, long batchCount);
 
 #endif
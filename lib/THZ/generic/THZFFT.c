@@ -0,0 +1,430 @@
+/**
+ * Copyright (c) 2015-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#ifndef THZ_GENERIC_FILE
+#define THZ_GENERIC_FILE "generic/THZFFT.c"
+#else
+
+static real THZFFT_(root)(int sign, long j, long n)
+{
+  double angle = 2 * M_PI * (double)j / (double)n;
+  return (real)(cos(angle) + sign * sin(angle) * I);
+}
+
+THZFFTPlan *THZFFT_(newPlan)(long n, int sign)
+{
+  THZFFTPlan *plan;
+  long rem = n, f, j;
+  int bluestein = 0;
+
+  THArgCheck(n > 0, 1, "transform length must be positive");
+  THArgCheck(sign == -1 || sign == 1, 2, "sign must be -1 or 1");
+
+  plan = THAlloc(sizeof(THZFFTPlan));
+  plan->n = n;
+  plan->sign = sign;
+  plan->nfactors = 0;
+  plan->twiddles = NULL;
+  plan->m = 0;
+  plan->chirp = NULL;
+  plan->kernel = NULL;
+  plan->sub = NULL;
+
+  while(rem % 4 == 0)
+  {
+    plan->factors[plan->nfactors++] = 4;
+    rem /= 4;
+  }
+  if(rem % 2 == 0)
+  {
+    plan->factors[plan->nfactors++] = 2;
+    rem /= 2;
+  }
+  for(f = 3; f*f <= rem; f += 2)
+  {
+    while(rem % f == 0)
+    {
+      plan->factors[plan->nfactors++] = f;
+      rem /= f;
+    }
+  }
+  if(rem > 1)
+    plan->factors[plan->nfactors++] = rem;
+
+  for(j = 0; j < plan->nfactors; j++)
+    if(plan->factors[j] > THZ_FFT_MAX_RADIX)
+      bluestein = 1;
+
+  if(!bluestein)
+  {
+    plan->twiddles = THAlloc(sizeof(real)*n);
+    for(j = 0; j < n; j++)
+      plan->twiddles[j] = THZFFT_(root)(sign, j, n);
+    return plan;
+  }
+
+  /* Bluestein: with c_j = exp(sign*pi*i*j^2/n), X_k = c_k sum_j (x_j c_j) conj(c_{k-j}),
+     a circular convolution of length m >= 2n-1 computed with power-of-two transforms */
+  plan->nfactors = 0;
+  plan->m = 1;
+  while(plan->m < 2*n-1)
+    plan->m *= 2;
+  plan->sub = THZFFT_(newPlan)(plan->m, -1);
+
+  plan->chirp = THAlloc(sizeof(real)*n);
+  for(j = 0; j < n; j++)
+    plan->chirp[j] = THZFFT_(root)(sign, (long)(((long long)j*j) % (2*n)), 2*n);
+
+  plan->kernel = THAlloc(sizeof(real)*2*plan->m);
+  for(j = 0; j < plan->m; j++)
+    plan->kernel[j] = 0;
+  plan->kernel[0] = CONJ(plan->chirp[0]);
+  for(j = 1; j < n; j++)
+    plan->kernel[j] = plan->kernel[plan->m-j] = CONJ(plan->chirp[j]);
+  THZFFT_(execute)(plan->sub, plan->kernel, plan->kernel + plan->m);
+  for(j = 0; j < plan->m; j++)
+    plan->kernel[j] /= (realscalar)plan->m;
+  plan->kernel = THRealloc(plan->kernel, sizeof(real)*plan->m);
+
+  return plan;
+}
+
+void THZFFT_(freePlan)(THZFFTPlan *plan)
+{
+  if(!plan)
+    return;
+  THFree(plan->twiddles);
+  THFree(plan->chirp);
+  THFree(plan->kernel);
+  THZFFT_(freePlan)(plan->sub);
+  THFree(plan);
+}
+
+long THZFFT_(workSize)(const THZFFTPlan *plan)
+{
+  return plan->m ? 2*plan->m : plan->n;
+}
+
+/* One self-sorting (Stockham) decimation-in-frequency pass of radix p over
+   sub-transforms of length len interleaved with stride s:
+   y[q + s*(p*k+u)] = w_len^(k*u) sum_r x[q + s*(k+r*m)] w_p^(r*u) */
+static void THZFFT_(pass)(const THZFFTPlan *plan, long p, long len, long s, const real *x, real *y)
+{
+  const real *w = plan->twiddles;
+  const long m = len / p;
+  const long np = plan->n / p;
+  long k, q;
+
+  if(p == 2)
+  {
+    for(k = 0; k < m; k++)
+    {
+      const real w1 = w[k*s];
+      for(q = 0; q < s; q++)
+      {
+        const real a0 = x[q + s*k];
+        const real a1 = x[q + s*(k+m)];
+        y[q + s*(2*k)] = a0 + a1;
+        y[q + s*(2*k+1)] = (a0 - a1) * w1;
+      }
+    }
+  }
+  else if(p == 4)
+  {
+    for(k = 0; k < m; k++)
+    {
+      const real w1 = w[k*s];
+      const real w2 = w[2*k*s];
+      const real w3 = w[3*k*s];
+      for(q = 0; q < s; q++)
+      {
+        const real a0 = x[q + s*k];
+        const real a1 = x[q + s*(k+m)];
+        const real a2 = x[q + s*(k+2*m)];
+        const real a3 = x[q + s*(k+3*m)];
+        const real t0 = a0 + a2;
+        const real t1 = a0 - a2;
+        const real t2 = a1 + a3;
+        const real d = a1 - a3;
+        /* d * w_4 = d * sign * i */
+        const real t3 = plan->sign * (-CIMAG(d) + CREAL(d) * I);
+        y[q + s*(4*k)] = t0 + t2;
+        y[q + s*(4*k+1)] = (t1 + t3) * w1;
+        y[q + s*(4*k+2)] = (t0 - t2) * w2;
+        y[q + s*(4*k+3)] = (t1 - t3) * w3;
+      }
+    }
+  }
+  else if(p == 3)
+  {
+    const realscalar h = plan->sign * (realscalar)0.86602540378443864676;
+    for(k = 0; k < m; k++)
+    {
+      const real w1 = w[k*s];
+      const real w2 = w[2*k*s];
+      for(q = 0; q < s; q++)
+      {
+        const real a0 = x[q + s*k];
+        const real a1 = x[q + s*(k+m)];
+        const real a2 = x[q + s*(k+2*m)];
+        const real t1 = a1 + a2;
+        const real t2 = a0 - (realscalar)0.5 * t1;
+        const real d = a1 - a2;
+        const real t3 = h * (-CIMAG(d) + CREAL(d) * I);
+        y[q + s*(3*k)] = a0 + t1;
+        y[q + s*(3*k+1)] = (t2 + t3) * w1;
+        y[q + s*(3*k+2)] = (t2 - t3) * w2;
+      }
+    }
+  }
+  else
+  {
+    real a[THZ_FFT_MAX_RADIX];
+    long r, u;
+    for(k = 0; k < m; k++)
+    {
+      for(q = 0; q < s; q++)
+      {
+        for(r = 0; r < p; r++)
+          a[r] = x[q + s*(k+r*m)];
+        for(u = 0; u < p; u++)
+        {
+          real sum = a[0];
+          for(r = 1; r < p; r++)
+            sum += a[r] * w[((r*u) % p) * np];
+          y[q + s*(p*k+u)] = sum * w[k*u*s];
+        }
+      }
+    }
+  }
+}
+
+void THZFFT_(execute)(const THZFFTPlan *plan, real *x, real *work)
+{
+  real *src = x, *dst = work, *tmp;
+  long len = plan->n, s = 1;
+  long j;
+  int i;
+
+  if(plan->m)
+  {
+    const long n = plan->n, m = plan->m;
+    real *a = work;
+    for(j = 0; j < n; j++)
+      a[j] = x[j] * plan->chirp[j];
+    for(j = n; j < m; j++)
+      a[j] = 0;
+    THZFFT_(execute)(plan->sub, a, work + m);
+    /* inverse transform as conj(fft(conj(.))), the 1/m lives in the kernel */
+    for(j = 0; j < m; j++)
+      a[j] = CONJ(a[j] * plan->kernel[j]);
+    THZFFT_(execute)(plan->sub, a, work + m);
+    for(j = 0; j < n; j++)
+      x[j] = plan->chirp[j] * CONJ(a[j]);
+    return;
+  }
+
+  for(i = 0; i < plan->nfactors; i++)
+  {
+    const long p = plan->factors[i];
+    THZFFT_(pass)(plan, p, len, s, src, dst);
+    tmp = src; src = dst; dst = tmp;
+    len /= p;
+    s *= p;
+  }
+  if(src != x)
+    memcpy(x, src, sizeof(real)*plan->n);
+}
+
+static THZFFTCachedPlan *THZFFT_(cache)[THZ_FFT_CACHE_MAX];
+static int THZFFT_(cacheN) = 0;
+static int THZFFT_(cacheCapacity) = THZ_FFT_CACHE_DEFAULT;
+static unsigned long THZFFT_(cacheClock) = 0;
+static int volatile THZFFT_(cacheLock) = 0;
+
+static void THZFFT_(lockCache)(void)
+{
+  while(!THAtomicCompareAndSwap(&THZFFT_(cacheLock), 0, 1));
+}
+
+static void THZFFT_(unlockCache)(void)
+{
+  THAtomicSet(&THZFFT_(cacheLock), 0);
+}
+
+static THZFFTCachedPlan *THZFFT_(newEntry)(long n, long stride, long batch, int sign)
+{
+  THZFFTCachedPlan *entry = THAlloc(sizeof(THZFFTCachedPlan));
+  entry->n = n;
+  entry->stride = stride;
+  entry->batch = batch;
+  entry->sign = sign;
+  entry->plan = THZFFT_(newPlan)(n, sign);
+  entry->work = n + THZFFT_(workSize)(entry->plan);
+  entry->nthreads = 1;
+#ifdef _OPENMP
+  if(batch > 1 && batch*n > THZ_FFT_OMP_THRESHOLD)
+    entry->nthreads = omp_get_max_threads();
+#endif
+  entry->scratch = THAlloc(sizeof(real)*entry->work*entry->nthreads);
+  entry->busy = 1;
+  entry->cached = 0;
+  entry->lastUse = 0;
+  return entry;
+}
+
+static void THZFFT_(freeEntry)(THZFFTCachedPlan *entry)
+{
+  THZFFT_(freePlan)(entry->plan);
+  THFree(entry->scratch);
+  THFree(entry);
+}
+
+static int THZFFT_(findEntry)(long n, long stride, long batch, int sign)
+{
+  int i;
+  for(i = 0; i < THZFFT_(cacheN); i++)
+  {
+    THZFFTCachedPlan *entry = THZFFT_(cache)[i];
+    if(entry->n == n && entry->stride == stride && entry->batch == batch && entry->sign == sign)
+      return i;
+  }
+  return -1;
+}
+
+/* drops least recently used entries until at most `capacity` remain; entries
+   still in use are only detached and get freed by their release().
+   Must be called with the lock held; returns the entries to free. */
+static int THZFFT_(shrinkCache)(int capacity, THZFFTCachedPlan **victims)
+{
+  int nvictims = 0;
+  while(THZFFT_(cacheN) > capacity)
+  {
+    int i, lru = 0;
+    THZFFTCachedPlan *entry;
+    for(i = 1; i < THZFFT_(cacheN); i++)
+      if(THZFFT_(cache)[i]->lastUse < THZFFT_(cache)[lru]->lastUse)
+        lru = i;
+    entry = THZFFT_(cache)[lru];
+    THZFFT_(cache)[lru] = THZFFT_(cache)[--THZFFT_(cacheN)];
+    entry->cached = 0;
+    if(!entry->busy)
+      victims[nvictims++] = entry;
+  }
+  return nvictims;
+}
+
+THZFFTCachedPlan *THZFFT_(acquire)(long n, long stride, long batch, int sign)
+{
+  THZFFTCachedPlan *entry, *victim = NULL;
+  int i;
+
+  THZFFT_(lockCache)();
+  i = THZFFT_(findEntry)(n, stride, batch, sign);
+  if(i >= 0)
+  {
+    entry = THZFFT_(cache)[i];
+    if(!entry->busy)
+    {
+      entry->busy = 1;
+      entry->lastUse = ++THZFFT_(cacheClock);
+      THZFFT_(unlockCache)();
+      return entry;
+    }
+  }
+  THZFFT_(unlockCache)();
+
+  /* build outside of the lock, it is the expensive part */
+  entry = THZFFT_(newEntry)(n, stride, batch, sign);
+
+  THZFFT_(lockCache)();
+  entry->lastUse = ++THZFFT_(cacheClock);
+  if(THZFFT_(findEntry)(n, stride, batch, sign) < 0 && THZFFT_(cacheCapacity) > 0)
+  {
+    if(THZFFT_(cacheN) == THZFFT_(cacheCapacity))
+    {
+      /* evict the least recently used entry nobody holds */
+      int lru = -1;
+      for(i = 0; i < THZFFT_(cacheN); i++)
+        if(!THZFFT_(cache)[i]->busy && (lru < 0 || THZFFT_(cache)[i]->lastUse < THZFFT_(cache)[lru]->lastUse))
+          lru = i;
+      if(lru >= 0)
+      {
+        victim = THZFFT_(cache)[lru];
+        victim->cached = 0;
+        THZFFT_(cache)[lru] = THZFFT_(cache)[--THZFFT_(cacheN)];
+      }
+    }
+    if(THZFFT_(cacheN) < THZFFT_(cacheCapacity))
+    {
+      entry->cached = 1;
+      THZFFT_(cache)[THZFFT_(cacheN)++] = entry;
+    }
+  }
+  THZFFT_(unlockCache)();
+
+  if(victim)
+    THZFFT_(freeEntry)(victim);
+  return entry;
+}
+
+void THZFFT_(release)(THZFFTCachedPlan *entry)
+{
+  THZFFT_(lockCache)();
+  if(entry->cached)
+  {
+    entry->busy = 0;
+    THZFFT_(unlockCache)();
+    return;
+  }
+  THZFFT_(unlockCache)();
+  THZFFT_(freeEntry)(entry);
+}
+
+void THZFFT_(prewarm)(long n, long stride, long batch, int sign)
+{
+  THZFFT_(release)(THZFFT_(acquire)(n, stride, batch, sign));
+}
+
+void THZFFT_(setCacheCapacity)(int capacity)
+{
+  THZFFTCachedPlan *victims[THZ_FFT_CACHE_MAX];
+  int i, nvictims;
+
+  THArgCheck(capacity >= 0 && capacity <= THZ_FFT_CACHE_MAX, 1, "capacity must be between 0 and %d", THZ_FFT_CACHE_MAX);
+  THZFFT_(lockCache)();
+  THZFFT_(cacheCapacity) = capacity;
+  nvictims = THZFFT_(shrinkCache)(capacity, victims);
+  THZFFT_(unlockCache)();
+  for(i = 0; i < nvictims; i++)
+    THZFFT_(freeEntry)(victims[i]);
+}
+
+void THZFFT_(clearCache)(void)
+{
+  THZFFTCachedPlan *victims[THZ_FFT_CACHE_MAX];
+  int i, nvictims;
+
+  THZFFT_(lockCache)();
+  nvictims = THZFFT_(shrinkCache)(0, victims);
+  THZFFT_(unlockCache)();
+  for(i = 0; i < nvictims; i++)
+    THZFFT_(freeEntry)(victims[i]);
+}
+
+int THZFFT_(cacheCount)(void)
+{
+  int count;
+  THZFFT_(lockCache)();
+  count = THZFFT_(cacheN);
+  THZFFT_(unlockCache)();
+  return count;
+}
+
+#endif
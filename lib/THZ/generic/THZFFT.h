@@ -0,0 +1,71 @@
+/**
+ * Copyright (c) 2015-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#ifndef THZ_GENERIC_FILE
+#define THZ_GENERIC_FILE "generic/THZFFT.h"
+#else
+
+/* A plan holds everything needed to transform a contiguous sequence of
+   length n: its radix decomposition and twiddle table, or, when n has a
+   prime factor larger than THZ_FFT_MAX_RADIX, the chirp and the transformed
+   kernel of Bluestein's algorithm together with a power-of-two sub-plan. */
+typedef struct THZFFTPlan
+{
+    long n;
+    int sign;                 /* -1: forward, +1: inverse (unnormalized) */
+    int nfactors;
+    long factors[THZ_FFT_MAX_FACTORS];
+    real *twiddles;           /* exp(sign*2*pi*i*j/n), j < n */
+
+    /* Bluestein */
+    long m;                   /* padded length, 0 if unused */
+    real *chirp;              /* exp(sign*pi*i*j^2/n), j < n */
+    real *kernel;             /* fft of the conjugated chirp, divided by m */
+    struct THZFFTPlan *sub;   /* forward plan of length m */
+} THZFFTPlan;
+
+THZ_API THZFFTPlan *THZFFT_(newPlan)(long n, int sign);
+THZ_API void THZFFT_(freePlan)(THZFFTPlan *plan);
+
+/* number of complex elements of scratch space execute() needs */
+THZ_API long THZFFT_(workSize)(const THZFFTPlan *plan);
+
+/* transforms the n contiguous elements of x in place */
+THZ_API void THZFFT_(execute)(const THZFFTPlan *plan, real *x, real *work);
+
+/* Batched transforms of `batch` lines of length n, elements `stride` apart,
+   share a cached plan together with per-thread scratch (a gather buffer
+   plus the plan work, `work` elements per thread). The cache keeps the
+   most recently used entries, up to its capacity, for each precision. */
+typedef struct THZFFTCachedPlan
+{
+    long n;
+    long stride;
+    long batch;
+    int sign;
+    THZFFTPlan *plan;
+    real *scratch;
+    long work;
+    int nthreads;
+    int busy;
+    int cached;
+    unsigned long lastUse;
+} THZFFTCachedPlan;
+
+/* returns an entry for exclusive use until release(); when the cached one
+   is held by another caller a private entry is built instead */
+THZ_API THZFFTCachedPlan *THZFFT_(acquire)(long n, long stride, long batch, int sign);
+THZ_API void THZFFT_(release)(THZFFTCachedPlan *entry);
+
+THZ_API void THZFFT_(prewarm)(long n, long stride, long batch, int sign);
+THZ_API void THZFFT_(clearCache)(void);
+THZ_API void THZFFT_(setCacheCapacity)(int capacity);
+THZ_API int THZFFT_(cacheCount)(void);
+
+#endif
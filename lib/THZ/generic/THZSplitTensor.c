@@ -0,0 +1,437 @@
+/**
+ * Copyright (c) 2015-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#ifndef THZ_GENERIC_FILE
+#define THZ_GENERIC_FILE "generic/THZSplitTensor.c"
+#else
+
+/**** access methods ****/
+THRealTensor *THZSplitTensor_(re)(const THZSplitTensor *self)
+{
+  return self->re;
+}
+
+THRealTensor *THZSplitTensor_(im)(const THZSplitTensor *self)
+{
+  return self->im;
+}
+
+int THZSplitTensor_(nDimension)(const THZSplitTensor *self)
+{
+  return self->re->nDimension;
+}
+
+long THZSplitTensor_(size)(const THZSplitTensor *self, int dim)
+{
+  THArgCheck((dim >= 0) && (dim < self->re->nDimension), 2, "out of range");
+  return self->re->size[dim];
+}
+
+THLongStorage *THZSplitTensor_(newSizeOf)(THZSplitTensor *self)
+{
+  return THRealTensor_(newSizeOf)(self->re);
+}
+
+long THZSplitTensor_(nElement)(const THZSplitTensor *self)
+{
+  return THRealTensor_(nElement)(self->re);
+}
+
+int THZSplitTensor_(isContiguous)(const THZSplitTensor *self)
+{
+  return THRealTensor_(isContiguous)(self->re) && THRealTensor_(isContiguous)(self->im);
+}
+
+int THZSplitTensor_(isSameSizeAs)(const THZSplitTensor *self, const THZSplitTensor *src)
+{
+  return THRealTensor_(isSameSizeAs)(self->re, src->re);
+}
+
+/**** creation methods ****/
+THZSplitTensor *THZSplitTensor_(new)(void)
+{
+  THZSplitTensor *self = THAlloc(sizeof(THZSplitTensor));
+  self->re = THRealTensor_(new)();
+  self->im = THRealTensor_(new)();
+  self->refcount = 1;
+  return self;
+}
+
+THZSplitTensor *THZSplitTensor_(newWithSize)(THLongStorage *size)
+{
+  THZSplitTensor *self = THZSplitTensor_(new)();
+  THZSplitTensor_(resize)(self, size);
+  return self;
+}
+
+/* Shares the given real tensors (they are retained, not copied) */
+THZSplitTensor *THZSplitTensor_(newWithParts)(THRealTensor *re, THRealTensor *im)
+{
+  THZSplitTensor *self;
+  THArgCheck(THRealTensor_(isSameSizeAs)(re, im), 2, "real and imaginary parts must have the same size");
+
+  self = THAlloc(sizeof(THZSplitTensor));
+  THRealTensor_(retain)(re);
+  THRealTensor_(retain)(im);
+  self->re = re;
+  self->im = im;
+  self->refcount = 1;
+  return self;
+}
+
+THZSplitTensor *THZSplitTensor_(newContiguous)(THZSplitTensor *self)
+{
+  if(!THZSplitTensor_(isContiguous)(self))
+  {
+    THZSplitTensor *tensor = THZSplitTensor_(new)();
+    THZSplitTensor_(resizeAs)(tensor, self);
+    THZSplitTensor_(copy)(tensor, self);
+    return tensor;
+  }
+  THZSplitTensor_(retain)(self);
+  return self;
+}
+
+THZSplitTensor *THZSplitTensor_(newNarrow)(THZSplitTensor *tensor, int dimension_, long firstIndex_, long size_)
+{
+  THZSplitTensor *self = THAlloc(sizeof(THZSplitTensor));
+  self->re = THRealTensor_(newNarrow)(tensor->re, dimension_, firstIndex_, size_);
+  self->im = THRealTensor_(newNarrow)(tensor->im, dimension_, firstIndex_, size_);
+  self->refcount = 1;
+  return self;
+}
+
+THZSplitTensor *THZSplitTensor_(newSelect)(THZSplitTensor *tensor, int dimension_, long sliceIndex_)
+{
+  THZSplitTensor *self = THAlloc(sizeof(THZSplitTensor));
+  self->re = THRealTensor_(newSelect)(tensor->re, dimension_, sliceIndex_);
+  self->im = THRealTensor_(newSelect)(tensor->im, dimension_, sliceIndex_);
+  self->refcount = 1;
+  return self;
+}
+
+THZSplitTensor *THZSplitTensor_(newTranspose)(THZSplitTensor *tensor, int dimension1_, int dimension2_)
+{
+  THZSplitTensor *self = THAlloc(sizeof(THZSplitTensor));
+  self->re = THRealTensor_(newTranspose)(tensor->re, dimension1_, dimension2_);
+  self->im = THRealTensor_(newTranspose)(tensor->im, dimension1_, dimension2_);
+  self->refcount = 1;
+  return self;
+}
+
+void THZSplitTensor_(resize)(THZSplitTensor *self, THLongStorage *size)
+{
+  THRealTensor_(resize)(self->re, size, NULL);
+  THRealTensor_(resize)(self->im, size, NULL);
+}
+
+void THZSplitTensor_(resizeAs)(THZSplitTensor *self, THZSplitTensor *src)
+{
+  THRealTensor_(resizeAs)(self->re, src->re);
+  THRealTensor_(resizeAs)(self->im, src->im);
+}
+
+void THZSplitTensor_(resizeAsZ)(THZSplitTensor *self, THZTensor *src)
+{
+  THLongStorage *size = THZTensor_(newSizeOf)(src);
+  THZSplitTensor_(resize)(self, size);
+  THLongStorage_free(size);
+}
+
+void THZSplitTensor_(narrow)(THZSplitTensor *self, THZSplitTensor *src, int dimension_, long firstIndex_, long size_)
+{
+  if(!src)
+    src = self;
+  THRealTensor_(narrow)(self->re, src->re, dimension_, firstIndex_, size_);
+  THRealTensor_(narrow)(self->im, src->im, dimension_, firstIndex_, size_);
+}
+
+void THZSplitTensor_(select)(THZSplitTensor *self, THZSplitTensor *src, int dimension_, long sliceIndex_)
+{
+  if(!src)
+    src = self;
+  THRealTensor_(select)(self->re, src->re, dimension_, sliceIndex_);
+  THRealTensor_(select)(self->im, src->im, dimension_, sliceIndex_);
+}
+
+void THZSplitTensor_(transpose)(THZSplitTensor *self, THZSplitTensor *src, int dimension1_, int dimension2_)
+{
+  if(!src)
+    src = self;
+  THRealTensor_(transpose)(self->re, src->re, dimension1_, dimension2_);
+  THRealTensor_(transpose)(self->im, src->im, dimension1_, dimension2_);
+}
+
+void THZSplitTensor_(retain)(THZSplitTensor *self)
+{
+  THAtomicIncrementRef(&self->refcount);
+}
+
+void THZSplitTensor_(free)(THZSplitTensor *self)
+{
+  if(!self)
+    return;
+
+  if(THAtomicDecrementRef(&self->refcount))
+  {
+    THRealTensor_(free)(self->re);
+    THRealTensor_(free)(self->im);
+    THFree(self);
+  }
+}
+
+/* Contiguous destination for r_: r_ itself when possible, otherwise a
+   temporary which THZSplitTensor_(freeCopyTo) writes back */
+static THZSplitTensor *THZSplitTensor_(newContiguousResult)(THZSplitTensor *r_)
+{
+  THZSplitTensor *tensor;
+  if(THZSplitTensor_(isContiguous)(r_))
+  {
+    THZSplitTensor_(retain)(r_);
+    return r_;
+  }
+  tensor = THZSplitTensor_(new)();
+  THZSplitTensor_(resizeAs)(tensor, r_);
+  return tensor;
+}
+
+static void THZSplitTensor_(freeCopyTo)(THZSplitTensor *self, THZSplitTensor *dst)
+{
+  if(self != dst)
+    THZSplitTensor_(copy)(dst, self);
+
+  THZSplitTensor_(free)(self);
+}
+
+/**** conversion from/to interleaved tensors ****/
+void THZSplitTensor_(copy)(THZSplitTensor *self, THZSplitTensor *src)
+{
+  THRealTensor_(copy)(self->re, src->re);
+  THRealTensor_(copy)(self->im, src->im);
+}
+
+void THZSplitTensor_(copyZ)(THZSplitTensor *self, THZTensor *src)
+{
+  THRealTensor *re = self->re;
+  THRealTensor *im = self->im;
+  THArgCheck(THZSplitTensor_(nElement)(self) == THZTensor_(nElement)(src), 2, "sizes do not match");
+
+  if (THZSplitTensor_(isContiguous)(self) && THZTensor_(isContiguous)(src)) {
+    realscalar *rp = THRealTensor_(data)(re);
+    realscalar *ip = THRealTensor_(data)(im);
+    real *sp = THZTensor_(data)(src);
+    long sz = THZTensor_(nElement)(src);
+    long i;
+    #pragma omp parallel for if(sz > THZ_OMP_OVERHEAD_THZRESHOLD) private(i)
+    for (i=0; i<sz; i++) {
+      rp[i] = CREAL(sp[i]);
+      ip[i] = CIMAG(sp[i]);
+    }
+  } else {
+    THZ_TENSOR_APPLY3(realscalar, re, realscalar, im, real, src,
+                      *re_data = CREAL(*src_data);
+                      *im_data = CIMAG(*src_data););
+  }
+}
+
+void THZTensor_(copySplit)(THZTensor *self, THZSplitTensor *src)
+{
+  THRealTensor *re = src->re;
+  THRealTensor *im = src->im;
+  THArgCheck(THZTensor_(nElement)(self) == THZSplitTensor_(nElement)(src), 2, "sizes do not match");
+
+  if (THZTensor_(isContiguous)(self) && THZSplitTensor_(isContiguous)(src)) {
+    realscalar *rp = THRealTensor_(data)(re);
+    realscalar *ip = THRealTensor_(data)(im);
+    real *dp = THZTensor_(data)(self);
+    long sz = THZTensor_(nElement)(self);
+    long i;
+    #pragma omp parallel for if(sz > THZ_OMP_OVERHEAD_THZRESHOLD) private(i)
+    for (i=0; i<sz; i++)
+      dp[i] = rp[i] + ip[i]*I;
+  } else {
+    THZ_TENSOR_APPLY3(real, self, realscalar, re, realscalar, im,
+                      *self_data = *re_data + *im_data*I;);
+  }
+}
+
+/**** maths ****/
+
+/* The kernels below work on the two planes directly: every loop reads and
+   writes unit-stride real arrays, so the compiler can vectorize them
+   without any lane shuffling. */
+
+void THZSplitTensor_(fill)(THZSplitTensor *r_, real value)
+{
+  THRealTensor_(fill)(r_->re, CREAL(value));
+  THRealTensor_(fill)(r_->im, CIMAG(value));
+}
+
+void THZSplitTensor_(zero)(THZSplitTensor *r_)
+{
+  THRealTensor_(zero)(r_->re);
+  THRealTensor_(zero)(r_->im);
+}
+
+void THZSplitTensor_(add)(THZSplitTensor *r_, THZSplitTensor *t, real value)
+{
+  THZSplitTensor_(resizeAs)(r_, t);
+  THRealTensor_(add)(r_->re, t->re, CREAL(value));
+  THRealTensor_(add)(r_->im, t->im, CIMAG(value));
+}
+
+void THZSplitTensor_(mul)(THZSplitTensor *r_, THZSplitTensor *t, real value)
+{
+  THZSplitTensor *rc, *tc;
+  realscalar vr = CREAL(value), vi = CIMAG(value);
+  realscalar *rr, *ri, *tr, *ti;
+  long sz, i;
+
+  THZSplitTensor_(resizeAs)(r_, t);
+  rc = THZSplitTensor_(newContiguousResult)(r_);
+  tc = THZSplitTensor_(newContiguous)(t);
+  rr = THRealTensor_(data)(rc->re); ri = THRealTensor_(data)(rc->im);
+  tr = THRealTensor_(data)(tc->re); ti = THRealTensor_(data)(tc->im);
+  sz = THZSplitTensor_(nElement)(tc);
+
+  #pragma omp parallel for if(sz > THZ_OMP_OVERHEAD_THZRESHOLD) private(i)
+  for (i=0; i<sz; i++) {
+    realscalar a = tr[i], b = ti[i];
+    rr[i] = a*vr - b*vi;
+    ri[i] = a*vi + b*vr;
+  }
+
+  THZSplitTensor_(free)(tc);
+  THZSplitTensor_(freeCopyTo)(rc, r_);
+}
+
+void THZSplitTensor_(cadd)(THZSplitTensor *r_, THZSplitTensor *t, real value, THZSplitTensor *src)
+{
+  THZSplitTensor *rc, *tc, *sc;
+  realscalar vr = CREAL(value), vi = CIMAG(value);
+  realscalar *rr, *ri, *tr, *ti, *sr, *si;
+  long sz, i;
+
+  THArgCheck(THZSplitTensor_(nElement)(t) == THZSplitTensor_(nElement)(src), 4, "sizes do not match");
+  THZSplitTensor_(resizeAs)(r_, t);
+  rc = THZSplitTensor_(newContiguousResult)(r_);
+  tc = THZSplitTensor_(newContiguous)(t);
+  sc = THZSplitTensor_(newContiguous)(src);
+  rr = THRealTensor_(data)(rc->re); ri = THRealTensor_(data)(rc->im);
+  tr = THRealTensor_(data)(tc->re); ti = THRealTensor_(data)(tc->im);
+  sr = THRealTensor_(data)(sc->re); si = THRealTensor_(data)(sc->im);
+  sz = THZSplitTensor_(nElement)(tc);
+
+  if (vi == 0) {
+    #pragma omp parallel for if(sz > THZ_OMP_OVERHEAD_THZRESHOLD) private(i)
+    for (i=0; i<sz; i++) {
+      rr[i] = tr[i] + vr*sr[i];
+      ri[i] = ti[i] + vr*si[i];
+    }
+  } else {
+    #pragma omp parallel for if(sz > THZ_OMP_OVERHEAD_THZRESHOLD) private(i)
+    for (i=0; i<sz; i++) {
+      realscalar a = sr[i], b = si[i];
+      rr[i] = tr[i] + a*vr - b*vi;
+      ri[i] = ti[i] + a*vi + b*vr;
+    }
+  }
+
+  THZSplitTensor_(free)(tc);
+  THZSplitTensor_(free)(sc);
+  THZSplitTensor_(freeCopyTo)(rc, r_);
+}
+
+void THZSplitTensor_(cmul)(THZSplitTensor *r_, THZSplitTensor *t, THZSplitTensor *src)
+{
+  THZSplitTensor *rc, *tc, *sc;
+  realscalar *rr, *ri, *tr, *ti, *sr, *si;
+  long sz, i;
+
+  THArgCheck(THZSplitTensor_(nElement)(t) == THZSplitTensor_(nElement)(src), 3, "sizes do not match");
+  THZSplitTensor_(resizeAs)(r_, t);
+  rc = THZSplitTensor_(newContiguousResult)(r_);
+  tc = THZSplitTensor_(newContiguous)(t);
+  sc = THZSplitTensor_(newContiguous)(src);
+  rr = THRealTensor_(data)(rc->re); ri = THRealTensor_(data)(rc->im);
+  tr = THRealTensor_(data)(tc->re); ti = THRealTensor_(data)(tc->im);
+  sr = THRealTensor_(data)(sc->re); si = THRealTensor_(data)(sc->im);
+  sz = THZSplitTensor_(nElement)(tc);
+
+  #pragma omp parallel for if(sz > THZ_OMP_OVERHEAD_THZRESHOLD) private(i)
+  for (i=0; i<sz; i++) {
+    realscalar a = tr[i], b = ti[i], c = sr[i], d = si[i];
+    rr[i] = a*c - b*d;
+    ri[i] = a*d + b*c;
+  }
+
+  THZSplitTensor_(free)(tc);
+  THZSplitTensor_(free)(sc);
+  THZSplitTensor_(freeCopyTo)(rc, r_);
+}
+
+void THZSplitTensor_(addcmul)(THZSplitTensor *r_, THZSplitTensor *t, real value, THZSplitTensor *src1, THZSplitTensor *src2)
+{
+  THZSplitTensor *rc, *s1c, *s2c;
+  realscalar vr = CREAL(value), vi = CIMAG(value);
+  realscalar *rr, *ri, *ar, *ai, *br, *bi;
+  long sz, i;
+
+  THArgCheck(THZSplitTensor_(nElement)(src1) == THZSplitTensor_(nElement)(src2), 4, "sizes do not match");
+  if(r_ != t)
+  {
+    THZSplitTensor_(resizeAs)(r_, t);
+    THZSplitTensor_(copy)(r_, t);
+  }
+  THArgCheck(THZSplitTensor_(nElement)(r_) == THZSplitTensor_(nElement)(src1), 4, "sizes do not match");
+
+  rc = THZSplitTensor_(newContiguous)(r_);
+  s1c = THZSplitTensor_(newContiguous)(src1);
+  s2c = THZSplitTensor_(newContiguous)(src2);
+  rr = THRealTensor_(data)(rc->re); ri = THRealTensor_(data)(rc->im);
+  ar = THRealTensor_(data)(s1c->re); ai = THRealTensor_(data)(s1c->im);
+  br = THRealTensor_(data)(s2c->re); bi = THRealTensor_(data)(s2c->im);
+  sz = THZSplitTensor_(nElement)(rc);
+
+  #pragma omp parallel for if(sz > THZ_OMP_OVERHEAD_THZRESHOLD) private(i)
+  for (i=0; i<sz; i++) {
+    realscalar pr = ar[i]*br[i] - ai[i]*bi[i];
+    realscalar pi = ar[i]*bi[i] + ai[i]*br[i];
+    rr[i] += pr*vr - pi*vi;
+    ri[i] += pr*vi + pi*vr;
+  }
+
+  THZSplitTensor_(free)(s1c);
+  THZSplitTensor_(free)(s2c);
+  THZSplitTensor_(freeCopyTo)(rc, r_);
+}
+
+void THZSplitTensor_(conj)(THZSplitTensor *r_, THZSplitTensor *t)
+{
+  THZSplitTensor_(resizeAs)(r_, t);
+  if(r_ != t)
+    THRealTensor_(copy)(r_->re, t->re);
+  THRealTensor_(mul)(r_->im, t->im, -1);
+}
+
+void THZSplitTensor_(abs)(THRealTensor *r_, THZSplitTensor *t)
+{
+  THRealTensor *re = t->re;
+  THRealTensor *im = t->im;
+  THRealTensor_(resizeAs)(r_, re);
+  THZ_TENSOR_APPLY3(realscalar, r_, realscalar, re, realscalar, im,
+                    *r__data = CABS(*re_data + *im_data*I););
+}
+
+accreal THZSplitTensor_(sumall)(THZSplitTensor *t)
+{
+  return THRealTensor_(sumall)(t->re) + THRealTensor_(sumall)(t->im)*I;
+}
+
+#endif
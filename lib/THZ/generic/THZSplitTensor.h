@@ -0,0 +1,71 @@
+/**
+ * Copyright (c) 2015-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#ifndef THZ_GENERIC_FILE
+#define THZ_GENERIC_FILE "generic/THZSplitTensor.h"
+#else
+
+/* Planar (split) complex tensor: the real and imaginary parts live in two
+   separate real tensors of identical geometry. Views (narrow, select,
+   transpose) are applied to both halves so they always stay in sync. */
+typedef struct THZSplitTensor
+{
+    THRealTensor *re;
+    THRealTensor *im;
+    int refcount;
+} THZSplitTensor;
+
+/**** access methods ****/
+THZ_API THRealTensor *THZSplitTensor_(re)(const THZSplitTensor *self);
+THZ_API THRealTensor *THZSplitTensor_(im)(const THZSplitTensor *self);
+THZ_API int THZSplitTensor_(nDimension)(const THZSplitTensor *self);
+THZ_API long THZSplitTensor_(size)(const THZSplitTensor *self, int dim);
+THZ_API THLongStorage *THZSplitTensor_(newSizeOf)(THZSplitTensor *self);
+THZ_API long THZSplitTensor_(nElement)(const THZSplitTensor *self);
+THZ_API int THZSplitTensor_(isContiguous)(const THZSplitTensor *self);
+THZ_API int THZSplitTensor_(isSameSizeAs)(const THZSplitTensor *self, const THZSplitTensor *src);
+
+/**** creation methods ****/
+THZ_API THZSplitTensor *THZSplitTensor_(new)(void);
+THZ_API THZSplitTensor *THZSplitTensor_(newWithSize)(THLongStorage *size);
+THZ_API THZSplitTensor *THZSplitTensor_(newWithParts)(THRealTensor *re, THRealTensor *im);
+THZ_API THZSplitTensor *THZSplitTensor_(newContiguous)(THZSplitTensor *tensor);
+THZ_API THZSplitTensor *THZSplitTensor_(newNarrow)(THZSplitTensor *tensor, int dimension_, long firstIndex_, long size_);
+THZ_API THZSplitTensor *THZSplitTensor_(newSelect)(THZSplitTensor *tensor, int dimension_, long sliceIndex_);
+THZ_API THZSplitTensor *THZSplitTensor_(newTranspose)(THZSplitTensor *tensor, int dimension1_, int dimension2_);
+
+THZ_API void THZSplitTensor_(resize)(THZSplitTensor *self, THLongStorage *size);
+THZ_API void THZSplitTensor_(resizeAs)(THZSplitTensor *self, THZSplitTensor *src);
+THZ_API void THZSplitTensor_(resizeAsZ)(THZSplitTensor *self, THZTensor *src);
+
+THZ_API void THZSplitTensor_(narrow)(THZSplitTensor *self, THZSplitTensor *src, int dimension_, long firstIndex_, long size_);
+THZ_API void THZSplitTensor_(select)(THZSplitTensor *self, THZSplitTensor *src, int dimension_, long sliceIndex_);
+THZ_API void THZSplitTensor_(transpose)(THZSplitTensor *self, THZSplitTensor *src, int dimension1_, int dimension2_);
+
+THZ_API void THZSplitTensor_(retain)(THZSplitTensor *self);
+THZ_API void THZSplitTensor_(free)(THZSplitTensor *self);
+
+/**** conversion from/to interleaved tensors ****/
+THZ_API void THZSplitTensor_(copy)(THZSplitTensor *self, THZSplitTensor *src);
+THZ_API void THZSplitTensor_(copyZ)(THZSplitTensor *self, THZTensor *src);
+THZ_API void THZTensor_(copySplit)(THZTensor *self, THZSplitTensor *src);
+
+/**** maths ****/
+THZ_API void THZSplitTensor_(fill)(THZSplitTensor *r_, real value);
+THZ_API void THZSplitTensor_(zero)(THZSplitTensor *r_);
+THZ_API void THZSplitTensor_(add)(THZSplitTensor *r_, THZSplitTensor *t, real value);
+THZ_API void THZSplitTensor_(mul)(THZSplitTensor *r_, THZSplitTensor *t, real value);
+THZ_API void THZSplitTensor_(cadd)(THZSplitTensor *r_, THZSplitTensor *t, real value, THZSplitTensor *src);
+THZ_API void THZSplitTensor_(cmul)(THZSplitTensor *r_, THZSplitTensor *t, THZSplitTensor *src);
+THZ_API void THZSplitTensor_(addcmul)(THZSplitTensor *r_, THZSplitTensor *t, real value, THZSplitTensor *src1, THZSplitTensor *src2);
+THZ_API void THZSplitTensor_(conj)(THZSplitTensor *r_, THZSplitTensor *t);
+THZ_API void THZSplitTensor_(abs)(THRealTensor *r_, THZSplitTensor *t);
+THZ_API accreal THZSplitTensor_(sumall)(THZSplitTensor *t);
+
+#endif
@@ -28,7 +28,7 @@ THZStorage* THZStorage_(new)(void)
 
 THZStorage* THZStorage_(newWithSize)(long size)
 {
-  return THZStorage_(newWithAllocator)(size, &THDefaultAllocator, NULL);
+  return THZStorage_(newWithAllocator)(size, &THZAlignedAllocator, NULL);
 }
 
 THZStorage* THZStorage_(newWithAllocator)(long size,
@@ -40,6 +40,8 @@ THZStorage* THZStorage_(newWithAllocator)(long size,
   storage->size = size;
   storage->refcount = 1;
   storage->flag = THZ_STORAGE_REFCOUNTED | THZ_STORAGE_RESIZABLE | THZ_STORAGE_FREEMEM;
+  if(THZAllocator_isAligned(allocator))
+    storage->flag |= THZ_STORAGE_ALIGNED;
   storage->allocator = allocator;
   storage->allocatorContext = allocatorContext;
   return storage;
@@ -105,6 +107,21 @@ void THZStorage_(clearFlag)(THZStorage *storage, const char flag)
   storage->flag &= ~flag;
 }
 
+void THZStorage_(writeRaw)(THZStorage *storage, THFile *file)
+{
+  THFile_writeRealRaw(file, (realscalar*)storage->data, 2*storage->size);
+}
+
+long THZStorage_(readRaw)(THZStorage *storage, THFile *file)
+{
+  return THFile_readRealRaw(file, (realscalar*)storage->data, 2*storage->size)/2;
+}
+
+int THZStorage_(isAligned)(const THZStorage *storage)
+{
+  return (storage->flag & THZ_STORAGE_ALIGNED) != 0;
+}
+
 void THZStorage_(retain)(THZStorage *storage)
 {
   if(storage && (storage->flag & THZ_STORAGE_REFCOUNTED))
@@ -141,6 +158,8 @@ THZStorage* THZStorage_(newWithDataAndAllocator)(real* data, long size,
   storage->size = size;
   storage->refcount = 1;
   storage->flag = THZ_STORAGE_REFCOUNTED | THZ_STORAGE_RESIZABLE | THZ_STORAGE_FREEMEM;
+  if(THZAllocator_isAligned(allocator) && ((size_t)data % THZ_ALIGNMENT) == 0)
+    storage->flag |= THZ_STORAGE_ALIGNED;
   storage->allocator = allocator;
   storage->allocatorContext = allocatorContext;
   return storage;
@@ -148,21 +167,94 @@ THZStorage* THZStorage_(newWithDataAndAllocator)(real* data, long size,
 
 void THZStorage_(resize)(THZStorage *storage, long size)
 {
-  if(storage->flag & THZ_STORAGE_RESIZABLE)
-  {
-    storage->data = storage->allocator->realloc(
-        storage->allocatorContext,
-        storage->data,
-        sizeof(real)*size);
-    storage->size = size;
-  }
+  THArgCheck(storage->flag & THZ_STORAGE_RESIZABLE, 1, "trying to resize a storage that is not resizable");
+  storage->data = storage->allocator->realloc(
+      storage->allocatorContext,
+      storage->data,
+      sizeof(real)*size);
+  storage->size = size;
+}
+
+/* the allocator of scalar views: the context is the complex storage, whose
+   reference goes away with the view */
+static void *THZStorage_(scalarViewMalloc)(void *ctx, long size)
+{
+  THError("a scalar view of a complex storage cannot allocate");
+  return NULL;
+}
+
+static void *THZStorage_(scalarViewRealloc)(void *ctx, void *ptr, long size)
+{
+  THError("a scalar view of a complex storage cannot be resized");
+  return NULL;
+}
+
+static void THZStorage_(scalarViewFree)(void *ctx, void *ptr)
+{
+  THZStorage_(free)((THZStorage*)ctx);
+}
+
+static THAllocator THZStorage_(scalarViewAllocator) = {
+  THZStorage_(scalarViewMalloc),
+  THZStorage_(scalarViewRealloc),
+  THZStorage_(scalarViewFree)
+};
+
+THRealStorage *THZStorage_(newScalarView)(THZStorage *storage)
+{
+  THRealStorage *view;
+
+  THZStorage_(retain)(storage);
+  THZStorage_(clearFlag)(storage, THZ_STORAGE_RESIZABLE);
+  view = THRealStorage_(newWithDataAndAllocator)((realscalar*)storage->data, 2*storage->size,
+                                                 &THZStorage_(scalarViewAllocator), storage);
+  THRealStorage_(clearFlag)(view, TH_STORAGE_RESIZABLE);
+  return view;
 }
 
+/* and the allocator of complex views, whose context is the real storage */
+static void THZStorage_(pairViewFree)(void *ctx, void *ptr)
+{
+  THRealStorage_(free)((THRealStorage*)ctx);
+}
+
+static THAllocator THZStorage_(pairViewAllocator) = {
+  THZStorage_(scalarViewMalloc),
+  THZStorage_(scalarViewRealloc),
+  THZStorage_(pairViewFree)
+};
+
+THZStorage *THZStorage_(newWithScalarStorage)(THRealStorage *storage, long offset, long size)
+{
+  realscalar *data = storage->data + offset;
+  THZStorage *view;
+
+  THArgCheck(offset >= 0 && offset + 2*size <= storage->size, 2, "out of bounds");
+  THArgCheck(((size_t)data % sizeof(real)) == 0, 2, "complex numbers must be aligned on %d bytes", (int)sizeof(real));
+
+  THRealStorage_(retain)(storage);
+  THRealStorage_(clearFlag)(storage, TH_STORAGE_RESIZABLE);
+  view = THZStorage_(newWithDataAndAllocator)((real*)data, size, &THZStorage_(pairViewAllocator), storage);
+  THZStorage_(clearFlag)(view, THZ_STORAGE_RESIZABLE);
+  return view;
+}
+
+/* in parallel, over the blocks of THZTensor_(fill), so that a fresh storage
+   gets its pages from the nodes of the threads that will use them (see
+   THZNumaAllocator) */
 void THZStorage_(fill)(THZStorage *storage, real value)
 {
-  long i;
-  for(i = 0; i < storage->size; i++)
-    storage->data[i] = value;
+  long nblocks = (storage->size + THZ_VECTOR_BLOCK - 1) / THZ_VECTOR_BLOCK;
+  long b;
+  #pragma omp parallel for if(storage->size > THZ_OMP_OVERHEAD_THZRESHOLD) schedule(static) private(b)
+  for(b = 0; b < nblocks; b++)
+  {
+    real *data = storage->data + b*THZ_VECTOR_BLOCK;
+    long n = THMin(THZ_VECTOR_BLOCK, storage->size - b*THZ_VECTOR_BLOCK);
+    long i;
+    for(i = 0; i < n; i++)
+      data[i] = value;
+  }
 }
 
 void THZStorage_(set)(THZStorage *self, long idx, real value)
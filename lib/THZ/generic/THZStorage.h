@@ -14,6 +14,7 @@
 #define THZ_STORAGE_REFCOUNTED 1
 #define THZ_STORAGE_RESIZABLE  2
 #define THZ_STORAGE_FREEMEM    4
+#define THZ_STORAGE_ALIGNED    8  /* data is THZ_ALIGNMENT-aligned, also after a resize */
 
 typedef struct THZStorage
 {
@@ -54,6 +55,26 @@ THZ_API void THZStorage_(setFlag)(THZStorage *storage, const char flag);
 THZ_API void THZStorage_(clearFlag)(THZStorage *storage, const char flag);
 THZ_API void THZStorage_(retain)(THZStorage *storage);
 
+/* The 2*size real and imaginary parts of storage as a real storage sharing
+   its data. The view holds a reference on storage, which can no longer be
+   resized since that would move the data under the view. */
+THZ_API THRealStorage *THZStorage_(newScalarView)(THZStorage *storage);
+
+/* The converse: size complex numbers over the scalars of storage from
+   offset on, pairs of real and imaginary parts. The view holds a reference
+   on storage, which can no longer be resized. */
+THZ_API THZStorage *THZStorage_(newWithScalarStorage)(THRealStorage *storage, long offset, long size);
+
+/* The elements of storage as pairs of real and imaginary parts, in one
+   block through THFile: the payload of ZStorage:__write/__read. readRaw
+   fills the storage at its current size and returns the number of complex
+   numbers read. */
+THZ_API void THZStorage_(writeRaw)(THZStorage *storage, THFile *file);
+THZ_API long THZStorage_(readRaw)(THZStorage *storage, THFile *file);
+
+/* whether the THZ_STORAGE_ALIGNED flag is set */
+THZ_API int THZStorage_(isAligned)(const THZStorage *storage);
+
 /* might differ with other API (like CUDA) */
 THZ_API void THZStorage_(free)(THZStorage *storage);
 THZ_API void THZStorage_(resize)(THZStorage *storage, long size);
@@ -0,0 +1,225 @@
+/**
+ * Copyright (c) 2015-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#ifndef THZ_GENERIC_FILE
+#define THZ_GENERIC_FILE "generic/THZStorageCompress.c"
+#else
+
+/* quantizes the n scalars of src into q if that keeps them within
+   tolerance, returning the step, or returns 0 */
+static double THZStorage_(quantizeBlock)(const realscalar *src, long n, double tolerance, int16_t *q)
+{
+  realscalar amax = 0;
+  double step;
+  long i;
+
+  for(i = 0; i < n; i++)
+    if(fabs(src[i]) > amax)
+      amax = fabs(src[i]);
+  step = (double)amax/THZ_COMPRESS_QMAX;
+  if(!(step*0.5 <= tolerance))
+    return 0;
+  if(step == 0)
+    step = 1;
+
+  for(i = 0; i < n; i++)
+  {
+    q[i] = (int16_t)lrint(src[i]/step);
+    /* written as the reader computes it; fails on NaN */
+    if(!(fabs((realscalar)q[i]*(realscalar)step - src[i]) <= tolerance))
+      return 0;
+  }
+  return step;
+}
+
+/* encodes the n scalars of src in dst, which has room for
+   THZ_COMPRESS_HEADER + n*sizeof(realscalar) bytes, and returns the length
+   of the block; scratch holds 2*n*sizeof(realscalar) bytes */
+static size_t THZStorage_(encodeBlock)(const realscalar *src, long n, double tolerance,
+                                       unsigned char *dst, unsigned char *scratch)
+{
+  size_t width = sizeof(realscalar);
+  unsigned char *plane = scratch;
+  double step = 0;
+  size_t size;
+  size_t len;
+
+  memset(dst, 0, THZ_COMPRESS_HEADER);
+  if(tolerance >= 0)
+    step = THZStorage_(quantizeBlock)(src, n, tolerance, (int16_t*)scratch);
+
+  if(step > 0)
+  {
+    width = sizeof(int16_t);
+    plane = scratch + n*width;
+    THZCompress_shuffle(scratch, n, width, plane);
+    dst[0] |= THZ_COMPRESS_QUANTIZED;
+    memcpy(dst+8, &step, sizeof(double));
+  }
+  else
+    THZCompress_shuffle((const unsigned char*)src, n, width, plane);
+
+  size = n*width;
+  len = THZCompress_encode(plane, size, dst+THZ_COMPRESS_HEADER, size-1);
+  if(len == 0)
+  {
+    dst[0] |= THZ_COMPRESS_STORED;
+    memcpy(dst+THZ_COMPRESS_HEADER, plane, size);
+    len = size;
+  }
+  return THZ_COMPRESS_HEADER + len;
+}
+
+/* the inverse of encodeBlock; -1 if src is not a block of n scalars */
+static int THZStorage_(decodeBlock)(const unsigned char *src, size_t len, long n,
+                                    realscalar *dst, unsigned char *scratch)
+{
+  int quantized, stored;
+  size_t width, size;
+  const unsigned char *plane;
+  double step;
+
+  if(len < THZ_COMPRESS_HEADER)
+    return -1;
+  quantized = (src[0] & THZ_COMPRESS_QUANTIZED) != 0;
+  stored = (src[0] & THZ_COMPRESS_STORED) != 0;
+  memcpy(&step, src+8, sizeof(double));
+  width = (quantized ? sizeof(int16_t) : sizeof(realscalar));
+  size = n*width;
+
+  src += THZ_COMPRESS_HEADER;
+  len -= THZ_COMPRESS_HEADER;
+  if(stored)
+  {
+    if(len != size)
+      return -1;
+    plane = src;
+  }
+  else
+  {
+    if(THZCompress_decode(src, len, scratch, size))
+      return -1;
+    plane = scratch;
+  }
+
+  if(quantized)
+  {
+    int16_t *q = (int16_t*)(scratch + size);
+    long i;
+
+    THZCompress_unshuffle(plane, n, width, (unsigned char*)q);
+    for(i = 0; i < n; i++)
+      dst[i] = (realscalar)q[i]*(realscalar)step;
+  }
+  else
+    THZCompress_unshuffle(plane, n, width, (unsigned char*)dst);
+  return 0;
+}
+
+void THZStorage_(writeCompressed)(THZStorage *storage, THFile *file, double tolerance)
+{
+  realscalar *data = (realscalar*)storage->data;
+  const long n = 2*storage->size;
+  const long block = 2*THZ_COMPRESS_BLOCK;
+  const long nblocks = (n + block - 1)/block;
+  const size_t capacity = THZ_COMPRESS_HEADER + block*sizeof(realscalar);
+  unsigned char *buffer = THAlloc(THZ_COMPRESS_GROUP*capacity);
+  size_t length[THZ_COMPRESS_GROUP];
+  long first, b;
+
+  THFile_writeLongScalar(file, THZ_COMPRESS_BLOCK);
+  for(first = 0; first < nblocks; first += THZ_COMPRESS_GROUP)
+  {
+    long count = (nblocks - first < THZ_COMPRESS_GROUP ? nblocks - first : THZ_COMPRESS_GROUP);
+
+    #pragma omp parallel if(count > 1)
+    {
+      unsigned char *scratch = THAlloc(2*block*sizeof(realscalar));
+
+      #pragma omp for schedule(dynamic) private(b)
+      for(b = 0; b < count; b++)
+      {
+        long start = (first+b)*block;
+        long len = (n - start < block ? n - start : block);
+        length[b] = THZStorage_(encodeBlock)(data+start, len, tolerance, buffer+b*capacity, scratch);
+      }
+      THFree(scratch);
+    }
+
+    for(b = 0; b < count; b++)
+    {
+      THFile_writeLongScalar(file, (long)length[b]);
+      THFile_writeByteRaw(file, buffer+b*capacity, length[b]);
+    }
+  }
+  THFree(buffer);
+}
+
+void THZStorage_(readCompressed)(THZStorage *storage, THFile *file)
+{
+  realscalar *data = (realscalar*)storage->data;
+  const long n = 2*storage->size;
+  long block = THFile_readLongScalar(file);
+  long nblocks, first, b;
+  size_t capacity;
+  size_t length[THZ_COMPRESS_GROUP];
+  unsigned char *buffer;
+
+  if(block <= 0 || block > (1L << 24))
+    THError("corrupt compressed storage: blocks of %ld elements", block);
+  block *= 2;
+  nblocks = (n + block - 1)/block;
+  capacity = THZ_COMPRESS_HEADER + block*sizeof(realscalar);
+  buffer = THAlloc(THZ_COMPRESS_GROUP*capacity);
+
+  for(first = 0; first < nblocks; first += THZ_COMPRESS_GROUP)
+  {
+    long count = (nblocks - first < THZ_COMPRESS_GROUP ? nblocks - first : THZ_COMPRESS_GROUP);
+    int failed = 0;
+
+    for(b = 0; b < count; b++)
+    {
+      long len = THFile_readLongScalar(file);
+      if(len < 0 || (size_t)len > capacity)
+      {
+        THFree(buffer);
+        THError("corrupt compressed storage: block of %ld bytes", len);
+      }
+      length[b] = len;
+      if(THFile_readByteRaw(file, buffer+b*capacity, length[b]) != length[b])
+      {
+        THFree(buffer);
+        THError("read error: compressed storage ends early");
+      }
+    }
+
+    #pragma omp parallel if(count > 1) reduction(|:failed)
+    {
+      unsigned char *scratch = THAlloc(2*block*sizeof(realscalar));
+
+      #pragma omp for schedule(dynamic) private(b)
+      for(b = 0; b < count; b++)
+      {
+        long start = (first+b)*block;
+        long len = (n - start < block ? n - start : block);
+        failed |= THZStorage_(decodeBlock)(buffer+b*capacity, length[b], len, data+start, scratch) != 0;
+      }
+      THFree(scratch);
+    }
+
+    if(failed)
+    {
+      THFree(buffer);
+      THError("corrupt compressed storage");
+    }
+  }
+  THFree(buffer);
+}
+
+#endif
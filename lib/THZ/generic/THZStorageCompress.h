@@ -0,0 +1,24 @@
+/**
+ * Copyright (c) 2015-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#ifndef THZ_GENERIC_FILE
+#define THZ_GENERIC_FILE "generic/THZStorageCompress.h"
+#else
+
+/* Compressed storage payloads (block layout in THZCompress.h).
+
+   With tolerance < 0 the compression is lossless. Otherwise a block is
+   quantized to 16 bits when that moves no real or imaginary part by more
+   than tolerance, and kept exact when it would. readCompressed fills the
+   storage at its current size, and raises an error on a short or corrupt
+   payload. */
+THZ_API void THZStorage_(writeCompressed)(THZStorage *storage, THFile *file, double tolerance);
+THZ_API void THZStorage_(readCompressed)(THZStorage *storage, THFile *file);
+
+#endif
@@ -204,6 +204,61 @@ THZTensor *THZTensor_(newContiguous)(THZTensor *self)
   }
 }
 
+/* a contiguous tensor of the given sizes (trailing ones <= 0 are dropped)
+   on a storage from THZCachingAllocator */
+static THZTensor *THZTensor_(newScratch)(int nDimension, long *size)
+{
+  THZStorage *storage;
+  THZTensor *self;
+  long n = 1;
+  int d;
+
+  for(d = 0; d < nDimension && size[d] > 0; d++)
+    n *= size[d];
+  storage = THZStorage_(newWithAllocator)(d > 0 ? n : 0, &THZCachingAllocator, NULL);
+
+  self = THAlloc(sizeof(THZTensor));
+  THZTensor_(rawInit)(self);
+  THZTensor_(rawSet)(self, storage, 0, nDimension, size, NULL);
+  THZStorage_(free)(storage);
+
+  return self;
+}
+
+THZTensor *THZTensor_(newScratchWithSize1d)(long size0)
+{
+  return THZTensor_(newScratchWithSize4d)(size0, -1, -1, -1);
+}
+
+THZTensor *THZTensor_(newScratchWithSize2d)(long size0, long size1)
+{
+  return THZTensor_(newScratchWithSize4d)(size0, size1, -1, -1);
+}
+
+THZTensor *THZTensor_(newScratchWithSize4d)(long size0, long size1, long size2, long size3)
+{
+  long size[4] = {size0, size1, size2, size3};
+  return THZTensor_(newScratch)(4, size);
+}
+
+THZTensor *THZTensor_(newScratchClone)(THZTensor *self)
+{
+  THZTensor *tensor = THZTensor_(newScratch)(self->nDimension, self->size);
+  THZTensor_(copy)(tensor, self);
+  return tensor;
+}
+
+THZTensor *THZTensor_(newScratchContiguous)(THZTensor *self)
+{
+  if(!THZTensor_(isContiguous)(self))
+    return THZTensor_(newScratchClone)(self);
+  else
+  {
+    THZTensor_(retain)(self);
+    return self;
+  }
+}
+
 THZTensor *THZTensor_(newSelect)(THZTensor *tensor, int dimension_, long sliceIndex_)
 {
   THZTensor *self = THZTensor_(newWithTensor)(tensor);
@@ -218,6 +273,78 @@ THZTensor *THZTensor_(newNarrow)(THZTensor *tensor, int dimension_, long firstIn
   return self;
 }
 
+static void THZTensor_(partView)(THRealTensor *r_, THZTensor *tensor, int part)
+{
+  THRealStorage *storage;
+  THLongStorage *size, *stride;
+  int d;
+
+  if(!tensor->storage)
+  {
+    THRealTensor_(setStorage)(r_, NULL, 0, NULL, NULL);
+    return;
+  }
+
+  storage = THZStorage_(newScalarView)(tensor->storage);
+  size = THLongStorage_newWithSize(tensor->nDimension);
+  stride = THLongStorage_newWithSize(tensor->nDimension);
+  for(d = 0; d < tensor->nDimension; d++)
+  {
+    size->data[d] = tensor->size[d];
+    stride->data[d] = 2*tensor->stride[d];
+  }
+  THRealTensor_(setStorage)(r_, storage, 2*tensor->storageOffset + part, size, stride);
+  THLongStorage_free(size);
+  THLongStorage_free(stride);
+  THRealStorage_(free)(storage);
+}
+
+void THZTensor_(reView)(THRealTensor *r_, THZTensor *tensor)
+{
+  THZTensor_(partView)(r_, tensor, 0);
+}
+
+void THZTensor_(imView)(THRealTensor *r_, THZTensor *tensor)
+{
+  THZTensor_(partView)(r_, tensor, 1);
+}
+
+static THZTensor *THZTensor_(newViewOfScalars)(THRealTensor *src)
+{
+  THZStorage *storage;
+  THZTensor *self;
+  long *size, *stride;
+  int d, nDimension = src->nDimension - 1;
+
+  THArgCheck(nDimension >= 1 && src->size[nDimension] == 2 && THRealTensor_(isContiguous)(src), 1,
+             "a contiguous tensor of at least two dimensions, the last of size 2, expected");
+
+  size = THAlloc(sizeof(long)*nDimension);
+  stride = THAlloc(sizeof(long)*nDimension);
+  for(d = 0; d < nDimension; d++)
+  {
+    size[d] = src->size[d];
+    stride[d] = src->stride[d]/2;
+  }
+  storage = THZStorage_(newWithScalarStorage)(src->storage, src->storageOffset,
+                                              THRealTensor_(nElement)(src)/2);
+  self = THZTensor_(new)();
+  THZTensor_(rawSet)(self, storage, 0, nDimension, size, stride);
+  THZStorage_(free)(storage);
+  THFree(size);
+  THFree(stride);
+  return self;
+}
+
+#if defined(THZ_REAL_IS_FLOAT)
+THZTensor *THZTensor_(newViewOfFloat)(THFloatTensor *src)
+#else
+THZTensor *THZTensor_(newViewOfDouble)(THDoubleTensor *src)
+#endif
+{
+  return THZTensor_(newViewOfScalars)(src);
+}
+
 THZTensor *THZTensor_(newTranspose)(THZTensor *tensor, int dimension1_, int dimension2_)
 {
   THZTensor *self = THZTensor_(newWithTensor)(tensor);
@@ -541,6 +668,12 @@ int THZTensor_(isContiguous)(const THZTensor *self)
   return 1;
 }
 
+int THZTensor_(isAligned)(const THZTensor *self)
+{
+  return self->storage && THZStorage_(isAligned)(self->storage) &&
+    ((self->storageOffset*sizeof(real)) % THZ_ALIGNMENT) == 0;
+}
+
 int THZTensor_(isSameSizeAs)(const THZTensor *self, const THZTensor* src)
 {
   int d;
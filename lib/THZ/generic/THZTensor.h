@@ -78,6 +78,28 @@ THZ_API THZTensor *THZTensor_(newNarrow)(THZTensor *tensor, int dimension_, long
 THZ_API THZTensor *THZTensor_(newTranspose)(THZTensor *tensor, int dimension1_, int dimension2_);
 THZ_API THZTensor *THZTensor_(newUnfold)(THZTensor *tensor, int dimension_, long size_, long step_);
 
+/* for temporaries: as newWithSize4d, newClone and newContiguous, with the
+   storage taken from THZCachingAllocator */
+THZ_API THZTensor *THZTensor_(newScratchWithSize1d)(long size0_);
+THZ_API THZTensor *THZTensor_(newScratchWithSize2d)(long size0_, long size1_);
+THZ_API THZTensor *THZTensor_(newScratchWithSize4d)(long size0_, long size1_, long size2_, long size3_);
+THZ_API THZTensor *THZTensor_(newScratchClone)(THZTensor *self);
+THZ_API THZTensor *THZTensor_(newScratchContiguous)(THZTensor *tensor);
+
+/* set r_ to the real (imaginary) parts of tensor: a view with twice its
+   strides on a scalar view of its storage, see THZStorage_(newScalarView) */
+THZ_API void THZTensor_(reView)(THRealTensor *r_, THZTensor *tensor);
+THZ_API void THZTensor_(imView)(THRealTensor *r_, THZTensor *tensor);
+
+/* the converse: a complex view of a contiguous real tensor of matching
+   precision whose last dimension has size 2, sharing its storage (see
+   THZStorage_(newWithScalarStorage)) */
+#if defined(THZ_REAL_IS_FLOAT)
+THZ_API THZTensor *THZTensor_(newViewOfFloat)(THFloatTensor *src);
+#else
+THZ_API THZTensor *THZTensor_(newViewOfDouble)(THDoubleTensor *src);
+#endif
+
 THZ_API void THZTensor_(resize)(THZTensor *tensor, THLongStorage *size, THLongStorage *stride);
 THZ_API void THZTensor_(resizeAs)(THZTensor *tensor, THZTensor *src);
 THZ_API void THZTensor_(resize1d)(THZTensor *tensor, long size0_);
@@ -112,6 +134,8 @@ THZ_API void THZTensor_(squeeze)(THZTensor *self, THZTensor *src);
 THZ_API void THZTensor_(squeeze1d)(THZTensor *self, THZTensor *src, int dimension_);
 
 THZ_API int THZTensor_(isContiguous)(const THZTensor *self);
+/* whether the first element lies on a THZ_ALIGNMENT boundary of an aligned storage */
+THZ_API int THZTensor_(isAligned)(const THZTensor *self);
 THZ_API int THZTensor_(isSameSizeAs)(const THZTensor *self, const THZTensor *src);
 THZ_API long THZTensor_(nElement)(const THZTensor *self);
 
@@ -606,8 +606,8 @@ void THZTensor_(conv2DRevger)(THZTensor *r_, real beta, real alpha, THZTensor *t
   THArgCheck(srow >= 1, 5, "Stride should be a positive integer");
   THArgCheck(scol >= 1, 6, "Stride should be a positive integer");
 
-  input = THZTensor_(newContiguous)(t_);
-  kernel = THZTensor_(newContiguous)(k_);
+  input = THZTensor_(newScratchContiguous)(t_);
+  kernel = THZTensor_(newScratchContiguous)(k_);
 
   nInputPlane = input->size[0];
   istride0    = input->stride[0];
@@ -713,8 +713,8 @@ void THZTensor_(conv2DRevgerm)(THZTensor *r_, real beta, real alpha, THZTensor *
   THArgCheck(srow >= 1, 5, "Stride should be a positive integer");
   THArgCheck(scol >= 1, 6, "Stride should be a positive integer");
 
-  input = THZTensor_(newContiguous)(t_);
-  kernel = THZTensor_(newContiguous)(k_);
+  input = THZTensor_(newScratchContiguous)(t_);
+  kernel = THZTensor_(newScratchContiguous)(k_);
 
   istride0    = input->stride[0];
   istride1    = input->stride[1];
@@ -827,8 +827,8 @@ void THZTensor_(conv2Dger)(THZTensor *r_, real beta, real alpha, THZTensor *t_,
   THArgCheck(*vf == 'V' || *vf == 'F', 7, "type of convolution can 'V' or 'F'");
   THArgCheck(*xc == 'C' || *xc == 'X', 7, "type of convolution can 'X' or 'C'");
 
-  input = THZTensor_(newContiguous)(t_);
-  kernel = THZTensor_(newContiguous)(k_);
+  input = THZTensor_(newScratchContiguous)(t_);
+  kernel = THZTensor_(newScratchContiguous)(k_);
 
   nInputPlane = input->size[0];
   istride0    = input->stride[0];
@@ -959,9 +959,9 @@ void THZTensor_(conv2Dmv)(THZTensor *r_, real beta, real alpha, THZTensor *t_, T
   THArgCheck(*vf == 'V' || *vf == 'F', 7, "type of convolution can 'V' or 'F'");
   THArgCheck(*xc == 'C' || *xc == 'X', 7, "type of convolution can 'X' or 'C'");
 
-  input = THZTensor_(newContiguous)(t_);
+  input = THZTensor_(newScratchContiguous)(t_);
   if (!(k_->stride[3] == 1) || !(k_->stride[2] == k_->size[3])) {
-    kernel = THZTensor_(newContiguous)(k_);
+    kernel = THZTensor_(newScratchContiguous)(k_);
   } else {
     THZTensor_(retain)(k_);
     kernel = k_;
@@ -1069,6 +1069,164 @@ void THZTensor_(conv2Dmv)(THZTensor *r_, real beta, real alpha, THZTensor *t_, T
   THZTensor_(free)(kernel);
 }
 
+/*
+  Frequency-domain path for stride 1 convolutions. Spatial sizes are given
+  as (depth, rows, cols), depth being 1 in 2D. Every dimension is zero-padded
+  to a 2,3,5-smooth length covering the full linear convolution; input and
+  kernel planes are transformed once, the spectra are combined by one small
+  complex GEMM per frequency over the planes, and the outputs are transformed
+  back, cropped and accumulated as output += alpha * conv(input, kernel).
+  Output planes are processed in chunks so the kernel spectra stay bounded.
+*/
+#define THZ_CONV_FFT_MIN_KSIZE 5
+#define THZ_CONV_FFT_CHUNK_BYTES (1L << 27)
+
+static long THZTensor_(convFFTSize)(long n)
+{
+  for(;; n++)
+  {
+    long m = n;
+    while(m % 2 == 0)
+      m /= 2;
+    while(m % 3 == 0)
+      m /= 3;
+    while(m % 5 == 0)
+      m /= 5;
+    if(m == 1)
+      return n;
+  }
+}
+
+/* rough operation counts, in complex multiply-adds, of both paths */
+static int THZTensor_(convPreferFFT)(long nbatch, long nInputPlane, long nOutputPlane,
+                                     const long *isize, const long *ksize, int ndim, const char *vf)
+{
+  double direct = (double)nbatch * nInputPlane * nOutputPlane;
+  double P = 1, spectral;
+  int d;
+
+  for(d = 3-ndim; d < 3; d++)
+  {
+    long osize = (*vf == 'F') ? isize[d] + ksize[d] - 1 : isize[d] - ksize[d] + 1;
+    if(ksize[d] < THZ_CONV_FFT_MIN_KSIZE)
+      return 0;
+    direct *= (double)osize * ksize[d];
+    P *= THZTensor_(convFFTSize)(isize[d] + ksize[d] - 1);
+  }
+  spectral = P * log(P) / log(2.0) * (nbatch*nInputPlane + nOutputPlane*nInputPlane + nbatch*nOutputPlane)
+           + P * nbatch * nInputPlane * nOutputPlane;
+  return spectral < direct;
+}
+
+static void THZTensor_(convFFTAcc)(real *output_data, real alpha,
+                                   real *input_data, long nbatch, long nInputPlane, const long *isize,
+                                   real *weight_data, long kstride0, long kstride1, long nOutputPlane, const long *ksize,
+                                   const char *vf, const char *xc)
+{
+  long psize[3], osize[3], offset[3];
+  long P = 1, inArea = 1, kArea = 1, outArea = 1;
+  long nIn = nbatch*nInputPlane;
+  long chunk, o0, j, f;
+  THZTensor *ispec, *kspec, *ospec;
+  real *idata, *kdata, *odata;
+  int d;
+
+  for(d = 0; d < 3; d++)
+  {
+    psize[d] = THZTensor_(convFFTSize)(isize[d] + ksize[d] - 1);
+    osize[d] = (*vf == 'F') ? isize[d] + ksize[d] - 1 : isize[d] - ksize[d] + 1;
+    offset[d] = (*vf == 'F') ? 0 : ksize[d] - 1;
+    P *= psize[d];
+    inArea *= isize[d];
+    kArea *= ksize[d];
+    outArea *= osize[d];
+  }
+
+  chunk = THZ_CONV_FFT_CHUNK_BYTES / ((long)sizeof(real) * P * (nInputPlane + nbatch));
+  chunk = THMax(1, THMin(chunk, nOutputPlane));
+
+  /* planes are the fastest dimension of the spectra, so that the values of
+     one frequency form the matrices the GEMMs work on */
+  ispec = THZTensor_(newScratchWithSize4d)(psize[0], psize[1], psize[2], nIn);
+  kspec = THZTensor_(newScratchWithSize4d)(psize[0], psize[1], psize[2], chunk*nInputPlane);
+  ospec = THZTensor_(newScratchWithSize4d)(psize[0], psize[1], psize[2], nbatch*chunk);
+
+  THZTensor_(zero)(ispec);
+  idata = THZTensor_(data)(ispec);
+#pragma omp parallel for private(j)
+  for(j = 0; j < nIn; j++)
+  {
+    real *src = input_data + j*inArea;
+    long z, y, x;
+    for(z = 0; z < isize[0]; z++)
+      for(y = 0; y < isize[1]; y++)
+        for(x = 0; x < isize[2]; x++)
+          idata[((z*psize[1] + y)*psize[2] + x)*nIn + j] = *src++;
+  }
+  for(d = 0; d < 3; d++)
+    THZTensor_(fft)(ispec, ispec, d);
+
+  for(o0 = 0; o0 < nOutputPlane; o0 += chunk)
+  {
+    long co = THMin(chunk, nOutputPlane - o0);
+    long nK = co*nInputPlane;
+    long nOut = nbatch*co;
+
+    THZTensor_(resize4d)(kspec, psize[0], psize[1], psize[2], nK);
+    THZTensor_(resize4d)(ospec, psize[0], psize[1], psize[2], nOut);
+
+    /* correlations are convolutions with the flipped kernel */
+    THZTensor_(zero)(kspec);
+    kdata = THZTensor_(data)(kspec);
+#pragma omp parallel for private(j)
+    for(j = 0; j < nK; j++)
+    {
+      real *w = weight_data + (o0 + j/nInputPlane)*kstride0 + (j%nInputPlane)*kstride1;
+      long z, y, x;
+      for(z = 0; z < ksize[0]; z++)
+        for(y = 0; y < ksize[1]; y++)
+          for(x = 0; x < ksize[2]; x++)
+          {
+            real v = *w++;
+            if(*xc == 'X')
+              kdata[(((ksize[0]-1-z)*psize[1] + ksize[1]-1-y)*psize[2] + ksize[2]-1-x)*nK + j] = v;
+            else
+              kdata[((z*psize[1] + y)*psize[2] + x)*nK + j] = v;
+          }
+    }
+    for(d = 0; d < 3; d++)
+      THZTensor_(fft)(kspec, kspec, d);
+
+    /* out[b][o] = sum_i kernel[o][i] * in[b][i], for each frequency */
+    odata = THZTensor_(data)(ospec);
+#pragma omp parallel for private(f)
+    for(f = 0; f < P; f++)
+      THZBlas_(gemm)('t', 'n', co, nbatch, nInputPlane,
+                     1, kdata + f*nK, nInputPlane,
+                     idata + f*nIn, nInputPlane,
+                     0, odata + f*nOut, co);
+
+    for(d = 0; d < 3; d++)
+      THZTensor_(ifft)(ospec, ospec, d);
+
+#pragma omp parallel for private(j)
+    for(j = 0; j < nOut; j++)
+    {
+      long b = j / co, o = j % co;
+      real *dst = output_data + (b*nOutputPlane + o0 + o)*outArea;
+      long z, y, x;
+      for(z = 0; z < osize[0]; z++)
+        for(y = 0; y < osize[1]; y++)
+          for(x = 0; x < osize[2]; x++)
+            *dst++ += alpha * odata[(((z+offset[0])*psize[1] + y+offset[1])*psize[2] + x+offset[2])*nOut + j];
+    }
+  }
+
+  THZTensor_(free)(ispec);
+  THZTensor_(free)(kspec);
+  THZTensor_(free)(ospec);
+}
+
 
 /*
   3D input, 4D kernel, 3D output
@@ -1081,6 +1239,7 @@ void THZTensor_(conv2Dmm)(THZTensor *r_, real beta, real alpha, THZTensor *t_, T
   long nKernelRows, nKernelCols;
   long nOutputPlane, nOutputRows, nOutputCols;
   long kstride0, kstride1;
+  long isize[3], ksize[3];
   THZTensor *input;
   THZTensor* kernel;
   long nbatch;
@@ -1097,9 +1256,9 @@ void THZTensor_(conv2Dmm)(THZTensor *r_, real beta, real alpha, THZTensor *t_, T
   THArgCheck(*vf == 'V' || *vf == 'F', 7, "type of convolution can 'V' or 'F'");
   THArgCheck(*xc == 'C' || *xc == 'X', 7, "type of convolution can 'X' or 'C'");
 
-  input = THZTensor_(newContiguous)(t_);
+  input = THZTensor_(newScratchContiguous)(t_);
   if (!(k_->stride[3] == 1) || !(k_->stride[2] == k_->size[3])) {
-    kernel = THZTensor_(newContiguous)(k_);
+    kernel = THZTensor_(newScratchContiguous)(k_);
   } else {
     THZTensor_(retain)(k_);
     kernel = k_;
@@ -1167,6 +1326,20 @@ void THZTensor_(conv2Dmm)(THZTensor *r_, real beta, real alpha, THZTensor *t_, T
     }
   }
 
+  isize[0] = 1; isize[1] = nInputRows; isize[2] = nInputCols;
+  ksize[0] = 1; ksize[1] = nKernelRows; ksize[2] = nKernelCols;
+  if (srow == 1 && scol == 1 &&
+      THZTensor_(convPreferFFT)(nbatch, nInputPlane, nOutputPlane, isize, ksize, 2, vf))
+  {
+    THZTensor_(convFFTAcc)(output_data, alpha,
+                          input_data, nbatch, nInputPlane, isize,
+                          weight_data, kstride0, kstride1, nOutputPlane, ksize,
+                          vf, xc);
+    THZTensor_(free)(input);
+    THZTensor_(free)(kernel);
+    return;
+  }
+
 #pragma omp parallel for private(p)
   for(p=0; p < nbatch; p++)
   {
@@ -1244,8 +1417,8 @@ void THZTensor_(conv2Dmul)(THZTensor *r_, real beta, real alpha, THZTensor *t_,
   THArgCheck(srow >= 1, 5, "Stride should be a positive integer");
   THArgCheck(scol >= 1, 6, "Stride should be a positive integer");
 
-  input = THZTensor_(newContiguous)(t_);
-  kernel = THZTensor_(newContiguous)(k_);
+  input = THZTensor_(newScratchContiguous)(t_);
+  kernel = THZTensor_(newScratchContiguous)(k_);
 
   nInputRows  = input->size[0];
   nInputCols  = input->size[1];
@@ -1303,8 +1476,8 @@ void THZTensor_(conv2Dcmul)(THZTensor *r_, real beta, real alpha, THZTensor *t_,
   THArgCheck(srow >= 1, 5, "Stride should be a positive integer");
   THArgCheck(scol >= 1, 6, "Stride should be a positive integer");
 
-  input = THZTensor_(newContiguous)(t_);
-  kernel = THZTensor_(newContiguous)(k_);
+  input = THZTensor_(newScratchContiguous)(t_);
+  kernel = THZTensor_(newScratchContiguous)(k_);
 
   istride0    = input->stride[0];
   nInputPlane = input->size[0];
@@ -1382,8 +1555,8 @@ void THZTensor_(conv2Dmap)(THZTensor *r_, real beta, real alpha, THZTensor *t_,
   THArgCheck(srow >= 1, 6, "Stride should be a positive integer");
   THArgCheck(scol >= 1, 7, "Stride should be a positive integer");
 
-  input = THZTensor_(newContiguous)(t_);
-  kernel = THZTensor_(newContiguous)(k_);
+  input = THZTensor_(newScratchContiguous)(t_);
+  kernel = THZTensor_(newScratchContiguous)(k_);
 
   istride0    = input->stride[0];
   nInputPlane = input->size[0];
@@ -1470,8 +1643,8 @@ void THZTensor_(conv3DRevger)(THZTensor *r_, real beta, real alpha, THZTensor *t
   THArgCheck(srow >= 1, 6, "Stride should be a positive integer");
   THArgCheck(scol >= 1, 7, "Stride should be a positive integer");
 
-  input = THZTensor_(newContiguous)(t_);
-  kernel = THZTensor_(newContiguous)(k_);
+  input = THZTensor_(newScratchContiguous)(t_);
+  kernel = THZTensor_(newScratchContiguous)(k_);
 
   nInputPlane = input->size[0];
   istride0    = input->stride[0];
@@ -1559,8 +1732,8 @@ void THZTensor_(conv3Dger)(THZTensor *r_, real beta, real alpha, THZTensor *t_,
   THArgCheck(*vf == 'V' || *vf == 'F', 8, "type of convolution can 'V' or 'F'");
   THArgCheck(*xc == 'C' || *xc == 'X', 8, "type of convolution can 'X' or 'C'");
 
-  input = THZTensor_(newContiguous)(t_);
-  kernel = THZTensor_(newContiguous)(k_);
+  input = THZTensor_(newScratchContiguous)(t_);
+  kernel = THZTensor_(newScratchContiguous)(k_);
 
   nInputPlane = input->size[0];
   istride0    = input->stride[0];
@@ -1635,6 +1808,7 @@ void THZTensor_(conv3Dmv)(THZTensor *r_, real beta, real alpha, THZTensor *t_, T
   long nKernelDepth, nKernelRows, nKernelCols;
   long nOutputPlane, nOutputDepth, nOutputRows, nOutputCols;
   long istride0, kstride0, kstride1;
+  long isize[3], ksize[3];
   THZTensor *input;
   THZTensor *kernel;
   real *input_data;
@@ -1651,9 +1825,9 @@ void THZTensor_(conv3Dmv)(THZTensor *r_, real beta, real alpha, THZTensor *t_, T
   THArgCheck(*vf == 'V' || *vf == 'F', 8, "type of convolution can 'V' or 'F'");
   THArgCheck(*xc == 'C' || *xc == 'X', 8, "type of convolution can 'X' or 'C'");
 
-  input = THZTensor_(newContiguous)(t_);
+  input = THZTensor_(newScratchContiguous)(t_);
   if (!(k_->stride[4] == 1) || !(k_->stride[3] == k_->size[4])) {
-    kernel = THZTensor_(newContiguous)(k_);
+    kernel = THZTensor_(newScratchContiguous)(k_);
   } else {
     THZTensor_(retain)(k_);
     kernel = k_;
@@ -1693,6 +1867,20 @@ void THZTensor_(conv3Dmv)(THZTensor *r_, real beta, real alpha, THZTensor *t_, T
   weight_data = THZTensor_(data)(kernel);
   output_data = THZTensor_(data)(r_);
 
+  isize[0] = nInputDepth; isize[1] = nInputRows; isize[2] = nInputCols;
+  ksize[0] = nKernelDepth; ksize[1] = nKernelRows; ksize[2] = nKernelCols;
+  if (sdepth == 1 && srow == 1 && scol == 1 &&
+      THZTensor_(convPreferFFT)(1, nInputPlane, nOutputPlane, isize, ksize, 3, vf))
+  {
+    THZTensor_(convFFTAcc)(output_data, alpha,
+                          input_data, 1, nInputPlane, isize,
+                          weight_data, kstride0, kstride1, nOutputPlane, ksize,
+                          vf, xc);
+    THZTensor_(free)(input);
+    THZTensor_(free)(kernel);
+    return;
+  }
+
   for(k = 0; k < nOutputPlane; k++)
   {
     for(i = 0; i < nInputPlane; i++)
@@ -1746,8 +1934,8 @@ void THZTensor_(conv3Dmul)(THZTensor *r_, real beta, real alpha, THZTensor *t_,
   THArgCheck(*vf == 'V' || *vf == 'F', 8, "type of convolution can 'V' or 'F'");
   THArgCheck(*xc == 'C' || *xc == 'X', 8, "type of convolution can 'X' or 'C'");
 
-  input = THZTensor_(newContiguous)(t_);
-  kernel = THZTensor_(newContiguous)(k_);
+  input = THZTensor_(newScratchContiguous)(t_);
+  kernel = THZTensor_(newScratchContiguous)(k_);
 
   nInputDepth = input->size[0];
   nInputRows  = input->size[1];
@@ -1812,8 +2000,8 @@ void THZTensor_(conv3Dcmul)(THZTensor *r_, real beta, real alpha, THZTensor *t_,
   THArgCheck(*vf == 'V' || *vf == 'F', 7, "type of convolution can 'V' or 'F'");
   THArgCheck(*xc == 'C' || *xc == 'X', 7, "type of convolution can 'X' or 'C'");
 
-  input = THZTensor_(newContiguous)(t_);
-  kernel = THZTensor_(newContiguous)(k_);
+  input = THZTensor_(newScratchContiguous)(t_);
+  kernel = THZTensor_(newScratchContiguous)(k_);
 
   istride0    = input->stride[0];
   nInputPlane = input->size[0];
@@ -1899,8 +2087,8 @@ void THZTensor_(conv3Dmap)(THZTensor *r_, real beta, real alpha, THZTensor *t_,
   THArgCheck(*vf == 'V' || *vf == 'F', 8, "type of convolution can 'V' or 'F'");
   THArgCheck(*xc == 'C' || *xc == 'X', 8, "type of convolution can 'X' or 'C'");
 
-  input = THZTensor_(newContiguous)(t_);
-  kernel = THZTensor_(newContiguous)(k_);
+  input = THZTensor_(newScratchContiguous)(t_);
+  kernel = THZTensor_(newScratchContiguous)(k_);
 
   istride0    = input->stride[0];
   nInputPlane = input->size[0];
@@ -13,7 +13,7 @@
 
 void THZTensor_(copy)(THZTensor *tensor, THZTensor *src)
 {
-  TH_TENSOR_APPLY2(real, tensor, real, src, *tensor_data = (real)(*src_data);)
+  THZ_TENSOR_APPLY2(real, tensor, real, src, *tensor_data = (real)(*src_data);)
 }
 
 #define IMPLEMENT_THZTensor_COPY(TYPENAMESRC, TYPE_SRC)			\
@@ -36,13 +36,12 @@ void THZTensor_(copy##TYPENAMESRC)(THZTensor *tensor, TH##TYPENAMESRC##Tensor *s
 									\
 if (copyimag == 1) {							\
   src = TH##TYPENAMESRC##Tensor_newContiguous(src);			\
-  TYPE_SRC *src_data = TH##TYPENAMESRC##Tensor_data(src);		\
-    TH_TENSOR_APPLY(real, tensor,					\
-		    *tensor_data = (*src_data + *(src_data+1) * 1i);	\
-		    src_data +=2;);					\
+  TYPE_SRC *pairs = TH##TYPENAMESRC##Tensor_data(src);			\
+  THZ_TENSOR_APPLY(real, tensor,					\
+		   *tensor_data = pairs[2*THZ_APPLY_INDEX] + pairs[2*THZ_APPLY_INDEX+1] * 1i;); \
   TH##TYPENAMESRC##Tensor_free(src);					\
  } else {								\
-  TH_TENSOR_APPLY2(real, tensor, TYPE_SRC, src, *tensor_data = (real)(*src_data);) \
+  THZ_TENSOR_APPLY2(real, tensor, TYPE_SRC, src, *tensor_data = (real)(*src_data);) \
     }									\
 }
 
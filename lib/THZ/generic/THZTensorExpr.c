@@ -0,0 +1,166 @@
+/**
+ * Copyright (c) 2015-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#ifndef THZ_GENERIC_FILE
+#define THZ_GENERIC_FILE "generic/THZTensorExpr.c"
+#else
+
+/* elements per register: the registers of a thread fit in L2 */
+#define THZ_EXPR_BLOCK 1024
+#define THZ_EXPR_OMP_THRESHOLD 100000
+
+#define THZ_EXPR_UNARY(CFUNC)                   \
+  for(i = 0; i < n; i++)                        \
+    z[i] = CFUNC(x[i]);
+
+/* the THZVector_(fast*) kernel in fast math mode (THZVector.h) */
+#define THZ_EXPR_FAST(KERNEL, CFUNC)            \
+  if(fast)                                      \
+    THZVector_(KERNEL)(z, x, n);                \
+  else                                          \
+    THZ_EXPR_UNARY(CFUNC)
+
+#define THZ_EXPR_BINARY(OP)                     \
+  for(i = 0; i < n; i++)                        \
+    z[i] = x[i] OP y[i];
+
+/* runs code on the n elements at offset off; reg[k] points at the current
+   value of register k, which is either its buffer in regs or an input */
+static void THZTensor_(runExpr)(const int *code, int nInstructions, real **data, long off, long n,
+                                const real *constants, real *regs, real **reg, int fast)
+{
+  int pc;
+  long i;
+
+  for(pc = 0; pc < nInstructions; pc++)
+  {
+    const int *ins = code + 4*pc;
+    real *z = regs + ins[1]*THZ_EXPR_BLOCK;
+    const real *x = reg[ins[2]];
+    const real *y = reg[ins[3]];
+
+    switch(ins[0])
+    {
+      case THZ_EXPR_LOAD:
+        reg[ins[1]] = data[ins[2]] + off;
+        continue;
+      case THZ_EXPR_CONST:
+        THZVector_(fill)(z, constants[ins[2]], n);
+        break;
+      case THZ_EXPR_ADD:     THZVector_(cadd)(z, x, y, 1, n); break;
+      case THZ_EXPR_SUB:     THZVector_(cadd)(z, x, y, -1, n); break;
+      case THZ_EXPR_MUL:     THZVector_(cmul)(z, x, y, n); break;
+      case THZ_EXPR_DIV:     THZ_EXPR_BINARY(/); break;
+      case THZ_EXPR_MULCONJ: THZVector_(cmulconj)(z, x, y, n); break;
+      case THZ_EXPR_POW:
+        for(i = 0; i < n; i++)
+          z[i] = CPOW(x[i], y[i]);
+        break;
+      case THZ_EXPR_NEG:     THZ_EXPR_UNARY(-); break;
+      case THZ_EXPR_CONJ:    THZ_EXPR_UNARY(CONJ); break;
+      case THZ_EXPR_EXP:     THZ_EXPR_FAST(fastExp, CEXP); break;
+      case THZ_EXPR_LOG:     THZ_EXPR_FAST(fastLog, CLOG); break;
+      case THZ_EXPR_SQRT:    THZ_EXPR_FAST(fastSqrt, CSQRT); break;
+      case THZ_EXPR_COS:     THZ_EXPR_UNARY(CCOS); break;
+      case THZ_EXPR_SIN:     THZ_EXPR_UNARY(CSIN); break;
+      case THZ_EXPR_TAN:     THZ_EXPR_UNARY(CTAN); break;
+      case THZ_EXPR_ACOS:    THZ_EXPR_UNARY(CACOS); break;
+      case THZ_EXPR_ASIN:    THZ_EXPR_UNARY(CASIN); break;
+      case THZ_EXPR_ATAN:    THZ_EXPR_UNARY(CATAN); break;
+      case THZ_EXPR_COSH:    THZ_EXPR_UNARY(CCOSH); break;
+      case THZ_EXPR_SINH:    THZ_EXPR_UNARY(CSINH); break;
+      case THZ_EXPR_TANH:    THZ_EXPR_UNARY(CTANH); break;
+      case THZ_EXPR_PROJ:    THZ_EXPR_UNARY(CPROJ); break;
+    }
+    reg[ins[1]] = z;
+  }
+}
+
+#undef THZ_EXPR_UNARY
+#undef THZ_EXPR_FAST
+#undef THZ_EXPR_BINARY
+
+void THZTensor_(evalExpr)(THZTensor *r_, const int *code, int nInstructions,
+                          THZTensor **inputs, int nInputs,
+                          const real *constants, int nConstants)
+{
+  THZTensor *src[THZ_EXPR_MAX_INPUTS];
+  real *data[THZ_EXPR_MAX_INPUTS];
+  int written[THZ_EXPR_REGISTERS];
+  THZTensor *out;
+  real *rp;
+  long sz, nblocks, b;
+  int k, pc;
+  int fast = THZVector_fastMath();
+
+  THArgCheck(nInputs >= 1 && nInputs <= THZ_EXPR_MAX_INPUTS, 5, "1 to %d inputs expected", THZ_EXPR_MAX_INPUTS);
+  sz = THZTensor_(nElement)(inputs[0]);
+  for(k = 1; k < nInputs; k++)
+    THArgCheck(THZTensor_(nElement)(inputs[k]) == sz, 4, "inputs of different numbers of elements");
+
+  /* checked once here, so that the interpreter needs no checks */
+  for(k = 0; k < THZ_EXPR_REGISTERS; k++)
+    written[k] = 0;
+  for(pc = 0; pc < nInstructions; pc++)
+  {
+    const int *ins = code + 4*pc;
+    int op = ins[0];
+    int unary = (op >= THZ_EXPR_NEG);
+
+    THArgCheck(op >= 0 && op < THZ_EXPR_NOPS, 2, "instruction %d: unknown op %d", pc, op);
+    THArgCheck(ins[1] >= 0 && ins[1] < THZ_EXPR_REGISTERS, 2, "instruction %d: bad register", pc);
+    if(op == THZ_EXPR_LOAD)
+      THArgCheck(ins[2] >= 0 && ins[2] < nInputs, 2, "instruction %d: bad input", pc);
+    else if(op == THZ_EXPR_CONST)
+      THArgCheck(ins[2] >= 0 && ins[2] < nConstants, 2, "instruction %d: bad constant", pc);
+    else
+    {
+      THArgCheck(ins[2] >= 0 && ins[2] < THZ_EXPR_REGISTERS && written[ins[2]] &&
+                 (unary || (ins[3] >= 0 && ins[3] < THZ_EXPR_REGISTERS && written[ins[3]])),
+                 2, "instruction %d: register read before it is set", pc);
+    }
+    written[ins[1]] = 1;
+  }
+  THArgCheck(written[0], 2, "the program does not set register 0");
+
+  for(k = 0; k < nInputs; k++)
+  {
+    src[k] = THZTensor_(newContiguous)(inputs[k]);
+    data[k] = THZTensor_(data)(src[k]);
+  }
+  THZTensor_(resizeAs)(r_, inputs[0]);
+  out = THZTensor_(newContiguous)(r_);
+  rp = THZTensor_(data)(out);
+
+  /* each block is read in full before it is written, so that the output
+     may be an input */
+  nblocks = (sz + THZ_EXPR_BLOCK - 1) / THZ_EXPR_BLOCK;
+  #pragma omp parallel if(sz > THZ_EXPR_OMP_THRESHOLD)
+  {
+    real *regs = THAlloc(sizeof(real)*THZ_EXPR_REGISTERS*THZ_EXPR_BLOCK);
+    real *reg[THZ_EXPR_REGISTERS];
+
+    #pragma omp for schedule(static) private(b)
+    for(b = 0; b < nblocks; b++)
+    {
+      long off = b*THZ_EXPR_BLOCK;
+      long n = THMin(THZ_EXPR_BLOCK, sz-off);
+
+      THZTensor_(runExpr)(code, nInstructions, data, off, n, constants, regs, reg, fast);
+      memmove(rp+off, reg[0], n*sizeof(real));
+    }
+    THFree(regs);
+  }
+
+  THZTensor_(freeCopyTo)(out, r_);
+  for(k = 0; k < nInputs; k++)
+    THZTensor_(free)(src[k]);
+}
+
+#endif
@@ -0,0 +1,23 @@
+/**
+ * Copyright (c) 2015-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#ifndef THZ_GENERIC_FILE
+#define THZ_GENERIC_FILE "generic/THZTensorExpr.h"
+#else
+
+/* Runs a chain of elementwise ops in a single pass over memory: the program
+   of nInstructions THZ_EXPR_* instructions (see THZTensor.h) is run on
+   blocks of elements small enough to stay in cache, and r_, resized as
+   inputs[0], gets register 0. The inputs must all have as many elements as
+   inputs[0]; r_ may be one of them. */
+THZ_API void THZTensor_(evalExpr)(THZTensor *r_, const int *code, int nInstructions,
+                                  THZTensor **inputs, int nInputs,
+                                  const real *constants, int nConstants);
+
+#endif
@@ -0,0 +1,95 @@
+/**
+ * Copyright (c) 2015-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#ifndef THZ_GENERIC_FILE
+#define THZ_GENERIC_FILE "generic/THZTensorFFT.c"
+#else
+
+static void THZTensor_(fftAlong)(THZTensor *r_, THZTensor *t, int dimension, int sign)
+{
+  THZFFTCachedPlan *entry;
+  THZFFTPlan *plan;
+  real *data;
+  long n, stride, nlines, line;
+
+  THArgCheck(dimension >= 0 && dimension < THZTensor_(nDimension)(t), 3, "dimension out of range");
+
+  if(r_ != t)
+  {
+    THZTensor_(resizeAs)(r_, t);
+    THZTensor_(copy)(r_, t);
+  }
+
+  n = r_->size[dimension];
+  stride = r_->stride[dimension];
+  if(n <= 1 || THZTensor_(nElement)(r_) == 0)
+    return;
+  nlines = THZTensor_(nElement)(r_) / n;
+  data = THZTensor_(data)(r_);
+
+  /* the cached entry carries the plan and per-thread scratch (a gather
+     buffer for strided lines plus the plan work) sized for entry->nthreads */
+  entry = THZFFT_(acquire)(n, stride, nlines, sign);
+  plan = entry->plan;
+
+#pragma omp parallel for if(entry->nthreads > 1) num_threads(entry->nthreads) private(line)
+  for(line = 0; line < nlines; line++)
+  {
+#ifdef _OPENMP
+    real *scratch = entry->scratch + entry->work*omp_get_thread_num();
+#else
+    real *scratch = entry->scratch;
+#endif
+    real *x = data;
+    long rem = line, j;
+    int d;
+
+    for(d = r_->nDimension-1; d >= 0; d--)
+    {
+      if(d == dimension)
+        continue;
+      x += (rem % r_->size[d]) * r_->stride[d];
+      rem /= r_->size[d];
+    }
+
+    if(stride == 1)
+    {
+      THZFFT_(execute)(plan, x, scratch);
+      if(sign > 0)
+        for(j = 0; j < n; j++)
+          x[j] /= (realscalar)n;
+    }
+    else
+    {
+      for(j = 0; j < n; j++)
+        scratch[j] = x[j*stride];
+      THZFFT_(execute)(plan, scratch, scratch + n);
+      if(sign > 0)
+        for(j = 0; j < n; j++)
+          x[j*stride] = scratch[j] / (realscalar)n;
+      else
+        for(j = 0; j < n; j++)
+          x[j*stride] = scratch[j];
+    }
+  }
+
+  THZFFT_(release)(entry);
+}
+
+void THZTensor_(fft)(THZTensor *r_, THZTensor *t, int dimension)
+{
+  THZTensor_(fftAlong)(r_, t, dimension, -1);
+}
+
+void THZTensor_(ifft)(THZTensor *r_, THZTensor *t, int dimension)
+{
+  THZTensor_(fftAlong)(r_, t, dimension, 1);
+}
+
+#endif
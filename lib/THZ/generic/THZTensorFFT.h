@@ -0,0 +1,20 @@
+/**
+ * Copyright (c) 2015-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#ifndef THZ_GENERIC_FILE
+#define THZ_GENERIC_FILE "generic/THZTensorFFT.h"
+#else
+
+/* Discrete Fourier transforms along one dimension, batched over all the
+   others. fft uses exp(-2*pi*i*jk/n); ifft uses exp(+2*pi*i*jk/n) and
+   divides by n, so that ifft(fft(x)) == x. r_ may be t. */
+THZ_API void THZTensor_(fft)(THZTensor *r_, THZTensor *t, int dimension);
+THZ_API void THZTensor_(ifft)(THZTensor *r_, THZTensor *t, int dimension);
+
+#endif
@@ -0,0 +1,303 @@
+/**
+ * Copyright (c) 2015-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#ifndef THZ_GENERIC_FILE
+#define THZ_GENERIC_FILE "generic/THZTensorFile.c"
+#else
+
+#if defined(THZ_REAL_IS_FLOAT)
+#define THZ_FILE_TYPE THZ_FILE_ZFLOAT
+#else
+#define THZ_FILE_TYPE THZ_FILE_ZDOUBLE
+#endif
+
+void THZTensor_(writeMapped)(THZTensor *self, const char *filename)
+{
+  THZTensor *src;
+  long n = THZTensor_(nElement)(self);
+  int ok;
+  FILE *f;
+
+  f = fopen(filename, "wb");
+  if(!f)
+    THError("cannot open file <%s> for writing", filename);
+
+  ok = THZFileHeader_write(f, THZ_FILE_TYPE, self->nDimension, self->size);
+
+  if(ok && n > 0)
+  {
+    src = THZTensor_(newContiguous)(self);
+    ok = fwrite(THZTensor_(data)(src), sizeof(real), n, f) == (size_t)n;
+    THZTensor_(free)(src);
+  }
+
+  if(fclose(f) != 0 || !ok)
+    THError("write error on file <%s>", filename);
+}
+
+THZTensor *THZTensor_(newFromMappedFile)(const char *filename, int shared)
+{
+  THZFileHeader header;
+  THZStorage *storage;
+  THZTensor *self;
+  long *size, *stride;
+  long extent = 0, payload;
+  int d, ok;
+  FILE *f;
+
+  f = fopen(filename, "rb");
+  if(!f)
+    THError("cannot open file <%s>", filename);
+  if(!THZFileHeader_read(f, &header))
+  {
+    fclose(f);
+    THError("<%s> is not a tensor file", filename);
+  }
+  if(header.type != THZ_FILE_TYPE)
+  {
+    fclose(f);
+    THError("<%s> holds a %s tensor", filename, header.type == THZ_FILE_ZFLOAT ? "ZFloat" : "ZDouble");
+  }
+
+  size = THAlloc(sizeof(long)*(header.nDimension+1));
+  stride = THAlloc(sizeof(long)*(header.nDimension+1));
+  ok = THZFileHeader_readShape(f, &header, size, stride);
+  for(d = 0; d < header.nDimension && ok; d++)
+  {
+    if(size[d] == 0)
+      extent = -1;
+    else if(extent >= 0)
+      extent += (size[d]-1)*stride[d];
+  }
+  fclose(f);
+  if(!ok)
+  {
+    THFree(size);
+    THFree(stride);
+    THError("<%s> has a corrupted header", filename);
+  }
+
+  storage = THZStorage_(newWithMapping)(filename, 0, shared);
+  payload = storage->size - header.offset/(long)sizeof(real);
+  if(header.nDimension > 0 && extent >= payload)
+  {
+    THZStorage_(free)(storage);
+    THFree(size);
+    THFree(stride);
+    THError("<%s> is truncated", filename);
+  }
+
+  self = THZTensor_(new)();
+  THZTensor_(rawSet)(self, storage, header.offset/sizeof(real), header.nDimension, size, stride);
+  THZStorage_(free)(storage);
+  THFree(size);
+  THFree(stride);
+  return self;
+}
+
+struct THZTensorReader
+{
+    FILE *file;
+    int nDimension;
+    long *size;       /* of the tensor in the file */
+    long *chunkSize;
+    long offset;      /* of the payload, in bytes */
+    long rowSize;     /* elements in a slice along the first dimension */
+    long next;        /* the first row not read yet */
+};
+
+THZTensorReader *THZTensorReader_(new)(const char *filename)
+{
+  THZFileHeader header;
+  THZTensorReader *self;
+  const char *error = NULL;
+  long *stride;
+  long z, payload;
+  int d;
+  FILE *f;
+
+  f = fopen(filename, "rb");
+  if(!f)
+    THError("cannot open file <%s>", filename);
+  /* chunks go straight from the file to the tensor */
+  setvbuf(f, NULL, _IONBF, 0);
+  if(!THZFileHeader_read(f, &header))
+  {
+    fclose(f);
+    THError("<%s> is not a tensor file", filename);
+  }
+  if(header.type != THZ_FILE_TYPE)
+  {
+    fclose(f);
+    THError("<%s> holds a %s tensor", filename, header.type == THZ_FILE_ZFLOAT ? "ZFloat" : "ZDouble");
+  }
+  if(header.nDimension == 0)
+  {
+    fclose(f);
+    THError("<%s> holds an empty tensor", filename);
+  }
+
+  self = THAlloc(sizeof(THZTensorReader));
+  self->file = f;
+  self->nDimension = header.nDimension;
+  self->size = THAlloc(sizeof(long)*header.nDimension);
+  self->chunkSize = THAlloc(sizeof(long)*header.nDimension);
+  self->offset = header.offset;
+  self->next = 0;
+  stride = THAlloc(sizeof(long)*header.nDimension);
+
+  if(!THZFileHeader_readShape(f, &header, self->size, stride))
+    error = "has a corrupted header";
+  for(d = header.nDimension-1, z = 1; d >= 0 && !error; d--)
+  {
+    /* the rows are read in order, one after the other */
+    if(self->size[d] != 1 && stride[d] != z)
+      error = "does not hold a contiguous tensor";
+    z *= self->size[d];
+  }
+  THFree(stride);
+  if(!error)
+  {
+    memcpy(self->chunkSize, self->size, sizeof(long)*header.nDimension);
+    for(d = 1, self->rowSize = 1; d < header.nDimension; d++)
+      self->rowSize *= self->size[d];
+    payload = self->size[0]*self->rowSize*sizeof(real);
+    if(fseek(f, 0, SEEK_END) != 0 || ftell(f) < self->offset + payload || fseek(f, self->offset, SEEK_SET) != 0)
+      error = "is truncated";
+  }
+  if(error)
+  {
+    THZTensorReader_(free)(self);
+    THError("<%s> %s", filename, error);
+  }
+  return self;
+}
+
+int THZTensorReader_(nDimension)(const THZTensorReader *self)
+{
+  return self->nDimension;
+}
+
+long THZTensorReader_(size)(const THZTensorReader *self, int dim)
+{
+  THArgCheck(dim >= 0 && dim < self->nDimension, 2, "dimension %d out of range of %dD tensor", dim+1, self->nDimension);
+  return self->size[dim];
+}
+
+long THZTensorReader_(read)(THZTensorReader *self, THZTensor *chunk, long nRows)
+{
+  const long rowBytes = self->rowSize*sizeof(real);
+  long first = self->next;
+  long n = self->size[0] - first;
+
+  THArgCheck(nRows > 0, 3, "the number of rows must be positive");
+  if(n > nRows)
+    n = nRows;
+  if(n <= 0)
+    return 0;
+
+  self->chunkSize[0] = n;
+  THZTensor_(rawResize)(chunk, self->nDimension, self->chunkSize, NULL);
+  THZTensorFile_advise(self->file, self->offset + (first+n)*rowBytes, nRows*rowBytes, 1);
+  if(fread(THZTensor_(data)(chunk), rowBytes, n, self->file) != (size_t)n)
+    THError("read error: rows %ld to %ld", first+1, first+n);
+  THZTensorFile_advise(self->file, self->offset + first*rowBytes, n*rowBytes, 0);
+  self->next += n;
+  return n;
+}
+
+void THZTensorReader_(free)(THZTensorReader *self)
+{
+  fclose(self->file);
+  THFree(self->size);
+  THFree(self->chunkSize);
+  THFree(self);
+}
+
+struct THZTensorWriter
+{
+    FILE *file;       /* NULL once closed */
+    int nDimension;
+    long *size;
+    long next;
+};
+
+THZTensorWriter *THZTensorWriter_(new)(const char *filename, THLongStorage *size)
+{
+  THZTensorWriter *self;
+  FILE *f;
+  long d;
+
+  THArgCheck(size->size > 0, 2, "a streamed tensor has at least one dimension");
+  for(d = 0; d < size->size; d++)
+    THArgCheck(size->data[d] >= 0, 2, "invalid size");
+
+  f = fopen(filename, "wb");
+  if(!f)
+    THError("cannot open file <%s> for writing", filename);
+  if(!THZFileHeader_write(f, THZ_FILE_TYPE, size->size, size->data))
+  {
+    fclose(f);
+    THError("write error on file <%s>", filename);
+  }
+
+  self = THAlloc(sizeof(THZTensorWriter));
+  self->file = f;
+  self->nDimension = size->size;
+  self->size = THAlloc(sizeof(long)*size->size);
+  memcpy(self->size, size->data, sizeof(long)*size->size);
+  self->next = 0;
+  return self;
+}
+
+void THZTensorWriter_(write)(THZTensorWriter *self, THZTensor *chunk)
+{
+  THZTensor *src;
+  long n = THZTensor_(nElement)(chunk);
+  int d, ok;
+
+  THArgCheck(self->file != NULL, 1, "the writer is closed");
+  THArgCheck(chunk->nDimension == self->nDimension, 2, "the chunk must have %d dimensions", self->nDimension);
+  for(d = 1; d < self->nDimension; d++)
+    THArgCheck(chunk->size[d] == self->size[d], 2, "dimension %d of the chunk must have size %ld", d+1, self->size[d]);
+  THArgCheck(self->next + chunk->size[0] <= self->size[0], 2, "the chunk goes past the %ld rows of the tensor", self->size[0]);
+
+  src = THZTensor_(newContiguous)(chunk);
+  ok = fwrite(THZTensor_(data)(src), sizeof(real), n, self->file) == (size_t)n;
+  THZTensor_(free)(src);
+  if(!ok)
+    THError("write error: rows %ld to %ld", self->next+1, self->next+chunk->size[0]);
+  self->next += chunk->size[0];
+}
+
+void THZTensorWriter_(close)(THZTensorWriter *self)
+{
+  int ok;
+
+  if(!self->file)
+    return;
+  ok = fclose(self->file) == 0;
+  self->file = NULL;
+  if(!ok)
+    THError("write error on close");
+  if(self->next != self->size[0])
+    THError("%ld rows written out of %ld", self->next, self->size[0]);
+}
+
+void THZTensorWriter_(free)(THZTensorWriter *self)
+{
+  if(self->file)
+    fclose(self->file);
+  THFree(self->size);
+  THFree(self);
+}
+
+#undef THZ_FILE_TYPE
+
+#endif
@@ -0,0 +1,46 @@
+/**
+ * Copyright (c) 2015-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#ifndef THZ_GENERIC_FILE
+#define THZ_GENERIC_FILE "generic/THZTensorFile.h"
+#else
+
+/* Tensors in mapped files (layout in THZTensor.h). writeMapped stores the
+   elements of self in a new file, contiguously. newFromMappedFile maps such
+   a file and returns a tensor on it, without reading the payload: pages are
+   brought in when touched. With shared, writes to the tensor go to the
+   file; otherwise they stay private to the process. */
+THZ_API void THZTensor_(writeMapped)(THZTensor *self, const char *filename);
+THZ_API THZTensor *THZTensor_(newFromMappedFile)(const char *filename, int shared);
+
+/* Streaming access to tensor files too large for memory, in chunks of rows
+   along the first dimension: chunk k of n rows is narrow(0, k*n, n).
+
+   A reader reads its file in order: read() resizes chunk to the next nRows
+   rows (fewer at the end) and fills it, and returns the number of rows read,
+   0 past the end. Each call also has the kernel fetch the following nRows
+   rows in the background, and drops the rows just read from the page
+   cache. A writer creates a file for a tensor of the given size and appends
+   the rows of the chunks it is given; close() raises an error unless they
+   add up to the whole tensor. */
+typedef struct THZTensorReader THZTensorReader;
+typedef struct THZTensorWriter THZTensorWriter;
+
+THZ_API THZTensorReader *THZTensorReader_(new)(const char *filename);
+THZ_API int THZTensorReader_(nDimension)(const THZTensorReader *self);
+THZ_API long THZTensorReader_(size)(const THZTensorReader *self, int dim);
+THZ_API long THZTensorReader_(read)(THZTensorReader *self, THZTensor *chunk, long nRows);
+THZ_API void THZTensorReader_(free)(THZTensorReader *self);
+
+THZ_API THZTensorWriter *THZTensorWriter_(new)(const char *filename, THLongStorage *size);
+THZ_API void THZTensorWriter_(write)(THZTensorWriter *self, THZTensor *chunk);
+THZ_API void THZTensorWriter_(close)(THZTensorWriter *self);
+THZ_API void THZTensorWriter_(free)(THZTensorWriter *self);
+
+#endif
@@ -169,7 +169,7 @@ THZ_API void THZTensor_(gels)(THZTensor *rb_, THZTensor *ra_, THZTensor *b, THZT
 		  THZTensor_(data)(rb__), ldb,
 		  &wkopt, -1, &info);
   lwork = (int)wkopt;
-  work = THZTensor_(newWithSize1d)(lwork);
+  work = THZTensor_(newScratchWithSize1d)(lwork);
   THZLapack_(gels)('N', m, n, nrhs, THZTensor_(data)(ra__), lda,
 		  THZTensor_(data)(rb__), ldb,
 		  THZTensor_(data)(work), lwork, &info);
@@ -236,7 +236,7 @@ THZ_API void THZTensor_(geev)(THZTensor *re_, THZTensor *rv_, THZTensor *a_, con
       NULL, 1, rv_data, ldvr, &wkopt, -1, &info);
 
   lwork = (int)wkopt;
-  work = THZTensor_(newWithSize1d)(lwork);
+  work = THZTensor_(newScratchWithSize1d)(lwork);
 
   THZLapack_(geev)('N', jobvr[0], n, THZTensor_(data)(a), lda, THZTensor_(data)(wr), THZTensor_(data)(wi),
       NULL, 1, rv_data, ldvr, THZTensor_(data)(work), lwork, &info);
@@ -305,7 +305,7 @@ THZ_API void THZTensor_(syev)(THZTensor *re_, THZTensor *rv_, THZTensor *a, cons
   THZLapack_(syev)(jobz[0], uplo[0], n, THZTensor_(data)(rv__), lda,
 		  THZTensor_(data)(re_), &wkopt, -1, &info);
   lwork = (int)wkopt;
-  work = THZTensor_(newWithSize1d)(lwork);
+  work = THZTensor_(newScratchWithSize1d)(lwork);
   THZLapack_(syev)(jobz[0], uplo[0], n, THZTensor_(data)(rv__), lda,
 		  THZTensor_(data)(re_), THZTensor_(data)(work), lwork, &info);
 
@@ -391,7 +391,7 @@ THZ_API void THZTensor_(gesvd2)(THZTensor *ru_, THZTensor *rs_, THZTensor *rv_,
 		   THZTensor_(data)(rv_), ldvt,
 		   &wkopt, -1, &info);
   lwork = (int)wkopt;
-  work = THZTensor_(newWithSize1d)(lwork);
+  work = THZTensor_(newScratchWithSize1d)(lwork);
   THZLapack_(gesvd)(jobu[0],jobu[0],
 		   m,n,THZTensor_(data)(ra__),lda,
 		   THZTensor_(data)(rs_),
@@ -465,7 +465,7 @@ THZ_API void THZTensor_(getri)(THZTensor *ra_, THZTensor *a)
   /* Run inverse */
   THZLapack_(getri)(n, THZTensor_(data)(ra__), lda, THIntTensor_data(ipiv), &wkopt, -1, &info);
   lwork = (int)wkopt;
-  work = THZTensor_(newWithSize1d)(lwork);
+  work = THZTensor_(newScratchWithSize1d)(lwork);
   THZLapack_(getri)(n, THZTensor_(data)(ra__), lda, THIntTensor_data(ipiv), THZTensor_(data)(work), lwork, &info);
   if (info > 0)
   {
@@ -11,25 +11,40 @@
 #define THZ_GENERIC_FILE "generic/THZTensorMath.c"
 #else
 
-#define THZ_OMP_OVERHEAD_THZRESHOLD 100000
-
 void THZTensor_(fill)(THZTensor *r_, real value)
 {
-  TH_TENSOR_APPLY(real, r_,
-                  THZVector_(fill)(r__data, value, r__size); break;);
+  if (THZTensor_(isContiguous)(r_)) {
+      real *rp = THZTensor_(data)(r_);
+      long sz = THZTensor_(nElement)(r_);
+      long nblocks = (sz + THZ_VECTOR_BLOCK - 1) / THZ_VECTOR_BLOCK;
+      long b;
+      /* an explicit static schedule: thread t gets the same blocks here as
+         in the elementwise loops under the static default schedule of
+         libgomp and the LLVM runtime, so the first touch of a fresh tensor
+         puts its pages near the threads that will use them */
+      #pragma omp parallel for if(sz > THZ_OMP_OVERHEAD_THZRESHOLD) schedule(static) private(b)
+      for (b=0; b<nblocks; b++) {
+          long off = b*THZ_VECTOR_BLOCK;
+          THZVector_(fill)(rp+off, value, THMin(THZ_VECTOR_BLOCK, sz-off));
+      }
+  } else {
+      THZ_TENSOR_APPLY(real, r_, *r__data = value;);
+  }
 }
 
 void THZTensor_(zero)(THZTensor *r_)
 {
-  TH_TENSOR_APPLY(real, r_,
-                  THZVector_(fill)(r__data, 0, r__size); break;);
+  THZTensor_(fill)(r_, 0);
 }
 
 void THZTensor_(maskedFill)(THZTensor *tensor, THByteTensor *mask, real value)
 {
-  TH_TENSOR_APPLY2(real, tensor, unsigned char, mask,
-                   if (*mask_data > 1) THError("Mask tensor can take 0 and 1 values only");
-                   else if (*mask_data == 1) *tensor_data = value;);
+  int invalid = 0;
+  THZ_TENSOR_APPLY2(real, tensor, unsigned char, mask,
+                    if (*mask_data > 1) invalid = 1;
+                    else if (*mask_data == 1) *tensor_data = value;);
+  if (invalid)
+    THError("Mask tensor can take 0 and 1 values only");
 }
 
 void THZTensor_(maskedCopy)(THZTensor *tensor, THByteTensor *mask, THZTensor* src )
@@ -183,6 +198,24 @@ void THZTensor_(indexFill)(THZTensor *tensor, int dim, THLongTensor *index, real
 accreal THZTensor_(dot)(THZTensor *tensor, THZTensor *src)
 {
   accreal sum = 0;
+  if (THZTensor_(isContiguous)(tensor) && THZTensor_(isContiguous)(src) && THZTensor_(nElement)(tensor) == THZTensor_(nElement)(src)) {
+      real *tp = THZTensor_(data)(tensor);
+      real *sp = THZTensor_(data)(src);
+      long sz = THZTensor_(nElement)(tensor);
+      long nblocks = (sz + THZ_VECTOR_BLOCK - 1) / THZ_VECTOR_BLOCK;
+      accreal *partial = THAlloc(sizeof(accreal)*nblocks);
+      long b;
+      #pragma omp parallel for if(sz > THZ_OMP_OVERHEAD_THZRESHOLD) private(b)
+      for (b=0; b<nblocks; b++) {
+          long off = b*THZ_VECTOR_BLOCK;
+          partial[b] = THZVector_(cdotc)(tp+off, sp+off, THMin(THZ_VECTOR_BLOCK, sz-off));
+      }
+      /* in block order, so that the result does not depend on the threads */
+      for (b=0; b<nblocks; b++)
+        sum += partial[b];
+      THFree(partial);
+      return sum;
+  }
   /* we use a trick here. careful with that. */
   TH_TENSOR_APPLY2(real, tensor, real, src,
                    long sz = (tensor_size-tensor_i < src_size-src_i ? tensor_size-tensor_i : src_size-src_i);
@@ -232,7 +265,7 @@ void THZTensor_(add)(THZTensor *r_, THZTensor *t, real value)
       for (i=0; i<sz; i++)
           rp[i] = tp[i] + value;
   } else {
-      TH_TENSOR_APPLY2(real, r_, real, t, *r__data = *t_data + value;);
+      THZ_TENSOR_APPLY2(real, r_, real, t, *r__data = *t_data + value;);
   }
 }
 
@@ -243,12 +276,15 @@ void THZTensor_(mul)(THZTensor *r_, THZTensor *t, real value)
       real *tp = THZTensor_(data)(t);
       real *rp = THZTensor_(data)(r_);
       long sz = THZTensor_(nElement)(t);
-      long i;
-      #pragma omp parallel for if(sz > THZ_OMP_OVERHEAD_THZRESHOLD) private(i)
-      for (i=0; i<sz; i++)
-          rp[i] = tp[i] * value;
+      long nblocks = (sz + THZ_VECTOR_BLOCK - 1) / THZ_VECTOR_BLOCK;
+      long b;
+      #pragma omp parallel for if(sz > THZ_OMP_OVERHEAD_THZRESHOLD) private(b)
+      for (b=0; b<nblocks; b++) {
+          long off = b*THZ_VECTOR_BLOCK;
+          THZVector_(cscale)(rp+off, tp+off, value, THMin(THZ_VECTOR_BLOCK, sz-off));
+      }
   } else {
-      TH_TENSOR_APPLY2(real, r_, real, t, *r__data = *t_data * value;);
+      THZ_TENSOR_APPLY2(real, r_, real, t, *r__data = *t_data * value;);
   }
 }
 
@@ -264,7 +300,7 @@ void THZTensor_(div)(THZTensor *r_, THZTensor *t, real value)
       for (i=0; i<sz; i++)
           rp[i] = tp[i] / value;
   } else {
-      TH_TENSOR_APPLY2(real, r_, real, t, *r__data = *t_data / value;);
+      THZ_TENSOR_APPLY2(real, r_, real, t, *r__data = *t_data / value;);
   }
 }
 
@@ -272,20 +308,19 @@ void THZTensor_(cadd)(THZTensor *r_, THZTensor *t, real value, THZTensor *src)
 {
   THZTensor_(resizeAs)(r_, t);
   if (THZTensor_(isContiguous)(r_) && THZTensor_(isContiguous)(t) && THZTensor_(isContiguous)(src) && THZTensor_(nElement)(r_) == THZTensor_(nElement)(src)) {
-    if(r_ == t) {
-      THZBlas_(axpy)(THZTensor_(nElement)(t), value, THZTensor_(data)(src), 1, THZTensor_(data)(r_), 1);
-    } else {
       real *tp = THZTensor_(data)(t);
       real *sp = THZTensor_(data)(src);
       real *rp = THZTensor_(data)(r_);
       long sz = THZTensor_(nElement)(t);
-      long i;
-      #pragma omp parallel for if(sz > THZ_OMP_OVERHEAD_THZRESHOLD) private(i)
-      for (i=0; i< sz; i++)
-          rp[i] = tp[i] + value * sp[i];
-    }
+      long nblocks = (sz + THZ_VECTOR_BLOCK - 1) / THZ_VECTOR_BLOCK;
+      long b;
+      #pragma omp parallel for if(sz > THZ_OMP_OVERHEAD_THZRESHOLD) private(b)
+      for (b=0; b<nblocks; b++) {
+          long off = b*THZ_VECTOR_BLOCK;
+          THZVector_(cadd)(rp+off, tp+off, sp+off, value, THMin(THZ_VECTOR_BLOCK, sz-off));
+      }
   } else {
-      TH_TENSOR_APPLY3(real, r_, real, t, real, src, *r__data = *t_data + value * *src_data;);
+      THZ_TENSOR_APPLY3(real, r_, real, t, real, src, *r__data = *t_data + value * *src_data;);
   }
 }
 
@@ -297,12 +332,35 @@ void THZTensor_(cmul)(THZTensor *r_, THZTensor *t, THZTensor *src)
       real *sp = THZTensor_(data)(src);
       real *rp = THZTensor_(data)(r_);
       long sz = THZTensor_(nElement)(t);
-      long i;
-      #pragma omp parallel for if(sz > THZ_OMP_OVERHEAD_THZRESHOLD) private(i)
-      for (i=0; i<sz; i++)
-        rp[i] = tp[i] * sp[i];
+      long nblocks = (sz + THZ_VECTOR_BLOCK - 1) / THZ_VECTOR_BLOCK;
+      long b;
+      #pragma omp parallel for if(sz > THZ_OMP_OVERHEAD_THZRESHOLD) private(b)
+      for (b=0; b<nblocks; b++) {
+          long off = b*THZ_VECTOR_BLOCK;
+          THZVector_(cmul)(rp+off, tp+off, sp+off, THMin(THZ_VECTOR_BLOCK, sz-off));
+      }
   } else {
-      TH_TENSOR_APPLY3(real, r_, real, t, real, src, *r__data = *t_data * *src_data;);
+      THZ_TENSOR_APPLY3(real, r_, real, t, real, src, *r__data = *t_data * *src_data;);
+  }
+}
+
+void THZTensor_(cmulconj)(THZTensor *r_, THZTensor *t, THZTensor *src)
+{
+  THZTensor_(resizeAs)(r_, t);
+  if (THZTensor_(isContiguous)(r_) && THZTensor_(isContiguous)(t) && THZTensor_(isContiguous)(src) && THZTensor_(nElement)(r_) == THZTensor_(nElement)(src)) {
+      real *tp = THZTensor_(data)(t);
+      real *sp = THZTensor_(data)(src);
+      real *rp = THZTensor_(data)(r_);
+      long sz = THZTensor_(nElement)(t);
+      long nblocks = (sz + THZ_VECTOR_BLOCK - 1) / THZ_VECTOR_BLOCK;
+      long b;
+      #pragma omp parallel for if(sz > THZ_OMP_OVERHEAD_THZRESHOLD) private(b)
+      for (b=0; b<nblocks; b++) {
+          long off = b*THZ_VECTOR_BLOCK;
+          THZVector_(cmulconj)(rp+off, tp+off, sp+off, THMin(THZ_VECTOR_BLOCK, sz-off));
+      }
+  } else {
+      THZ_TENSOR_APPLY3(real, r_, real, t, real, src, *r__data = *t_data * CONJ(*src_data););
   }
 }
 
@@ -319,7 +377,7 @@ void THZTensor_(cdiv)(THZTensor *r_, THZTensor *t, THZTensor *src)
       for (i=0; i<sz; i++)
         rp[i] = tp[i] / sp[i];
   } else {
-      TH_TENSOR_APPLY3(real, r_, real, t, real, src, *r__data = *t_data / *src_data;);
+      THZ_TENSOR_APPLY3(real, r_, real, t, real, src, *r__data = *t_data / *src_data;);
   }
 }
 
@@ -331,10 +389,51 @@ void THZTensor_(addcmul)(THZTensor *r_, THZTensor *t, real value, THZTensor *src
     THZTensor_(copy)(r_, t);
   }
 
-  TH_TENSOR_APPLY3(real, r_, real, src1, real, src2, *r__data += value * *src1_data * *src2_data;);
+  if (THZTensor_(isContiguous)(r_) && THZTensor_(isContiguous)(src1) && THZTensor_(isContiguous)(src2) &&
+      THZTensor_(nElement)(r_) == THZTensor_(nElement)(src1) && THZTensor_(nElement)(r_) == THZTensor_(nElement)(src2)) {
+      real *s1p = THZTensor_(data)(src1);
+      real *s2p = THZTensor_(data)(src2);
+      real *rp = THZTensor_(data)(r_);
+      long sz = THZTensor_(nElement)(r_);
+      long nblocks = (sz + THZ_VECTOR_BLOCK - 1) / THZ_VECTOR_BLOCK;
+      long b;
+      #pragma omp parallel for if(sz > THZ_OMP_OVERHEAD_THZRESHOLD) private(b)
+      for (b=0; b<nblocks; b++) {
+          long off = b*THZ_VECTOR_BLOCK;
+          THZVector_(cmac)(rp+off, s1p+off, s2p+off, value, THMin(THZ_VECTOR_BLOCK, sz-off));
+      }
+  } else {
+      THZ_TENSOR_APPLY3(real, r_, real, src1, real, src2, *r__data += value * *src1_data * *src2_data;);
+  }
 }
 
 
+void THZTensor_(addcmulconj)(THZTensor *r_, THZTensor *t, real value, THZTensor *src1, THZTensor *src2)
+{
+  if(r_ != t)
+  {
+    THZTensor_(resizeAs)(r_, t);
+    THZTensor_(copy)(r_, t);
+  }
+
+  if (THZTensor_(isContiguous)(r_) && THZTensor_(isContiguous)(src1) && THZTensor_(isContiguous)(src2) &&
+      THZTensor_(nElement)(r_) == THZTensor_(nElement)(src1) && THZTensor_(nElement)(r_) == THZTensor_(nElement)(src2)) {
+      real *s1p = THZTensor_(data)(src1);
+      real *s2p = THZTensor_(data)(src2);
+      real *rp = THZTensor_(data)(r_);
+      long sz = THZTensor_(nElement)(r_);
+      long nblocks = (sz + THZ_VECTOR_BLOCK - 1) / THZ_VECTOR_BLOCK;
+      long b;
+      #pragma omp parallel for if(sz > THZ_OMP_OVERHEAD_THZRESHOLD) private(b)
+      for (b=0; b<nblocks; b++) {
+          long off = b*THZ_VECTOR_BLOCK;
+          THZVector_(cmacconj)(rp+off, s1p+off, s2p+off, value, THMin(THZ_VECTOR_BLOCK, sz-off));
+      }
+  } else {
+      THZ_TENSOR_APPLY3(real, r_, real, src1, real, src2, *r__data += value * *src1_data * CONJ(*src2_data););
+  }
+}
+
 void THZTensor_(addcdiv)(THZTensor *r_, THZTensor *t, real value, THZTensor *src1, THZTensor *src2)
 {
   if(r_ != t)
@@ -343,7 +442,7 @@ void THZTensor_(addcdiv)(THZTensor *r_, THZTensor *t, real value, THZTensor *src
     THZTensor_(copy)(r_, t);
   }
 
-  TH_TENSOR_APPLY3(real, r_, real, src1, real, src2, *r__data += value * *src1_data / *src2_data;);
+  THZ_TENSOR_APPLY3(real, r_, real, src1, real, src2, *r__data += value * *src1_data / *src2_data;);
 }
 
 void THZTensor_(addmv)(THZTensor *r_, real beta, THZTensor *t, real alpha, THZTensor *mat, THZTensor *vec)
@@ -382,7 +481,7 @@ void THZTensor_(addmv)(THZTensor *r_, real beta, THZTensor *t, real alpha, THZTe
   }
   else
   {
-    THZTensor *cmat = THZTensor_(newContiguous)(mat);
+    THZTensor *cmat = THZTensor_(newScratchContiguous)(mat);
 
     THZBlas_(gemv)('t',  mat->size[1], mat->size[0],
                   alpha, THZTensor_(data)(cmat), cmat->stride[0],
@@ -393,7 +492,9 @@ void THZTensor_(addmv)(THZTensor *r_, real beta, THZTensor *t, real alpha, THZTe
   }
 }
 
-void THZTensor_(addmm)(THZTensor *r_, real beta, THZTensor *t, real alpha, THZTensor *m1, THZTensor *m2)
+typedef void (*THZTensor_(gemmFunc))(char, char, long, long, long, real, real *, long, real *, long, real, real *, long);
+
+static void THZTensor_(addmmWith)(THZTensor_(gemmFunc) gemm, THZTensor *r_, real beta, THZTensor *t, real alpha, THZTensor *m1, THZTensor *m2)
 {
   char transpose_r, transpose_m1, transpose_m2;
   THZTensor *r__, *m1_, *m2_;
@@ -433,7 +534,7 @@ void THZTensor_(addmm)(THZTensor *r_, real beta, THZTensor *t, real alpha, THZTe
   {
     transpose_r = 'n';
 
-    r__ = THZTensor_(newWithSize2d)(r_->size[1], r_->size[0]);
+    r__ = THZTensor_(newScratchWithSize2d)(r_->size[1], r_->size[0]);
     THZTensor_(copy)(r__, r_);
     THZTensor_(transpose)(r__, NULL, 0, 1);
   }
@@ -452,7 +553,7 @@ void THZTensor_(addmm)(THZTensor *r_, real beta, THZTensor *t, real alpha, THZTe
   else
   {
     transpose_m1 = (transpose_r == 'n' ? 't' : 'n');
-    m1_ = THZTensor_(newContiguous)(m1);
+    m1_ = THZTensor_(newScratchContiguous)(m1);
   }
 
   /* m2 */
@@ -469,23 +570,23 @@ void THZTensor_(addmm)(THZTensor *r_, real beta, THZTensor *t, real alpha, THZTe
   else
   {
     transpose_m2 = (transpose_r == 'n' ? 't' : 'n');
-    m2_ = THZTensor_(newContiguous)(m2);
+    m2_ = THZTensor_(newScratchContiguous)(m2);
   }
 
   /* do the operation */
-  THZBlas_(gemm)(transpose_m1,
-                transpose_m2,
-                r__->size[(transpose_r == 'n' ? 0 : 1)],
-                r__->size[(transpose_r == 'n' ? 1 : 0)],
-                m1_->size[(transpose_r == 'n' ? 1 : 0)],
-                alpha,
-                THZTensor_(data)(m1_),
-                (transpose_m1 == 'n' ? m1_->stride[(transpose_r == 'n' ? 1 : 0)] : m1_->stride[(transpose_r == 'n' ? 0 : 1)]),
-                THZTensor_(data)(m2_),
-                (transpose_m2 == 'n' ? m2_->stride[(transpose_r == 'n' ? 1 : 0)] : m2_->stride[(transpose_r == 'n' ? 0 : 1)]),
-                beta,
-                THZTensor_(data)(r__),
-                r__->stride[(transpose_r == 'n' ? 1 : 0)]);
+  gemm(transpose_m1,
+       transpose_m2,
+       r__->size[(transpose_r == 'n' ? 0 : 1)],
+       r__->size[(transpose_r == 'n' ? 1 : 0)],
+       m1_->size[(transpose_r == 'n' ? 1 : 0)],
+       alpha,
+       THZTensor_(data)(m1_),
+       (transpose_m1 == 'n' ? m1_->stride[(transpose_r == 'n' ? 1 : 0)] : m1_->stride[(transpose_r == 'n' ? 0 : 1)]),
+       THZTensor_(data)(m2_),
+       (transpose_m2 == 'n' ? m2_->stride[(transpose_r == 'n' ? 1 : 0)] : m2_->stride[(transpose_r == 'n' ? 0 : 1)]),
+       beta,
+       THZTensor_(data)(r__),
+       r__->stride[(transpose_r == 'n' ? 1 : 0)]);
 
   /* free intermediate variables */
   if(m1_ != m1)
@@ -498,6 +599,424 @@ void THZTensor_(addmm)(THZTensor *r_, real beta, THZTensor *t, real alpha, THZTe
     THZTensor_(freeCopyTo)(r__, r_);
 }
 
+void THZTensor_(addmm)(THZTensor *r_, real beta, THZTensor *t, real alpha, THZTensor *m1, THZTensor *m2)
+{
+  THZTensor_(addmmWith)(THZBlas_(gemm), r_, beta, t, alpha, m1, m2);
+}
+
+/* same as addmm with the 3M product (see THZBlas_(gemm3m)): a quarter
+   fewer flops, slightly less accurate imaginary part */
+void THZTensor_(addmm3m)(THZTensor *r_, real beta, THZTensor *t, real alpha, THZTensor *m1, THZTensor *m2)
+{
+  THZTensor_(addmmWith)(THZBlas_(gemm3m), r_, beta, t, alpha, m1, m2);
+}
+
+/* same as addmm with the packed gemm of THZ even where a BLAS library is
+   available, for testing it and comparing it with the library */
+void THZTensor_(addmmBlocked)(THZTensor *r_, real beta, THZTensor *t, real alpha, THZTensor *m1, THZTensor *m2)
+{
+  THZTensor_(addmmWith)(THZBlas_(gemmBlocked), r_, beta, t, alpha, m1, m2);
+}
+
+void THZTensor_(baddbmm)(THZTensor *result, real beta, THZTensor *t, real alpha, THZTensor *batch1, THZTensor *batch2)
+{
+  char transpose_r, transpose_m1, transpose_m2;
+  THZTensor *r__, *m1_, *m2_;
+  real **ptrs;
+  long nbatch, i;
+
+  THArgCheck(batch1->nDimension == 3, 5, "expected 3D tensor");
+  THArgCheck(batch2->nDimension == 3, 6, "expected 3D tensor");
+  THArgCheck(t->nDimension == 3, 3, "expected 3D tensor");
+  THArgCheck(batch1->size[0] == batch2->size[0] && t->size[0] == batch1->size[0], 5,
+             "equal number of batches expected");
+  THArgCheck(t->size[1] == batch1->size[1] && t->size[2] == batch2->size[2] && batch1->size[2] == batch2->size[1], 5,
+             "size mismatch");
+
+  if(t != result)
+  {
+    THZTensor_(resizeAs)(result, t);
+    THZTensor_(copy)(result, t);
+  }
+
+  nbatch = result->size[0];
+  if(nbatch == 0)
+    return;
+
+  /* same layout selection as addmm, one dimension further in; the strides
+     are shared by all the matrices of a batch */
+  if(result->stride[1] == 1)
+  {
+    transpose_r = 'n';
+    r__ = result;
+  }
+  else if(result->stride[2] == 1)
+  {
+    THZTensor *swap = batch2;
+    batch2 = batch1;
+    batch1 = swap;
+    transpose_r = 't';
+    r__ = result;
+  }
+  else
+  {
+    THZTensor *transp_r_ = THZTensor_(newTranspose)(result, 1, 2);
+    transpose_r = 'n';
+    r__ = THZTensor_(newScratchClone)(transp_r_);
+    THZTensor_(free)(transp_r_);
+    THZTensor_(transpose)(r__, NULL, 1, 2);
+  }
+
+  if(batch1->stride[(transpose_r == 'n' ? 1 : 2)] == 1)
+  {
+    transpose_m1 = 'n';
+    m1_ = batch1;
+  }
+  else if(batch1->stride[(transpose_r == 'n' ? 2 : 1)] == 1)
+  {
+    transpose_m1 = 't';
+    m1_ = batch1;
+  }
+  else
+  {
+    transpose_m1 = (transpose_r == 'n' ? 't' : 'n');
+    m1_ = THZTensor_(newScratchContiguous)(batch1);
+  }
+
+  if(batch2->stride[(transpose_r == 'n' ? 1 : 2)] == 1)
+  {
+    transpose_m2 = 'n';
+    m2_ = batch2;
+  }
+  else if(batch2->stride[(transpose_r == 'n' ? 2 : 1)] == 1)
+  {
+    transpose_m2 = 't';
+    m2_ = batch2;
+  }
+  else
+  {
+    transpose_m2 = (transpose_r == 'n' ? 't' : 'n');
+    m2_ = THZTensor_(newScratchContiguous)(batch2);
+  }
+
+  ptrs = THAlloc(sizeof(real*)*3*nbatch);
+  for(i = 0; i < nbatch; i++)
+  {
+    ptrs[i] = THZTensor_(data)(m1_) + i*m1_->stride[0];
+    ptrs[nbatch+i] = THZTensor_(data)(m2_) + i*m2_->stride[0];
+    ptrs[2*nbatch+i] = THZTensor_(data)(r__) + i*r__->stride[0];
+  }
+
+  THZBlas_(gemmBatch)(transpose_m1,
+                      transpose_m2,
+                      r__->size[(transpose_r == 'n' ? 1 : 2)],
+                      r__->size[(transpose_r == 'n' ? 2 : 1)],
+                      m1_->size[(transpose_r == 'n' ? 2 : 1)],
+                      alpha,
+                      ptrs,
+                      (transpose_m1 == 'n' ? m1_->stride[(transpose_r == 'n' ? 2 : 1)] : m1_->stride[(transpose_r == 'n' ? 1 : 2)]),
+                      ptrs + nbatch,
+                      (transpose_m2 == 'n' ? m2_->stride[(transpose_r == 'n' ? 2 : 1)] : m2_->stride[(transpose_r == 'n' ? 1 : 2)]),
+                      beta,
+                      ptrs + 2*nbatch,
+                      r__->stride[(transpose_r == 'n' ? 2 : 1)],
+                      nbatch);
+
+  THFree(ptrs);
+
+  if(m1_ != batch1)
+    THZTensor_(free)(m1_);
+
+  if(m2_ != batch2)
+    THZTensor_(free)(m2_);
+
+  if(r__ != result)
+    THZTensor_(freeCopyTo)(r__, result);
+}
+
+void THZTensor_(addbmm)(THZTensor *result, real beta, THZTensor *t, real alpha, THZTensor *batch1, THZTensor *batch2)
+{
+  THZTensor *matrix1, *matrix2;
+  long batch;
+
+  THArgCheck(batch1->nDimension == 3, 5, "expected 3D tensor");
+  THArgCheck(batch2->nDimension == 3, 6, "expected 3D tensor");
+  THArgCheck(t->nDimension == 2, 3, "expected 2D tensor");
+  THArgCheck(batch1->size[0] == batch2->size[0], 5, "equal number of batches expected");
+  THArgCheck(t->size[0] == batch1->size[1] && t->size[1] == batch2->size[2] && batch1->size[2] == batch2->size[1], 5,
+             "size mismatch");
+
+  if(t != result)
+  {
+    THZTensor_(resizeAs)(result, t);
+    THZTensor_(copy)(result, t);
+  }
+
+  /* the products accumulate into the same matrix, so they go one at a time,
+     each being a full gemm */
+  matrix1 = THZTensor_(new)();
+  matrix2 = THZTensor_(new)();
+  for(batch = 0; batch < batch1->size[0]; batch++)
+  {
+    THZTensor_(select)(matrix1, batch1, 0, batch);
+    THZTensor_(select)(matrix2, batch2, 0, batch);
+    THZTensor_(addmm)(result, beta, result, alpha, matrix1, matrix2);
+    beta = 1;
+  }
+  THZTensor_(free)(matrix1);
+  THZTensor_(free)(matrix2);
+}
+
+/* Products with a real operand. Seen as real numbers, a complex matrix whose
+   rows have unit stride (column-major for BLAS) is a matrix with twice as
+   many rows, real and imaginary parts interleaved, and multiplying it by a
+   real matrix is a single real gemm: half the multiplies of the complex
+   product, and no complex copy of the real operand. */
+
+void THZTensor_(cmulMixed)(THZTensor *r_, THZTensor *t, THRealTensor *src)
+{
+  THZTensor_(resizeAs)(r_, t);
+  if (THZTensor_(isContiguous)(r_) && THZTensor_(isContiguous)(t) && THRealTensor_(isContiguous)(src) && THZTensor_(nElement)(r_) == THRealTensor_(nElement)(src)) {
+      real *tp = THZTensor_(data)(t);
+      realscalar *sp = THRealTensor_(data)(src);
+      real *rp = THZTensor_(data)(r_);
+      long sz = THZTensor_(nElement)(t);
+      long i;
+      #pragma omp parallel for if(sz > THZ_OMP_OVERHEAD_THZRESHOLD) private(i)
+      for (i=0; i<sz; i++)
+        rp[i] = tp[i] * sp[i];
+  } else {
+      THZ_TENSOR_APPLY3(real, r_, real, t, realscalar, src, *r__data = *t_data * *src_data;);
+  }
+}
+
+/* a size0 x size1 matrix whose dimension d has unit stride */
+static THZTensor *THZTensor_(newWithUnitStride)(long size0, long size1, int d)
+{
+  THZTensor *r;
+  if(d == 1)
+    return THZTensor_(newScratchWithSize2d)(size0, size1);
+  r = THZTensor_(newScratchWithSize2d)(size1, size0);
+  THZTensor_(transpose)(r, NULL, 0, 1);
+  return r;
+}
+
+/* m itself when its dimension d has unit stride, a copy laid out so otherwise */
+static THZTensor *THZTensor_(newUnitStrideOf)(THZTensor *m, int d)
+{
+  THZTensor *r;
+  if(m->stride[d] == 1 || m->size[d] == 1)
+  {
+    THZTensor_(retain)(m);
+    return m;
+  }
+  r = THZTensor_(newWithUnitStride)(m->size[0], m->size[1], d);
+  THZTensor_(copy)(r, m);
+  return r;
+}
+
+/* r = alpha*zm*rm + beta*r (d == 0) or alpha*rm*zm + beta*r (d == 1) with
+   real alpha and beta, r and zm having unit stride along dimension d */
+static void THZTensor_(gemmWithReal)(THZTensor *r, realscalar beta, realscalar alpha, THZTensor *zm, THRealTensor *rm, int d)
+{
+  int e = 1-d;
+  char transpose_rm;
+  THRealTensor *rm_;
+
+  if(rm->stride[d] == 1 || rm->size[d] == 1)
+  {
+    transpose_rm = 'n';
+    rm_ = rm;
+  }
+  else if(rm->stride[e] == 1)
+  {
+    transpose_rm = 't';
+    rm_ = rm;
+  }
+  else
+  {
+    transpose_rm = (d == 1 ? 'n' : 't');
+    rm_ = THRealTensor_(newContiguous)(rm);
+  }
+
+  THRealBlas_(gemm)('n',
+                    transpose_rm,
+                    2*r->size[d],
+                    r->size[e],
+                    zm->size[e],
+                    alpha,
+                    (realscalar*)THZTensor_(data)(zm),
+                    2*zm->stride[e],
+                    THRealTensor_(data)(rm_),
+                    (transpose_rm == 'n' ? rm_->stride[e] : rm_->stride[d]),
+                    beta,
+                    (realscalar*)THZTensor_(data)(r),
+                    2*r->stride[e]);
+
+  if(rm_ != rm)
+    THRealTensor_(free)(rm_);
+}
+
+static void THZTensor_(addmmWithReal)(THZTensor *r_, real beta, THZTensor *t, real alpha, THZTensor *zm, THRealTensor *rm, int d)
+{
+  THZTensor *r__, *zm_;
+
+  if(t != r_)
+  {
+    THZTensor_(resizeAs)(r_, t);
+    THZTensor_(copy)(r_, t);
+  }
+
+  r__ = THZTensor_(newUnitStrideOf)(r_, d);
+  zm_ = THZTensor_(newUnitStrideOf)(zm, d);
+
+  if(CIMAG(alpha) == 0 && CIMAG(beta) == 0)
+    THZTensor_(gemmWithReal)(r__, CREAL(beta), CREAL(alpha), zm_, rm, d);
+  else
+  {
+    THZTensor *prod = THZTensor_(newWithUnitStride)(r_->size[0], r_->size[1], d);
+    THZTensor_(gemmWithReal)(prod, 0, 1, zm_, rm, d);
+    if(beta == 0)
+      THZTensor_(mul)(r__, prod, alpha);
+    else
+    {
+      if(beta != 1)
+        THZTensor_(mul)(r__, r__, beta);
+      THZTensor_(cadd)(r__, r__, alpha, prod);
+    }
+    THZTensor_(free)(prod);
+  }
+
+  THZTensor_(free)(zm_);
+  if(r__ != r_)
+    THZTensor_(freeCopyTo)(r__, r_);
+  else
+    THZTensor_(free)(r__);
+}
+
+void THZTensor_(addmmMixedLeft)(THZTensor *r_, real beta, THZTensor *t, real alpha, THRealTensor *m1, THZTensor *m2)
+{
+  if( (m1->nDimension != 2) || (m2->nDimension != 2) )
+    THError("matrix and matrix expected");
+
+  if(t->nDimension != 2)
+    THError("size mismatch");
+
+  if( (t->size[0] != m1->size[0]) || (t->size[1] != m2->size[1]) || (m1->size[1] != m2->size[0]) )
+    THError("size mismatch");
+
+  /* r^T = m2^T * m1^T, with rows of r^T and m2^T going along dimension 1 */
+  THZTensor_(addmmWithReal)(r_, beta, t, alpha, m2, m1, 1);
+}
+
+void THZTensor_(addmmMixedRight)(THZTensor *r_, real beta, THZTensor *t, real alpha, THZTensor *m1, THRealTensor *m2)
+{
+  if( (m1->nDimension != 2) || (m2->nDimension != 2) )
+    THError("matrix and matrix expected");
+
+  if(t->nDimension != 2)
+    THError("size mismatch");
+
+  if( (t->size[0] != m1->size[0]) || (t->size[1] != m2->size[1]) || (m1->size[1] != m2->size[0]) )
+    THError("size mismatch");
+
+  THZTensor_(addmmWithReal)(r_, beta, t, alpha, m1, m2, 0);
+}
+
+void THZTensor_(addmvMixedMat)(THZTensor *r_, real beta, THZTensor *t, real alpha, THRealTensor *mat, THZTensor *vec)
+{
+  if( (mat->nDimension != 2) || (vec->nDimension != 1) )
+    THError("matrix and vector expected");
+
+  if( mat->size[1] != vec->size[0] )
+    THError("size mismatch");
+
+  if(t->nDimension != 1)
+    THError("size mismatch");
+
+  if(t->size[0] != mat->size[0])
+    THError("size mismatch");
+
+  if(r_ != t)
+  {
+    THZTensor_(resizeAs)(r_, t);
+    THZTensor_(copy)(r_, t);
+  }
+
+  /* contiguous vectors read as 2 x n real matrices: r^T = vec^T * mat^T */
+  if(r_->stride[0] == 1 && vec->stride[0] == 1 && (mat->stride[0] == 1 || mat->stride[1] == 1) &&
+     CIMAG(alpha) == 0 && CIMAG(beta) == 0)
+  {
+    char transpose_mat = (mat->stride[1] == 1 ? 'n' : 't');
+    THRealBlas_(gemm)('n', transpose_mat, 2, mat->size[0], mat->size[1],
+                      CREAL(alpha), (realscalar*)THZTensor_(data)(vec), 2,
+                      THRealTensor_(data)(mat), (transpose_mat == 'n' ? mat->stride[0] : mat->stride[1]),
+                      CREAL(beta), (realscalar*)THZTensor_(data)(r_), 2);
+  }
+  else
+  {
+    real *rp = THZTensor_(data)(r_);
+    realscalar *mp = THRealTensor_(data)(mat);
+    real *vp = THZTensor_(data)(vec);
+    long i;
+    #pragma omp parallel for if(THRealTensor_(nElement)(mat) > THZ_OMP_OVERHEAD_THZRESHOLD) private(i)
+    for(i = 0; i < mat->size[0]; i++)
+    {
+      real sum = 0;
+      long l;
+      for(l = 0; l < mat->size[1]; l++)
+        sum += mp[i*mat->stride[0]+l*mat->stride[1]] * vp[l*vec->stride[0]];
+      rp[i*r_->stride[0]] = (beta == 0 ? 0 : beta*rp[i*r_->stride[0]]) + alpha*sum;
+    }
+  }
+}
+
+void THZTensor_(addmvMixedVec)(THZTensor *r_, real beta, THZTensor *t, real alpha, THZTensor *mat, THRealTensor *vec)
+{
+  if( (mat->nDimension != 2) || (vec->nDimension != 1) )
+    THError("matrix and vector expected");
+
+  if( mat->size[1] != vec->size[0] )
+    THError("size mismatch");
+
+  if(t->nDimension != 1)
+    THError("size mismatch");
+
+  if(t->size[0] != mat->size[0])
+    THError("size mismatch");
+
+  if(r_ != t)
+  {
+    THZTensor_(resizeAs)(r_, t);
+    THZTensor_(copy)(r_, t);
+  }
+
+  /* a matrix with unit-stride columns is a real one with twice the rows */
+  if(r_->stride[0] == 1 && mat->stride[0] == 1 && CIMAG(alpha) == 0 && CIMAG(beta) == 0)
+  {
+    THRealBlas_(gemv)('n', 2*mat->size[0], mat->size[1],
+                      CREAL(alpha), (realscalar*)THZTensor_(data)(mat), 2*mat->stride[1],
+                      THRealTensor_(data)(vec), vec->stride[0],
+                      CREAL(beta), (realscalar*)THZTensor_(data)(r_), 1);
+  }
+  else
+  {
+    real *rp = THZTensor_(data)(r_);
+    real *mp = THZTensor_(data)(mat);
+    realscalar *vp = THRealTensor_(data)(vec);
+    long i;
+    #pragma omp parallel for if(THZTensor_(nElement)(mat) > THZ_OMP_OVERHEAD_THZRESHOLD) private(i)
+    for(i = 0; i < mat->size[0]; i++)
+    {
+      real sum = 0;
+      long l;
+      for(l = 0; l < mat->size[1]; l++)
+        sum += mp[i*mat->stride[0]+l*mat->stride[1]] * vp[l*vec->stride[0]];
+      rp[i*r_->stride[0]] = (beta == 0 ? 0 : beta*rp[i*r_->stride[0]]) + alpha*sum;
+    }
+  }
+}
+
 void THZTensor_(addr)(THZTensor *r_, real beta, THZTensor *t, real alpha, THZTensor *vec1, THZTensor *vec2)
 {
   if( (vec1->nDimension != 1) || (vec2->nDimension != 1) )
@@ -529,7 +1048,7 @@ void THZTensor_(addr)(THZTensor *r_, real beta, THZTensor *t, real alpha, THZTen
   {
     THZTensor *cr = r_;
     if(r_->stride[1] != 1)
-      cr = THZTensor_(newClone)(r_);
+      cr = THZTensor_(newScratchClone)(r_);
 
     THZTensor *cvec2 = THZTensor_(new)();
     THZTensor_(conj)(cvec2, vec2);
@@ -582,7 +1101,7 @@ void THZTensor_(addru)(THZTensor *r_, real beta, THZTensor *t, real alpha, THZTe
   }
   else
   {
-    THZTensor *cr = THZTensor_(newClone)(r_);
+    THZTensor *cr = THZTensor_(newScratchClone)(r_);
 
     THZBlas_(geru)(vec2->size[0], vec1->size[0],
                    alpha, THZTensor_(data)(vec2), vec2->stride[0],
@@ -1132,18 +1651,16 @@ void THZTensor_(cat)(THZTensor *r_, THZTensor *ta, THZTensor *tb, int dimension)
     THLongStorage *tsz = THZTensor_(newSizeOf)(t);                      \
     THByteTensor_resize(r_, tsz, NULL);                                 \
     THLongStorage_free(tsz);                                            \
-    THByteTensor_zero(r_);                                              \
-    TH_TENSOR_APPLY2(unsigned char, r_, real, t,                        \
-                     if (CABS(*t_data) OP CABS(value)) *r__data = 1;); \
+    THZ_TENSOR_APPLY2(unsigned char, r_, real, t,                       \
+                      *r__data = (CABS(*t_data) OP CABS(value)););     \
   }                                                                     \
   void THZTensor_(NAME##Tensor)(THByteTensor *r_, THZTensor *ta, THZTensor *tb) \
   {                                                                     \
     THLongStorage *tsz = THZTensor_(newSizeOf)(ta);                     \
     THByteTensor_resize(r_, tsz, NULL);                                 \
     THLongStorage_free(tsz);                                            \
-    THByteTensor_zero(r_);                                              \
-    TH_TENSOR_APPLY3(unsigned char, r_, real, ta, real, tb,             \
-                     if(CABS(*ta_data) OP CABS(*tb_data)) *r__data = 1;); \
+    THZ_TENSOR_APPLY3(unsigned char, r_, real, ta, real, tb,            \
+                      *r__data = (CABS(*ta_data) OP CABS(*tb_data));); \
   }                                                                     \
 
 
@@ -1154,22 +1671,82 @@ TENSOR_IMPLEMENT_LOGICAL(ge,>=)
 TENSOR_IMPLEMENT_LOGICAL(eq,==)
 TENSOR_IMPLEMENT_LOGICAL(ne,!=)
 
+/* fast math mode (THZVector.h): contiguous tensors go through a
+   THZVector_(fast*) kernel, block by block */
+static int THZTensor_(canFastMap)(THZTensor *r_, THZTensor *t)
+{
+  return THZVector_fastMath() && THZTensor_(isContiguous)(r_) && THZTensor_(isContiguous)(t)
+    && THZTensor_(nElement)(r_) == THZTensor_(nElement)(t);
+}
+
+static void THZTensor_(fastMap)(THZTensor *r_, THZTensor *t,
+                                void (*kernel)(real *, const real *, const long))
+{
+  real *tp = THZTensor_(data)(t);
+  real *rp = THZTensor_(data)(r_);
+  long sz = THZTensor_(nElement)(t);
+  long nblocks = (sz + THZ_VECTOR_BLOCK - 1) / THZ_VECTOR_BLOCK;
+  long b;
+  #pragma omp parallel for if(sz > THZ_OMP_OVERHEAD_THZRESHOLD) private(b)
+  for (b=0; b<nblocks; b++) {
+      long off = b*THZ_VECTOR_BLOCK;
+      kernel(rp+off, tp+off, THMin(THZ_VECTOR_BLOCK, sz-off));
+  }
+}
+
+/* same for the kernels with real results, written to the scalars rp[i], or
+   to the complex numbers ((real*)rp)[i] if asComplex */
+static void THZTensor_(fastMapReal)(realscalar *rp, int asComplex, THZTensor *t,
+                                    void (*kernel)(realscalar *, const real *, const long))
+{
+  real *tp = THZTensor_(data)(t);
+  long sz = THZTensor_(nElement)(t);
+  long nblocks = (sz + THZ_VECTOR_BLOCK - 1) / THZ_VECTOR_BLOCK;
+  long b;
+  #pragma omp parallel for if(sz > THZ_OMP_OVERHEAD_THZRESHOLD) private(b)
+  for (b=0; b<nblocks; b++) {
+      long off = b*THZ_VECTOR_BLOCK;
+      long n = THMin(THZ_VECTOR_BLOCK, sz-off);
+      if (asComplex) {
+          realscalar buffer[THZ_VECTOR_BLOCK];
+          long i;
+          kernel(buffer, tp+off, n);
+          for (i=0; i<n; i++)
+              ((real*)rp)[off+i] = buffer[i];
+      } else
+          kernel(rp+off, tp+off, n);
+  }
+}
+
 #define LAB_IMPLEMENT_BASIC_FUNCTION(NAME, CFUNC)                       \
   void THZTensor_(NAME)(THZTensor *r_, THZTensor *t)                    \
   {                                                                     \
     THZTensor_(resizeAs)(r_, t);                                        \
-    TH_TENSOR_APPLY2(real, t, real, r_, *r__data = CFUNC(*t_data););    \
+    THZ_TENSOR_APPLY2(real, t, real, r_, *r__data = CFUNC(*t_data););   \
+  }                                                                     \
+
+#define LAB_IMPLEMENT_FAST_FUNCTION(NAME, CFUNC, KERNEL)                \
+  void THZTensor_(NAME)(THZTensor *r_, THZTensor *t)                    \
+  {                                                                     \
+    THZTensor_(resizeAs)(r_, t);                                        \
+    if (THZTensor_(canFastMap)(r_, t))                                  \
+      THZTensor_(fastMap)(r_, t, THZVector_(KERNEL));                   \
+    else                                                                \
+      THZ_TENSOR_APPLY2(real, t, real, r_, *r__data = CFUNC(*t_data);); \
   }                                                                     \
 
-#define LAB_IMPLEMENT_BASIC_FUNCTION_VALUE(NAME, CFUNC)                 \
-  void THZTensor_(NAME)(THZTensor *r_, THZTensor *t, real value)        \
+#define LAB_IMPLEMENT_FAST_FUNCTION_REAL(NAME, CFUNC, KERNEL)           \
+  void THZTensor_(NAME)(THZTensor *r_, THZTensor *t)                    \
   {                                                                     \
     THZTensor_(resizeAs)(r_, t);                                        \
-    TH_TENSOR_APPLY2(real, t, real, r_, *r__data = CFUNC(*t_data, value);); \
+    if (THZTensor_(canFastMap)(r_, t))                                  \
+      THZTensor_(fastMapReal)((realscalar*)THZTensor_(data)(r_), 1, t, THZVector_(KERNEL)); \
+    else                                                                \
+      THZ_TENSOR_APPLY2(real, t, real, r_, *r__data = CFUNC(*t_data);); \
   }                                                                     \
 
-LAB_IMPLEMENT_BASIC_FUNCTION(log,CLOG)
-LAB_IMPLEMENT_BASIC_FUNCTION(exp,CEXP)
+LAB_IMPLEMENT_FAST_FUNCTION(log,CLOG,fastLog)
+LAB_IMPLEMENT_FAST_FUNCTION(exp,CEXP,fastExp)
 LAB_IMPLEMENT_BASIC_FUNCTION(cos,CCOS)
 LAB_IMPLEMENT_BASIC_FUNCTION(acos,CACOS)
 LAB_IMPLEMENT_BASIC_FUNCTION(cosh,CACOSH)
@@ -1179,22 +1756,40 @@ LAB_IMPLEMENT_BASIC_FUNCTION(sinh,CSINH)
 LAB_IMPLEMENT_BASIC_FUNCTION(tan,CTAN)
 LAB_IMPLEMENT_BASIC_FUNCTION(atan,CATAN)
 LAB_IMPLEMENT_BASIC_FUNCTION(tanh,CTANH)
-LAB_IMPLEMENT_BASIC_FUNCTION_VALUE(pow,CPOW)
-LAB_IMPLEMENT_BASIC_FUNCTION(sqrt,CSQRT)
+LAB_IMPLEMENT_FAST_FUNCTION(sqrt,CSQRT,fastSqrt)
 LAB_IMPLEMENT_BASIC_FUNCTION(conj,CONJ)
 LAB_IMPLEMENT_BASIC_FUNCTION(proj,CPROJ)
-LAB_IMPLEMENT_BASIC_FUNCTION(zabs,CABS)
-LAB_IMPLEMENT_BASIC_FUNCTION(zarg,CARG)
+LAB_IMPLEMENT_FAST_FUNCTION_REAL(zabs,CABS,fastAbs)
+LAB_IMPLEMENT_FAST_FUNCTION_REAL(zarg,CARG,fastArg)
 LAB_IMPLEMENT_BASIC_FUNCTION(zre,CREAL)
 LAB_IMPLEMENT_BASIC_FUNCTION(zim,CIMAG)
 
+void THZTensor_(pow)(THZTensor *r_, THZTensor *t, real value)
+{
+  THZTensor_(resizeAs)(r_, t);
+  if (THZTensor_(canFastMap)(r_, t)) {
+      real *tp = THZTensor_(data)(t);
+      real *rp = THZTensor_(data)(r_);
+      long sz = THZTensor_(nElement)(t);
+      long nblocks = (sz + THZ_VECTOR_BLOCK - 1) / THZ_VECTOR_BLOCK;
+      long b;
+      #pragma omp parallel for if(sz > THZ_OMP_OVERHEAD_THZRESHOLD) private(b)
+      for (b=0; b<nblocks; b++) {
+          long off = b*THZ_VECTOR_BLOCK;
+          THZVector_(fastPow)(rp+off, tp+off, value, THMin(THZ_VECTOR_BLOCK, sz-off));
+      }
+  } else {
+      THZ_TENSOR_APPLY2(real, t, real, r_, *r__data = CPOW(*t_data, value););
+  }
+}
+
 #define LAB_IMPLEMENT_BASIC_FUNCTION_RETURN_FLOAT(NAME, CFUNC)          \
   void THZTensor_(NAME)(THFloatTensor *r, THZTensor *t)                 \
   {                                                                     \
     THLongStorage *tsz = THZTensor_(newSizeOf)(t);                      \
     THFloatTensor_resize(r, tsz, NULL);                                 \
     THLongStorage_free(tsz);                                            \
-    TH_TENSOR_APPLY2(real, t, float, r, *r_data = CFUNC(*t_data););     \
+    THZ_TENSOR_APPLY2(real, t, float, r, *r_data = CFUNC(*t_data););    \
   }
 #define LAB_IMPLEMENT_BASIC_FUNCTION_RETURN_DOUBLE(NAME, CFUNC)         \
   void THZTensor_(NAME)(THDoubleTensor *r, THZTensor *t)                \
@@ -1202,18 +1797,231 @@ LAB_IMPLEMENT_BASIC_FUNCTION(zim,CIMAG)
     THLongStorage *tsz = THZTensor_(newSizeOf)(t);                      \
     THDoubleTensor_resize(r, tsz, NULL);                                \
     THLongStorage_free(tsz);                                            \
-    TH_TENSOR_APPLY2(real, t, double, r, *r_data = CFUNC(*t_data););    \
+    THZ_TENSOR_APPLY2(real, t, double, r, *r_data = CFUNC(*t_data););   \
+  }
+
+/* the fast kernels write scalars of the precision of the tensor: the fast
+   path is Float_abs for ZFloatTensor and Double_abs for ZDoubleTensor */
+#define LAB_IMPLEMENT_FAST_FUNCTION_RETURN_FLOAT(NAME, CFUNC, KERNEL)   \
+  void THZTensor_(NAME)(THFloatTensor *r, THZTensor *t)                 \
+  {                                                                     \
+    THLongStorage *tsz = THZTensor_(newSizeOf)(t);                      \
+    THFloatTensor_resize(r, tsz, NULL);                                 \
+    THLongStorage_free(tsz);                                            \
+    if (sizeof(realscalar) == sizeof(float) && THZVector_fastMath()     \
+        && THFloatTensor_isContiguous(r) && THZTensor_(isContiguous)(t)) \
+      THZTensor_(fastMapReal)((realscalar*)THFloatTensor_data(r), 0, t, THZVector_(KERNEL)); \
+    else                                                                \
+      THZ_TENSOR_APPLY2(real, t, float, r, *r_data = CFUNC(*t_data);); \
+  }
+#define LAB_IMPLEMENT_FAST_FUNCTION_RETURN_DOUBLE(NAME, CFUNC, KERNEL)  \
+  void THZTensor_(NAME)(THDoubleTensor *r, THZTensor *t)                \
+  {                                                                     \
+    THLongStorage *tsz = THZTensor_(newSizeOf)(t);                      \
+    THDoubleTensor_resize(r, tsz, NULL);                                \
+    THLongStorage_free(tsz);                                            \
+    if (sizeof(realscalar) == sizeof(double) && THZVector_fastMath()    \
+        && THDoubleTensor_isContiguous(r) && THZTensor_(isContiguous)(t)) \
+      THZTensor_(fastMapReal)((realscalar*)THDoubleTensor_data(r), 0, t, THZVector_(KERNEL)); \
+    else                                                                \
+      THZ_TENSOR_APPLY2(real, t, double, r, *r_data = CFUNC(*t_data);); \
   }
 
-LAB_IMPLEMENT_BASIC_FUNCTION_RETURN_FLOAT(Float_abs,CABS)
-LAB_IMPLEMENT_BASIC_FUNCTION_RETURN_FLOAT(Float_arg,CARG)
+LAB_IMPLEMENT_FAST_FUNCTION_RETURN_FLOAT(Float_abs,CABS,fastAbs)
+LAB_IMPLEMENT_FAST_FUNCTION_RETURN_FLOAT(Float_arg,CARG,fastArg)
 LAB_IMPLEMENT_BASIC_FUNCTION_RETURN_FLOAT(Float_re,CREAL)
 LAB_IMPLEMENT_BASIC_FUNCTION_RETURN_FLOAT(Float_im,CIMAG)
-LAB_IMPLEMENT_BASIC_FUNCTION_RETURN_DOUBLE(Double_abs,CABS)
-LAB_IMPLEMENT_BASIC_FUNCTION_RETURN_DOUBLE(Double_arg,CARG)
+LAB_IMPLEMENT_FAST_FUNCTION_RETURN_DOUBLE(Double_abs,CABS,fastAbs)
+LAB_IMPLEMENT_FAST_FUNCTION_RETURN_DOUBLE(Double_arg,CARG,fastArg)
 LAB_IMPLEMENT_BASIC_FUNCTION_RETURN_DOUBLE(Double_re,CREAL)
 LAB_IMPLEMENT_BASIC_FUNCTION_RETURN_DOUBLE(Double_im,CIMAG)
 
+/* magnitude and phase in one pass over src */
+void THZTensor_(polar)(THRealTensor *mag, THRealTensor *phase, THZTensor *src)
+{
+  THLongStorage *size;
+  THArgCheck(mag != phase, 2, "magnitude and phase must be different tensors");
+  size = THZTensor_(newSizeOf)(src);
+  THRealTensor_(resize)(mag, size, NULL);
+  THRealTensor_(resize)(phase, size, NULL);
+  THLongStorage_free(size);
+
+  if (THRealTensor_(isContiguous)(mag) && THRealTensor_(isContiguous)(phase) && THZTensor_(isContiguous)(src)) {
+      realscalar *mp = THRealTensor_(data)(mag);
+      realscalar *pp = THRealTensor_(data)(phase);
+      real *sp = THZTensor_(data)(src);
+      long sz = THZTensor_(nElement)(src);
+      long nblocks = (sz + THZ_VECTOR_BLOCK - 1) / THZ_VECTOR_BLOCK;
+      int fast = THZVector_fastMath();
+      long b;
+      #pragma omp parallel for if(sz > THZ_OMP_OVERHEAD_THZRESHOLD) private(b)
+      for (b=0; b<nblocks; b++) {
+          long off = b*THZ_VECTOR_BLOCK;
+          long n = THMin(THZ_VECTOR_BLOCK, sz-off);
+          long i;
+          if (fast) {
+              /* the second kernel reads the block from cache */
+              THZVector_(fastAbs)(mp+off, sp+off, n);
+              THZVector_(fastArg)(pp+off, sp+off, n);
+          } else {
+              for (i=off; i<off+n; i++) {
+                  mp[i] = CABS(sp[i]);
+                  pp[i] = CARG(sp[i]);
+              }
+          }
+      }
+  } else {
+    THZ_TENSOR_APPLY3(realscalar, mag, realscalar, phase, real, src,
+                      *mag_data = CABS(*src_data);
+                      *phase_data = CARG(*src_data););
+  }
+}
+
+/* r_ = mag e^(i phase) */
+void THZTensor_(fromPolar)(THZTensor *r_, THRealTensor *mag, THRealTensor *phase)
+{
+  THLongStorage *size;
+  THArgCheck(THRealTensor_(isSameSizeAs)(mag, phase), 3, "magnitude and phase must have the same size");
+  size = THRealTensor_(newSizeOf)(mag);
+  THZTensor_(resize)(r_, size, NULL);
+  THLongStorage_free(size);
+
+  if (THZTensor_(isContiguous)(r_) && THRealTensor_(isContiguous)(mag) && THRealTensor_(isContiguous)(phase)) {
+      realscalar *mp = THRealTensor_(data)(mag);
+      realscalar *pp = THRealTensor_(data)(phase);
+      real *rp = THZTensor_(data)(r_);
+      long sz = THZTensor_(nElement)(r_);
+      long nblocks = (sz + THZ_VECTOR_BLOCK - 1) / THZ_VECTOR_BLOCK;
+      int fast = THZVector_fastMath();
+      long b;
+      #pragma omp parallel for if(sz > THZ_OMP_OVERHEAD_THZRESHOLD) private(b)
+      for (b=0; b<nblocks; b++) {
+          long off = b*THZ_VECTOR_BLOCK;
+          long n = THMin(THZ_VECTOR_BLOCK, sz-off);
+          long i;
+          if (fast)
+              THZVector_(fastFromPolar)(rp+off, mp+off, pp+off, n);
+          else
+              for (i=off; i<off+n; i++)
+                  rp[i] = mp[i] * CEXP(pp[i]*I);
+      }
+  } else {
+    THZ_TENSOR_APPLY3(real, r_, realscalar, mag, realscalar, phase,
+                      *r__data = *mag_data * CEXP(*phase_data*I););
+  }
+}
+
+void THZTensor_(abs2)(THRealTensor *r_, THZTensor *t)
+{
+  THLongStorage *size = THZTensor_(newSizeOf)(t);
+  THRealTensor_(resize)(r_, size, NULL);
+  THLongStorage_free(size);
+
+  if (THRealTensor_(isContiguous)(r_) && THZTensor_(isContiguous)(t)) {
+      realscalar *rp = THRealTensor_(data)(r_);
+      real *tp = THZTensor_(data)(t);
+      long sz = THZTensor_(nElement)(t);
+      long nblocks = (sz + THZ_VECTOR_BLOCK - 1) / THZ_VECTOR_BLOCK;
+      long b;
+      #pragma omp parallel for if(sz > THZ_OMP_OVERHEAD_THZRESHOLD) private(b)
+      for (b=0; b<nblocks; b++) {
+          long off = b*THZ_VECTOR_BLOCK;
+          THZVector_(abs2)(rp+off, tp+off, THMin(THZ_VECTOR_BLOCK, sz-off));
+      }
+  } else {
+    THZ_TENSOR_APPLY2(realscalar, r_, real, t,
+                      *r__data = CREAL(*t_data)*CREAL(*t_data) + CIMAG(*t_data)*CIMAG(*t_data););
+  }
+}
+
+void THZTensor_(sumAbs2)(THRealTensor *r_, THZTensor *t, int dimension)
+{
+  THLongStorage *dim;
+
+  THArgCheck(dimension >= 0 && dimension < THZTensor_(nDimension)(t), 3, "dimension out of range");
+
+  dim = THZTensor_(newSizeOf)(t);
+  THLongStorage_set(dim, dimension, 1);
+  THRealTensor_(resize)(r_, dim, NULL);
+  THLongStorage_free(dim);
+
+  if (THZTensor_(isContiguous)(t) && THRealTensor_(isContiguous)(r_)) {
+      /* t is [outer][size][inner] and r_ [outer][inner] */
+      real *tp = THZTensor_(data)(t);
+      realscalar *rp = THRealTensor_(data)(r_);
+      long sz = THZTensor_(nElement)(t);
+      long size = t->size[dimension];
+      long outer = 1, inner = 1;
+      int d;
+      for (d=0; d<dimension; d++)
+          outer *= t->size[d];
+      for (d=dimension+1; d<t->nDimension; d++)
+          inner *= t->size[d];
+
+      if (inner == 1) {
+          long o;
+          #pragma omp parallel for if(sz > THZ_OMP_OVERHEAD_THZRESHOLD) private(o)
+          for (o=0; o<outer; o++)
+              rp[o] = (realscalar)THZVector_(sumAbs2)(tp+o*size, size);
+      } else {
+          /* blocks of columns, each summed down the dimension */
+          long nblocks = (inner + THZ_VECTOR_BLOCK - 1) / THZ_VECTOR_BLOCK;
+          long b;
+          #pragma omp parallel for if(sz > THZ_OMP_OVERHEAD_THZRESHOLD) private(b)
+          for (b=0; b<outer*nblocks; b++) {
+              long o = b / nblocks;
+              long off = (b % nblocks)*THZ_VECTOR_BLOCK;
+              long n = THMin(THZ_VECTOR_BLOCK, inner-off);
+              accrealscalar acc[THZ_VECTOR_BLOCK];
+              long i, k;
+              for (i=0; i<n; i++)
+                  acc[i] = 0;
+              for (k=0; k<size; k++)
+                  THZVector_(addAbs2)(acc, tp+(o*size+k)*inner+off, n);
+              for (i=0; i<n; i++)
+                  rp[o*inner+off+i] = (realscalar)acc[i];
+          }
+      }
+  } else {
+    TH_TENSOR_DIM_APPLY2(real, t, realscalar, r_, dimension,
+                         accrealscalar sum = 0;
+                         long i;
+                         (void)r__stride;
+                         for(i = 0; i < t_size; i++)
+                         {
+                           real z = t_data[i*t_stride];
+                           sum += (accrealscalar)CREAL(z)*CREAL(z) + (accrealscalar)CIMAG(z)*CIMAG(z);
+                         }
+                         *r__data = (realscalar)sum;);
+  }
+}
+
+accrealscalar THZTensor_(sumAbs2all)(THZTensor *t)
+{
+  accrealscalar sum = 0;
+  if (THZTensor_(isContiguous)(t)) {
+      real *tp = THZTensor_(data)(t);
+      long sz = THZTensor_(nElement)(t);
+      long nblocks = (sz + THZ_VECTOR_BLOCK - 1) / THZ_VECTOR_BLOCK;
+      accrealscalar *partial = THAlloc(sizeof(accrealscalar)*nblocks);
+      long b;
+      #pragma omp parallel for if(sz > THZ_OMP_OVERHEAD_THZRESHOLD) private(b)
+      for (b=0; b<nblocks; b++) {
+          long off = b*THZ_VECTOR_BLOCK;
+          partial[b] = THZVector_(sumAbs2)(tp+off, THMin(THZ_VECTOR_BLOCK, sz-off));
+      }
+      /* in block order, so that the result does not depend on the threads */
+      for (b=0; b<nblocks; b++)
+        sum += partial[b];
+      THFree(partial);
+      return sum;
+  }
+  TH_TENSOR_APPLY(real, t,
+                  sum += (accrealscalar)CREAL(*t_data)*CREAL(*t_data)
+                       + (accrealscalar)CIMAG(*t_data)*CIMAG(*t_data););
+  return sum;
+}
+
 
 void THZTensor_(mean)(THZTensor *r_, THZTensor *t, int dimension)
 {
@@ -1332,6 +2140,17 @@ void THZTensor_(norm)(THZTensor *r_, THZTensor *t, real value, int dimension)
                          for(i = 0; i < t_size; i++)
                            sum += t_data[i*t_stride] != 0.0;
                          *r__data = sum;)
+  } else if(value == 2) {
+    TH_TENSOR_DIM_APPLY2(real, t, real, r_, dimension,
+                         accrealscalar sum = 0;
+                         long i;
+                         (void)r__stride;
+                         for(i = 0; i < t_size; i++)
+                         {
+                           real z = t_data[i*t_stride];
+                           sum += (accrealscalar)CREAL(z)*CREAL(z) + (accrealscalar)CIMAG(z)*CIMAG(z);
+                         }
+                         *r__data = (real)sqrt(sum);)
   } else {
     TH_TENSOR_DIM_APPLY2(real, t, real, r_, dimension,
                          accreal sum = 0;
@@ -1352,8 +2171,7 @@ accreal THZTensor_(normall)(THZTensor *tensor, real value)
     TH_TENSOR_APPLY(real, tensor, sum += CABS(*tensor_data););
     return sum;
   } else if(value == 2) {
-    TH_TENSOR_APPLY(real, tensor, accreal z = *tensor_data; sum += z*z;);
-    return csqrt(sum);
+    return sqrt(THZTensor_(sumAbs2all)(tensor));
   } else {
     TH_TENSOR_APPLY(real, tensor, sum += pow(CABS(*tensor_data), value););
     return cpow(sum, 1.0/value);
@@ -1395,7 +2213,7 @@ void THZTensor_(renorm)(THZTensor *res, THZTensor *src, real value, int dimensio
     {
       new_norm = maxnorm / (norm + 1e-7);
 
-      TH_TENSOR_APPLY2(
+      THZ_TENSOR_APPLY2(
         real, rowR, real, rowS,
         *rowR_data = (*rowS_data) * new_norm;
       )
@@ -22,6 +22,7 @@ THZ_API void THZTensor_(indexSelect)(THZTensor *tensor, THZTensor *src, int dim,
 THZ_API void THZTensor_(indexCopy)(THZTensor *tensor, int dim, THLongTensor *index, THZTensor *src);
 THZ_API void THZTensor_(indexFill)(THZTensor *tensor, int dim, THLongTensor *index, real val);
 
+/* the sum of t * conj(src) */
 THZ_API accreal THZTensor_(dot)(THZTensor *t, THZTensor *src);
 
 THZ_API real THZTensor_(minall)(THZTensor *t);
@@ -34,13 +35,30 @@ THZ_API void THZTensor_(div)(THZTensor *r_, THZTensor *t, real value);
 
 THZ_API void THZTensor_(cadd)(THZTensor *r_, THZTensor *t, real value, THZTensor *src);
 THZ_API void THZTensor_(cmul)(THZTensor *r_, THZTensor *t, THZTensor *src);
+/* r_ = t * conj(src), in one pass */
+THZ_API void THZTensor_(cmulconj)(THZTensor *r_, THZTensor *t, THZTensor *src);
 THZ_API void THZTensor_(cdiv)(THZTensor *r_, THZTensor *t, THZTensor *src);
 
 THZ_API void THZTensor_(addcmul)(THZTensor *r_, THZTensor *t, real value, THZTensor *src1, THZTensor *src2);
+/* r_ = t + value * src1 * conj(src2), in one pass */
+THZ_API void THZTensor_(addcmulconj)(THZTensor *r_, THZTensor *t, real value, THZTensor *src1, THZTensor *src2);
 THZ_API void THZTensor_(addcdiv)(THZTensor *r_, THZTensor *t, real value, THZTensor *src1, THZTensor *src2);
 
 THZ_API void THZTensor_(addmv)(THZTensor *r_, real beta, THZTensor *t, real alpha, THZTensor *mat,  THZTensor *vec);
 THZ_API void THZTensor_(addmm)(THZTensor *r_, real beta, THZTensor *t, real alpha, THZTensor *mat1, THZTensor *mat2);
+THZ_API void THZTensor_(addmm3m)(THZTensor *r_, real beta, THZTensor *t, real alpha, THZTensor *mat1, THZTensor *mat2);
+THZ_API void THZTensor_(addmmBlocked)(THZTensor *r_, real beta, THZTensor *t, real alpha, THZTensor *mat1, THZTensor *mat2);
+THZ_API void THZTensor_(baddbmm)(THZTensor *result, real beta, THZTensor *t, real alpha, THZTensor *batch1, THZTensor *batch2);
+THZ_API void THZTensor_(addbmm)(THZTensor *result, real beta, THZTensor *t, real alpha, THZTensor *batch1, THZTensor *batch2);
+
+/* products of a complex and a real operand, the real one being used as is
+   rather than promoted to complex */
+THZ_API void THZTensor_(cmulMixed)(THZTensor *r_, THZTensor *t, THRealTensor *src);
+THZ_API void THZTensor_(addmvMixedMat)(THZTensor *r_, real beta, THZTensor *t, real alpha, THRealTensor *mat, THZTensor *vec);
+THZ_API void THZTensor_(addmvMixedVec)(THZTensor *r_, real beta, THZTensor *t, real alpha, THZTensor *mat, THRealTensor *vec);
+THZ_API void THZTensor_(addmmMixedLeft)(THZTensor *r_, real beta, THZTensor *t, real alpha, THRealTensor *mat1, THZTensor *mat2);
+THZ_API void THZTensor_(addmmMixedRight)(THZTensor *r_, real beta, THZTensor *t, real alpha, THZTensor *mat1, THRealTensor *mat2);
+
 THZ_API void THZTensor_(addr)(THZTensor *r_,  real beta, THZTensor *t, real alpha, THZTensor *vec1, THZTensor *vec2);
 
 THZ_API void THZTensor_(match)(THZTensor *r_, THZTensor *m1, THZTensor *m2, real gain);
@@ -123,4 +141,12 @@ THZ_API void THZTensor_(Double_arg)(THDoubleTensor *r_, THZTensor *t);
 THZ_API void THZTensor_(Double_re)(THDoubleTensor *r_, THZTensor *t);
 THZ_API void THZTensor_(Double_im)(THDoubleTensor *r_, THZTensor *t);
 
+THZ_API void THZTensor_(polar)(THRealTensor *mag, THRealTensor *phase, THZTensor *src);
+THZ_API void THZTensor_(fromPolar)(THZTensor *r_, THRealTensor *mag, THRealTensor *phase);
+
+/* |t|^2 elementwise, and its sums along a dimension and over the tensor */
+THZ_API void THZTensor_(abs2)(THRealTensor *r_, THZTensor *t);
+THZ_API void THZTensor_(sumAbs2)(THRealTensor *r_, THZTensor *t, int dimension);
+THZ_API accrealscalar THZTensor_(sumAbs2all)(THZTensor *t);
+
 #endif
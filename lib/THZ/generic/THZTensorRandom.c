@@ -0,0 +1,135 @@
+/**
+ * Copyright (c) 2015-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#ifndef THZ_GENERIC_FILE
+#define THZ_GENERIC_FILE "generic/THZTensorRandom.c"
+#else
+
+/* A Philox block yields four 24 bit uniforms for floats, two 53 bit ones
+   for doubles. Element i of a fill takes uniforms 2i and 2i+1. */
+#if defined(THZ_REAL_IS_FLOAT)
+#define THZ_RANDOM_PER_BLOCK 4
+#else
+#define THZ_RANDOM_PER_BLOCK 2
+#endif
+
+/* u[0..n) = uniforms pos..pos+n-1 of the fill starting at counter first */
+static void THZTensor_(uniforms)(uint64_t first, uint64_t key, long pos, long n, realscalar *u)
+{
+  uint32_t w[4];
+  long j = 0;
+
+  while(j < n)
+  {
+    long word = (pos+j) % THZ_RANDOM_PER_BLOCK;
+    THZRandom_philox(first + (pos+j)/THZ_RANDOM_PER_BLOCK, key, w);
+    for(; word < THZ_RANDOM_PER_BLOCK && j < n; word++, j++)
+    {
+#if defined(THZ_REAL_IS_FLOAT)
+      u[j] = THZRandom_toFloat(w[word]);
+#else
+      u[j] = THZRandom_toDouble(w[2*word], w[2*word+1]);
+#endif
+    }
+  }
+}
+
+/* maps the n elements z[i*stride], holding uniforms as their real and
+   imaginary parts, to the distribution of kind:
+   'u' uniform in [p1, p2), 'n' normal N(p1, p2^2) per part,
+   'c' circular normal around c with E|z - c|^2 = p2^2 */
+static void THZTensor_(fromUniforms)(real *z, long n, long stride, char kind, accrealscalar p1, accrealscalar p2, real c)
+{
+  long i;
+
+  switch(kind)
+  {
+    case 'u':
+      for(i = 0; i < n; i++)
+      {
+        real v = z[i*stride];
+        z[i*stride] = (p1 + (p2-p1)*CREAL(v)) + (p1 + (p2-p1)*CIMAG(v))*I;
+      }
+      break;
+    case 'n':
+      /* Box-Muller; 1-u is in (0, 1] */
+      for(i = 0; i < n; i++)
+      {
+        real v = z[i*stride];
+        accrealscalar r = p2*sqrt(-2*log(1-CREAL(v)));
+        accrealscalar t = 2*M_PI*CIMAG(v);
+        z[i*stride] = (p1 + r*cos(t)) + (p1 + r*sin(t))*I;
+      }
+      break;
+    case 'c':
+      for(i = 0; i < n; i++)
+      {
+        real v = z[i*stride];
+        accrealscalar r = p2*sqrt(-log(1-CREAL(v)));
+        accrealscalar t = 2*M_PI*CIMAG(v);
+        z[i*stride] = c + r*cos(t) + r*sin(t)*I;
+      }
+      break;
+  }
+}
+
+/* uniforms are drawn in place, a chunk at a time, then transformed while
+   the chunk is still in cache */
+static void THZTensor_(randomFill)(THZTensor *self, char kind, accrealscalar p1, accrealscalar p2, real c)
+{
+  long n = THZTensor_(nElement)(self);
+  uint64_t key;
+  uint64_t first = THZRandom_reserve((2*n + THZ_RANDOM_PER_BLOCK - 1)/THZ_RANDOM_PER_BLOCK, &key);
+
+  if(n == 0)
+    return;
+
+  if(THZTensor_(isContiguous)(self))
+  {
+    real *data = THZTensor_(data)(self);
+    long nchunks = (n + THZ_RANDOM_CHUNK - 1)/THZ_RANDOM_CHUNK;
+    long chunk;
+#pragma omp parallel for if(n > THZ_RANDOM_OMP_THRESHOLD) private(chunk)
+    for(chunk = 0; chunk < nchunks; chunk++)
+    {
+      long begin = chunk*THZ_RANDOM_CHUNK;
+      long len = THMin(THZ_RANDOM_CHUNK, n-begin);
+      THZTensor_(uniforms)(first, key, 2*begin, 2*len, (realscalar*)(data+begin));
+      THZTensor_(fromUniforms)(data+begin, len, 1, kind, p1, p2, c);
+    }
+  }
+  else
+  {
+    THZ_TENSOR_APPLY(real, self,
+                     THZTensor_(uniforms)(first, key, 2*THZ_APPLY_INDEX, 2, (realscalar*)self_data);
+                     THZTensor_(fromUniforms)(self_data, 1, 1, kind, p1, p2, c););
+  }
+}
+
+void THZTensor_(uniform)(THZTensor *self, accrealscalar a, accrealscalar b)
+{
+  THArgCheck(a <= b, 3, "lower bound must not exceed upper bound");
+  THZTensor_(randomFill)(self, 'u', a, b, 0);
+}
+
+void THZTensor_(normal)(THZTensor *self, accrealscalar mean, accrealscalar stdv)
+{
+  THArgCheck(stdv >= 0, 3, "standard deviation must be non-negative");
+  THZTensor_(randomFill)(self, 'n', mean, stdv, 0);
+}
+
+void THZTensor_(complexNormal)(THZTensor *self, real mean, accrealscalar stdv)
+{
+  THArgCheck(stdv >= 0, 3, "standard deviation must be non-negative");
+  THZTensor_(randomFill)(self, 'c', 0, stdv, mean);
+}
+
+#undef THZ_RANDOM_PER_BLOCK
+
+#endif
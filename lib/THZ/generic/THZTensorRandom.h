@@ -0,0 +1,25 @@
+/**
+ * Copyright (c) 2015-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#ifndef THZ_GENERIC_FILE
+#define THZ_GENERIC_FILE "generic/THZTensorRandom.h"
+#else
+
+/* Random fills, drawn from the Philox stream of THZRandom.h straight into
+   the tensor. For a given seed the values only depend on the sequence of
+   fills, not on the number of threads.
+
+   uniform:       real and imaginary parts uniform in [a, b)
+   normal:        real and imaginary parts independent N(mean, stdv^2)
+   complexNormal: circularly symmetric around mean, E|z - mean|^2 = stdv^2 */
+THZ_API void THZTensor_(uniform)(THZTensor *self, accrealscalar a, accrealscalar b);
+THZ_API void THZTensor_(normal)(THZTensor *self, accrealscalar mean, accrealscalar stdv);
+THZ_API void THZTensor_(complexNormal)(THZTensor *self, real mean, accrealscalar stdv);
+
+#endif
@@ -90,4 +90,39 @@ static THZ_INLINE void THZVector_(mul)(real *y, const real *x, const long n)
     y[i] *= x[i];
 }
 
+/* |x|^2 from the real and imaginary parts, without the square root of abs
+   or a complex product: z[i] = |x[i]|^2, z[i] += |x[i]|^2, and the sum of
+   the |x[i]|^2 */
+static THZ_INLINE void THZVector_(abs2)(realscalar *z, const real *x, const long n)
+{
+  const realscalar *xp = (const realscalar*)x;
+  long i;
+
+  #pragma omp simd
+  for(i = 0; i < n; i++)
+    z[i] = xp[2*i]*xp[2*i] + xp[2*i+1]*xp[2*i+1];
+}
+
+static THZ_INLINE void THZVector_(addAbs2)(accrealscalar *z, const real *x, const long n)
+{
+  const realscalar *xp = (const realscalar*)x;
+  long i;
+
+  #pragma omp simd
+  for(i = 0; i < n; i++)
+    z[i] += (accrealscalar)xp[2*i]*xp[2*i] + (accrealscalar)xp[2*i+1]*xp[2*i+1];
+}
+
+static THZ_INLINE accrealscalar THZVector_(sumAbs2)(const real *x, const long n)
+{
+  const realscalar *xp = (const realscalar*)x;
+  accrealscalar sum = 0;
+  long i;
+
+  #pragma omp simd reduction(+:sum)
+  for(i = 0; i < 2*n; i++)
+    sum += (accrealscalar)xp[i]*xp[i];
+  return sum;
+}
+
 #endif
@@ -0,0 +1,240 @@
+/**
+ * Copyright (c) 2015-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#ifndef THZ_GENERIC_FILE
+#define THZ_GENERIC_FILE "generic/THZVectorDispatch.c"
+#else
+
+/* Portable fallbacks, also used for machines without any of the SIMD
+   extensions THZ was built with (the fast math ones are in THZVector.c) */
+
+static void THZVector_(cmul_DEFAULT)(real *z, const real *x, const real *y, const long n)
+{
+  long i;
+  for(i = 0; i < n; i++)
+    z[i] = x[i] * y[i];
+}
+
+static void THZVector_(cmulconj_DEFAULT)(real *z, const real *x, const real *y, const long n)
+{
+  long i;
+  for(i = 0; i < n; i++)
+    z[i] = x[i] * CONJ(y[i]);
+}
+
+static void THZVector_(cmac_DEFAULT)(real *z, const real *x, const real *y, const real c, const long n)
+{
+  long i;
+  for(i = 0; i < n; i++)
+    z[i] += c * x[i] * y[i];
+}
+
+static void THZVector_(cmacconj_DEFAULT)(real *z, const real *x, const real *y, const real c, const long n)
+{
+  long i;
+  for(i = 0; i < n; i++)
+    z[i] += c * x[i] * CONJ(y[i]);
+}
+
+static real THZVector_(cdotc_DEFAULT)(const real *x, const real *y, const long n)
+{
+  long i;
+  real sum = 0;
+  for(i = 0; i < n; i++)
+    sum += x[i] * CONJ(y[i]);
+  return sum;
+}
+
+static void THZVector_(cadd_DEFAULT)(real *z, const real *x, const real *y, const real c, const long n)
+{
+  long i;
+  for(i = 0; i < n; i++)
+    z[i] = x[i] + c * y[i];
+}
+
+static void THZVector_(cscale_DEFAULT)(real *z, const real *x, const real c, const long n)
+{
+  long i;
+  for(i = 0; i < n; i++)
+    z[i] = c * x[i];
+}
+
+static void THZVector_(gemmKernel_DEFAULT)(const long kc, const real *a, const real *b, real *c, const long ldc)
+{
+  real acc[THZ_GEMM_MR*THZ_GEMM_NR];
+  long i, j, l;
+
+  for(i = 0; i < THZ_GEMM_MR*THZ_GEMM_NR; i++)
+    acc[i] = 0;
+
+  for(l = 0; l < kc; l++)
+  {
+    for(j = 0; j < THZ_GEMM_NR; j++)
+    {
+      real bj = b[j];
+      for(i = 0; i < THZ_GEMM_MR; i++)
+        acc[j*THZ_GEMM_MR+i] += a[i]*bj;
+    }
+    a += THZ_GEMM_MR;
+    b += THZ_GEMM_NR;
+  }
+
+  for(j = 0; j < THZ_GEMM_NR; j++)
+    for(i = 0; i < THZ_GEMM_MR; i++)
+      c[j*ldc+i] += acc[j*THZ_GEMM_MR+i];
+}
+
+static void (*THZVector_(cmul_DISPATCHPTR))(real *, const real *, const real *, const long) = &THZVector_(cmul_DEFAULT);
+static void (*THZVector_(cmulconj_DISPATCHPTR))(real *, const real *, const real *, const long) = &THZVector_(cmulconj_DEFAULT);
+static void (*THZVector_(cmac_DISPATCHPTR))(real *, const real *, const real *, const real, const long) = &THZVector_(cmac_DEFAULT);
+static void (*THZVector_(cmacconj_DISPATCHPTR))(real *, const real *, const real *, const real, const long) = &THZVector_(cmacconj_DEFAULT);
+static real (*THZVector_(cdotc_DISPATCHPTR))(const real *, const real *, const long) = &THZVector_(cdotc_DEFAULT);
+static void (*THZVector_(cadd_DISPATCHPTR))(real *, const real *, const real *, const real, const long) = &THZVector_(cadd_DEFAULT);
+static void (*THZVector_(cscale_DISPATCHPTR))(real *, const real *, const real, const long) = &THZVector_(cscale_DEFAULT);
+static void (*THZVector_(fastExp_DISPATCHPTR))(real *, const real *, const long) = &THZVector_(fastExp_DEFAULT);
+static void (*THZVector_(fastLog_DISPATCHPTR))(real *, const real *, const long) = &THZVector_(fastLog_DEFAULT);
+static void (*THZVector_(fastSqrt_DISPATCHPTR))(real *, const real *, const long) = &THZVector_(fastSqrt_DEFAULT);
+static void (*THZVector_(fastPow_DISPATCHPTR))(real *, const real *, const real, const long) = &THZVector_(fastPow_DEFAULT);
+static void (*THZVector_(fastAbs_DISPATCHPTR))(realscalar *, const real *, const long) = &THZVector_(fastAbs_DEFAULT);
+static void (*THZVector_(fastArg_DISPATCHPTR))(realscalar *, const real *, const long) = &THZVector_(fastArg_DEFAULT);
+static void (*THZVector_(fastFromPolar_DISPATCHPTR))(real *, const realscalar *, const realscalar *, const long) = &THZVector_(fastFromPolar_DEFAULT);
+static void (*THZVector_(gemmKernel_DISPATCHPTR))(const long, const real *, const real *, real *, const long) = &THZVector_(gemmKernel_DEFAULT);
+
+void THZVector_(cmul)(real *z, const real *x, const real *y, const long n)
+{
+  THZVector_(cmul_DISPATCHPTR)(z, x, y, n);
+}
+
+void THZVector_(cmulconj)(real *z, const real *x, const real *y, const long n)
+{
+  THZVector_(cmulconj_DISPATCHPTR)(z, x, y, n);
+}
+
+void THZVector_(cmac)(real *z, const real *x, const real *y, const real c, const long n)
+{
+  THZVector_(cmac_DISPATCHPTR)(z, x, y, c, n);
+}
+
+void THZVector_(cmacconj)(real *z, const real *x, const real *y, const real c, const long n)
+{
+  THZVector_(cmacconj_DISPATCHPTR)(z, x, y, c, n);
+}
+
+real THZVector_(cdotc)(const real *x, const real *y, const long n)
+{
+  return THZVector_(cdotc_DISPATCHPTR)(x, y, n);
+}
+
+void THZVector_(cadd)(real *z, const real *x, const real *y, const real c, const long n)
+{
+  THZVector_(cadd_DISPATCHPTR)(z, x, y, c, n);
+}
+
+void THZVector_(cscale)(real *z, const real *x, const real c, const long n)
+{
+  THZVector_(cscale_DISPATCHPTR)(z, x, c, n);
+}
+
+void THZVector_(fastExp)(real *z, const real *x, const long n)
+{
+  THZVector_(fastExp_DISPATCHPTR)(z, x, n);
+}
+
+void THZVector_(fastLog)(real *z, const real *x, const long n)
+{
+  THZVector_(fastLog_DISPATCHPTR)(z, x, n);
+}
+
+void THZVector_(fastSqrt)(real *z, const real *x, const long n)
+{
+  THZVector_(fastSqrt_DISPATCHPTR)(z, x, n);
+}
+
+void THZVector_(fastPow)(real *z, const real *x, const real c, const long n)
+{
+  THZVector_(fastPow_DISPATCHPTR)(z, x, c, n);
+}
+
+void THZVector_(fastAbs)(realscalar *z, const real *x, const long n)
+{
+  THZVector_(fastAbs_DISPATCHPTR)(z, x, n);
+}
+
+void THZVector_(fastArg)(realscalar *z, const real *x, const long n)
+{
+  THZVector_(fastArg_DISPATCHPTR)(z, x, n);
+}
+
+void THZVector_(fastFromPolar)(real *z, const realscalar *mag, const realscalar *phase, const long n)
+{
+  THZVector_(fastFromPolar_DISPATCHPTR)(z, mag, phase, n);
+}
+
+void THZVector_(gemmKernel)(const long kc, const real *a, const real *b, real *c, const long ldc)
+{
+  THZVector_(gemmKernel_DISPATCHPTR)(kc, a, b, c, ldc);
+}
+
+#define THZ_VECTOR_DISPATCH(EXT)                                          \
+  {                                                                       \
+    THZVector_(cmul_DISPATCHPTR) = &TH_CONCAT_2(THZVector_(cmul_), EXT);  \
+    THZVector_(cmulconj_DISPATCHPTR) = &TH_CONCAT_2(THZVector_(cmulconj_), EXT); \
+    THZVector_(cmac_DISPATCHPTR) = &TH_CONCAT_2(THZVector_(cmac_), EXT);  \
+    THZVector_(cmacconj_DISPATCHPTR) = &TH_CONCAT_2(THZVector_(cmacconj_), EXT); \
+    THZVector_(cdotc_DISPATCHPTR) = &TH_CONCAT_2(THZVector_(cdotc_), EXT); \
+    THZVector_(cadd_DISPATCHPTR) = &TH_CONCAT_2(THZVector_(cadd_), EXT);  \
+    THZVector_(cscale_DISPATCHPTR) = &TH_CONCAT_2(THZVector_(cscale_), EXT); \
+    THZVector_(fastExp_DISPATCHPTR) = &TH_CONCAT_2(THZVector_(fastExp_), EXT); \
+    THZVector_(fastLog_DISPATCHPTR) = &TH_CONCAT_2(THZVector_(fastLog_), EXT); \
+    THZVector_(fastSqrt_DISPATCHPTR) = &TH_CONCAT_2(THZVector_(fastSqrt_), EXT); \
+    THZVector_(fastPow_DISPATCHPTR) = &TH_CONCAT_2(THZVector_(fastPow_), EXT); \
+    THZVector_(fastAbs_DISPATCHPTR) = &TH_CONCAT_2(THZVector_(fastAbs_), EXT); \
+    THZVector_(fastArg_DISPATCHPTR) = &TH_CONCAT_2(THZVector_(fastArg_), EXT); \
+    THZVector_(fastFromPolar_DISPATCHPTR) = &TH_CONCAT_2(THZVector_(fastFromPolar_), EXT); \
+  }
+
+/* Picks the widest kernels that were both compiled in and are supported by
+   the cpu. Called once when the library is loaded. */
+void THZVector_(vectorDispatchInit)(void)
+{
+  int simd = THZVector_simdExtensions();
+  (void)simd;
+
+  /* the gemm kernel only has an AVX2 version, which AVX-512 cpus run too */
+#ifdef THZ_HAVE_AVX2
+  if(simd & THZ_SIMD_AVX2)
+    THZVector_(gemmKernel_DISPATCHPTR) = &THZVector_(gemmKernel_AVX2);
+#endif
+
+#ifdef THZ_HAVE_AVX512
+  if(simd & THZ_SIMD_AVX512)
+  {
+    THZ_VECTOR_DISPATCH(AVX512);
+    return;
+  }
+#endif
+#ifdef THZ_HAVE_AVX2
+  if(simd & THZ_SIMD_AVX2)
+  {
+    THZ_VECTOR_DISPATCH(AVX2);
+    return;
+  }
+#endif
+#ifdef THZ_HAVE_SSE3
+  if(simd & THZ_SIMD_SSE3)
+  {
+    THZ_VECTOR_DISPATCH(SSE3);
+    return;
+  }
+#endif
+}
+
+#undef THZ_VECTOR_DISPATCH
+
+#endif
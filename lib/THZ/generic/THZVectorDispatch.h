@@ -0,0 +1,42 @@
+/**
+ * Copyright (c) 2015-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#ifndef THZ_GENERIC_FILE
+#define THZ_GENERIC_FILE "generic/THZVectorDispatch.h"
+#else
+
+/* Contiguous complex kernels, dispatched at load time to the widest
+   instruction set supported by the cpu (see vector/simd.h) */
+THZ_API void THZVector_(cmul)(real *z, const real *x, const real *y, const long n);
+THZ_API void THZVector_(cmulconj)(real *z, const real *x, const real *y, const long n);
+THZ_API void THZVector_(cmac)(real *z, const real *x, const real *y, const real c, const long n);
+THZ_API void THZVector_(cmacconj)(real *z, const real *x, const real *y, const real c, const long n);
+THZ_API real THZVector_(cdotc)(const real *x, const real *y, const long n);
+THZ_API void THZVector_(cadd)(real *z, const real *x, const real *y, const real c, const long n);
+THZ_API void THZVector_(cscale)(real *z, const real *x, const real c, const long n);
+
+/* Approximate exp, log, sqrt, x^c, |x| and arg x for the fast math mode
+   (accuracy in THZVector.h); fastAbs and fastArg write n real scalars, and
+   fastFromPolar makes z = mag e^(i phase) */
+THZ_API void THZVector_(fastExp)(real *z, const real *x, const long n);
+THZ_API void THZVector_(fastLog)(real *z, const real *x, const long n);
+THZ_API void THZVector_(fastSqrt)(real *z, const real *x, const long n);
+THZ_API void THZVector_(fastPow)(real *z, const real *x, const real c, const long n);
+THZ_API void THZVector_(fastAbs)(realscalar *z, const real *x, const long n);
+THZ_API void THZVector_(fastArg)(realscalar *z, const real *x, const long n);
+THZ_API void THZVector_(fastFromPolar)(real *z, const realscalar *mag, const realscalar *phase, const long n);
+
+/* gemm micro-kernel: c[i + j*ldc] += sum_l a[l*MR + i] * b[l*NR + j] over
+   l < kc, for the full THZ_GEMM_MR x THZ_GEMM_NR tile of c; a and b are
+   packed panels as laid out by THZBlas_(gemm) */
+THZ_API void THZVector_(gemmKernel)(const long kc, const real *a, const real *b, real *c, const long ldc);
+
+THZ_API void THZVector_(vectorDispatchInit)(void);
+
+#endif
@@ -0,0 +1,166 @@
+/**
+ * Copyright (c) 2015-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#include <immintrin.h>
+#include "simd.h"
+
+/* Same scheme as the SSE3 kernels, with fmaddsub folding the first product
+   into the final add/subtract. */
+
+static THZ_INLINE __m256 THZ_cmul_ps(__m256 a, __m256 b)
+{
+  __m256 as = _mm256_permute_ps(a, 0xB1);
+  return _mm256_fmaddsub_ps(a, _mm256_moveldup_ps(b),
+                            _mm256_mul_ps(as, _mm256_movehdup_ps(b)));
+}
+
+static THZ_INLINE __m256 THZ_cmulconj_ps(__m256 a, __m256 b)
+{
+  __m256 as = _mm256_permute_ps(a, 0xB1);
+  return _mm256_fmsubadd_ps(a, _mm256_moveldup_ps(b),
+                            _mm256_mul_ps(as, _mm256_movehdup_ps(b)));
+}
+
+static THZ_INLINE __m256d THZ_cmul_pd(__m256d a, __m256d b)
+{
+  __m256d as = _mm256_permute_pd(a, 0x5);
+  return _mm256_fmaddsub_pd(a, _mm256_movedup_pd(b),
+                            _mm256_mul_pd(as, _mm256_permute_pd(b, 0xF)));
+}
+
+static THZ_INLINE __m256d THZ_cmulconj_pd(__m256d a, __m256d b)
+{
+  __m256d as = _mm256_permute_pd(a, 0x5);
+  return _mm256_fmsubadd_pd(a, _mm256_movedup_pd(b),
+                            _mm256_mul_pd(as, _mm256_permute_pd(b, 0xF)));
+}
+
+#define real float complex
+#define SIMD_NAME(NAME) THZFloatVector_##NAME##_AVX2
+#define SIMD_CONJ conjf
+#define V __m256
+#define W 4
+#define VLOAD(p) _mm256_loadu_ps((const float*)(p))
+#define VSTORE(p, v) _mm256_storeu_ps((float*)(p), (v))
+#define VADD(a, b) _mm256_add_ps((a), (b))
+#define VCMUL(a, b) THZ_cmul_ps((a), (b))
+#define VCMULCONJ(a, b) THZ_cmulconj_ps((a), (b))
+#define VSET1(c) _mm256_setr_ps(crealf(c), cimagf(c), crealf(c), cimagf(c), \
+                                crealf(c), cimagf(c), crealf(c), cimagf(c))
+#include "fastmath_kernels.h"
+#include "simd_kernels.h"
+
+#define real double complex
+#define SIMD_NAME(NAME) THZDoubleVector_##NAME##_AVX2
+#define SIMD_CONJ conj
+#define V __m256d
+#define W 2
+#define VLOAD(p) _mm256_loadu_pd((const double*)(p))
+#define VSTORE(p, v) _mm256_storeu_pd((double*)(p), (v))
+#define VADD(a, b) _mm256_add_pd((a), (b))
+#define VCMUL(a, b) THZ_cmul_pd((a), (b))
+#define VCMULCONJ(a, b) THZ_cmulconj_pd((a), (b))
+#define VSET1(c) _mm256_setr_pd(creal(c), cimag(c), creal(c), cimag(c))
+#define SIMD_DOUBLE
+#include "fastmath_kernels.h"
+#include "simd_kernels.h"
+
+/* gemm micro-kernels. Each column j of the tile keeps two accumulators per
+   vector of a, one for a*re(b_j) and one for a*im(b_j); swapping the pairs
+   of the second and add/subtracting it from the first gives the complex
+   products. 12 accumulators, 2 vectors of a and 2 broadcasts fill the 16
+   ymm registers. */
+
+#define THZ_GEMM_COLUMN_PS(J)                                 \
+  {                                                           \
+    __m256 br = _mm256_broadcast_ss(pb + 2*(J));              \
+    __m256 bi = _mm256_broadcast_ss(pb + 2*(J) + 1);          \
+    r0##J = _mm256_fmadd_ps(a0, br, r0##J);                   \
+    r1##J = _mm256_fmadd_ps(a1, br, r1##J);                   \
+    i0##J = _mm256_fmadd_ps(a0, bi, i0##J);                   \
+    i1##J = _mm256_fmadd_ps(a1, bi, i1##J);                   \
+  }
+
+#define THZ_GEMM_STORE_PS(J)                                                        \
+  {                                                                                 \
+    float *c_ = (float*)(c + (J)*ldc);                                              \
+    _mm256_storeu_ps(c_, _mm256_add_ps(_mm256_loadu_ps(c_),                         \
+                     _mm256_addsub_ps(r0##J, _mm256_permute_ps(i0##J, 0xB1))));     \
+    _mm256_storeu_ps(c_+8, _mm256_add_ps(_mm256_loadu_ps(c_+8),                     \
+                     _mm256_addsub_ps(r1##J, _mm256_permute_ps(i1##J, 0xB1))));     \
+  }
+
+void THZFloatVector_gemmKernel_AVX2(const long kc, const float complex *a, const float complex *b, float complex *c, const long ldc)
+{
+  const float *pa = (const float*)a;
+  const float *pb = (const float*)b;
+  __m256 r00 = _mm256_setzero_ps(), r10 = r00, i00 = r00, i10 = r00;
+  __m256 r01 = r00, r11 = r00, i01 = r00, i11 = r00;
+  __m256 r02 = r00, r12 = r00, i02 = r00, i12 = r00;
+  long l;
+
+  for(l = 0; l < kc; l++)
+  {
+    __m256 a0 = _mm256_loadu_ps(pa);
+    __m256 a1 = _mm256_loadu_ps(pa+8);
+    THZ_GEMM_COLUMN_PS(0);
+    THZ_GEMM_COLUMN_PS(1);
+    THZ_GEMM_COLUMN_PS(2);
+    pa += 16;
+    pb += 6;
+  }
+
+  THZ_GEMM_STORE_PS(0);
+  THZ_GEMM_STORE_PS(1);
+  THZ_GEMM_STORE_PS(2);
+}
+
+#define THZ_GEMM_COLUMN_PD(J)                                 \
+  {                                                           \
+    __m256d br = _mm256_broadcast_sd(pb + 2*(J));             \
+    __m256d bi = _mm256_broadcast_sd(pb + 2*(J) + 1);         \
+    r0##J = _mm256_fmadd_pd(a0, br, r0##J);                   \
+    r1##J = _mm256_fmadd_pd(a1, br, r1##J);                   \
+    i0##J = _mm256_fmadd_pd(a0, bi, i0##J);                   \
+    i1##J = _mm256_fmadd_pd(a1, bi, i1##J);                   \
+  }
+
+#define THZ_GEMM_STORE_PD(J)                                                        \
+  {                                                                                 \
+    double *c_ = (double*)(c + (J)*ldc);                                            \
+    _mm256_storeu_pd(c_, _mm256_add_pd(_mm256_loadu_pd(c_),                         \
+                     _mm256_addsub_pd(r0##J, _mm256_permute_pd(i0##J, 0x5))));      \
+    _mm256_storeu_pd(c_+4, _mm256_add_pd(_mm256_loadu_pd(c_+4),                     \
+                     _mm256_addsub_pd(r1##J, _mm256_permute_pd(i1##J, 0x5))));      \
+  }
+
+void THZDoubleVector_gemmKernel_AVX2(const long kc, const double complex *a, const double complex *b, double complex *c, const long ldc)
+{
+  const double *pa = (const double*)a;
+  const double *pb = (const double*)b;
+  __m256d r00 = _mm256_setzero_pd(), r10 = r00, i00 = r00, i10 = r00;
+  __m256d r01 = r00, r11 = r00, i01 = r00, i11 = r00;
+  __m256d r02 = r00, r12 = r00, i02 = r00, i12 = r00;
+  long l;
+
+  for(l = 0; l < kc; l++)
+  {
+    __m256d a0 = _mm256_loadu_pd(pa);
+    __m256d a1 = _mm256_loadu_pd(pa+4);
+    THZ_GEMM_COLUMN_PD(0);
+    THZ_GEMM_COLUMN_PD(1);
+    THZ_GEMM_COLUMN_PD(2);
+    pa += 8;
+    pb += 6;
+  }
+
+  THZ_GEMM_STORE_PD(0);
+  THZ_GEMM_STORE_PD(1);
+  THZ_GEMM_STORE_PD(2);
+}
@@ -0,0 +1,78 @@
+/**
+ * Copyright (c) 2015-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#include <immintrin.h>
+#include "simd.h"
+
+/* AVX-512F version of the AVX2 kernels (only AVX-512F instructions are
+   used, so any AVX-512 capable cpu qualifies). */
+
+static THZ_INLINE __m512 THZ_cmul_ps(__m512 a, __m512 b)
+{
+  __m512 as = _mm512_permute_ps(a, 0xB1);
+  return _mm512_fmaddsub_ps(a, _mm512_moveldup_ps(b),
+                            _mm512_mul_ps(as, _mm512_movehdup_ps(b)));
+}
+
+static THZ_INLINE __m512 THZ_cmulconj_ps(__m512 a, __m512 b)
+{
+  __m512 as = _mm512_permute_ps(a, 0xB1);
+  return _mm512_fmsubadd_ps(a, _mm512_moveldup_ps(b),
+                            _mm512_mul_ps(as, _mm512_movehdup_ps(b)));
+}
+
+static THZ_INLINE __m512d THZ_cmul_pd(__m512d a, __m512d b)
+{
+  __m512d as = _mm512_permute_pd(a, 0x55);
+  return _mm512_fmaddsub_pd(a, _mm512_movedup_pd(b),
+                            _mm512_mul_pd(as, _mm512_permute_pd(b, 0xFF)));
+}
+
+static THZ_INLINE __m512d THZ_cmulconj_pd(__m512d a, __m512d b)
+{
+  __m512d as = _mm512_permute_pd(a, 0x55);
+  return _mm512_fmsubadd_pd(a, _mm512_movedup_pd(b),
+                            _mm512_mul_pd(as, _mm512_permute_pd(b, 0xFF)));
+}
+
+#define real float complex
+#define SIMD_NAME(NAME) THZFloatVector_##NAME##_AVX512
+#define SIMD_CONJ conjf
+#define V __m512
+#define W 8
+#define VLOAD(p) _mm512_loadu_ps((const float*)(p))
+#define VSTORE(p, v) _mm512_storeu_ps((float*)(p), (v))
+#define VADD(a, b) _mm512_add_ps((a), (b))
+#define VCMUL(a, b) THZ_cmul_ps((a), (b))
+#define VCMULCONJ(a, b) THZ_cmulconj_ps((a), (b))
+#define VSET1(c) _mm512_castpd_ps(_mm512_set1_pd(THZ_packf(c)))
+static THZ_INLINE double THZ_packf(float complex c)
+{
+  double d;
+  memcpy(&d, &c, sizeof(double));
+  return d;
+}
+#include "fastmath_kernels.h"
+#include "simd_kernels.h"
+
+#define real double complex
+#define SIMD_NAME(NAME) THZDoubleVector_##NAME##_AVX512
+#define SIMD_CONJ conj
+#define V __m512d
+#define W 4
+#define VLOAD(p) _mm512_loadu_pd((const double*)(p))
+#define VSTORE(p, v) _mm512_storeu_pd((double*)(p), (v))
+#define VADD(a, b) _mm512_add_pd((a), (b))
+#define VCMUL(a, b) THZ_cmul_pd((a), (b))
+#define VCMULCONJ(a, b) THZ_cmulconj_pd((a), (b))
+#define VSET1(c) _mm512_setr_pd(creal(c), cimag(c), creal(c), cimag(c), \
+                                creal(c), cimag(c), creal(c), cimag(c))
+#define SIMD_DOUBLE
+#include "fastmath_kernels.h"
+#include "simd_kernels.h"
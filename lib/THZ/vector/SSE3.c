@@ -0,0 +1,73 @@
+/**
+ * Copyright (c) 2015-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#include <pmmintrin.h>
+#include "simd.h"
+
+/* (a+bi)(c+di): multiply a by the duplicated real parts of the second
+   operand, the swapped first operand by its duplicated imaginary parts, and
+   let addsub produce ac-bd / bc+ad in the even/odd lanes. The conjugate
+   variant negates the second product first. */
+
+static THZ_INLINE __m128 THZ_cmul_ps(__m128 a, __m128 b)
+{
+  __m128 as = _mm_shuffle_ps(a, a, _MM_SHUFFLE(2,3,0,1));
+  return _mm_addsub_ps(_mm_mul_ps(a, _mm_moveldup_ps(b)),
+                       _mm_mul_ps(as, _mm_movehdup_ps(b)));
+}
+
+static THZ_INLINE __m128 THZ_cmulconj_ps(__m128 a, __m128 b)
+{
+  __m128 as = _mm_shuffle_ps(a, a, _MM_SHUFFLE(2,3,0,1));
+  return _mm_addsub_ps(_mm_mul_ps(a, _mm_moveldup_ps(b)),
+                       _mm_sub_ps(_mm_setzero_ps(), _mm_mul_ps(as, _mm_movehdup_ps(b))));
+}
+
+static THZ_INLINE __m128d THZ_cmul_pd(__m128d a, __m128d b)
+{
+  __m128d as = _mm_shuffle_pd(a, a, 1);
+  return _mm_addsub_pd(_mm_mul_pd(a, _mm_movedup_pd(b)),
+                       _mm_mul_pd(as, _mm_unpackhi_pd(b, b)));
+}
+
+static THZ_INLINE __m128d THZ_cmulconj_pd(__m128d a, __m128d b)
+{
+  __m128d as = _mm_shuffle_pd(a, a, 1);
+  return _mm_addsub_pd(_mm_mul_pd(a, _mm_movedup_pd(b)),
+                       _mm_sub_pd(_mm_setzero_pd(), _mm_mul_pd(as, _mm_unpackhi_pd(b, b))));
+}
+
+#define real float complex
+#define SIMD_NAME(NAME) THZFloatVector_##NAME##_SSE3
+#define SIMD_CONJ conjf
+#define V __m128
+#define W 2
+#define VLOAD(p) _mm_loadu_ps((const float*)(p))
+#define VSTORE(p, v) _mm_storeu_ps((float*)(p), (v))
+#define VADD(a, b) _mm_add_ps((a), (b))
+#define VCMUL(a, b) THZ_cmul_ps((a), (b))
+#define VCMULCONJ(a, b) THZ_cmulconj_ps((a), (b))
+#define VSET1(c) _mm_setr_ps(crealf(c), cimagf(c), crealf(c), cimagf(c))
+#include "fastmath_kernels.h"
+#include "simd_kernels.h"
+
+#define real double complex
+#define SIMD_NAME(NAME) THZDoubleVector_##NAME##_SSE3
+#define SIMD_CONJ conj
+#define V __m128d
+#define W 1
+#define VLOAD(p) _mm_loadu_pd((const double*)(p))
+#define VSTORE(p, v) _mm_storeu_pd((double*)(p), (v))
+#define VADD(a, b) _mm_add_pd((a), (b))
+#define VCMUL(a, b) THZ_cmul_pd((a), (b))
+#define VCMULCONJ(a, b) THZ_cmulconj_pd((a), (b))
+#define VSET1(c) _mm_setr_pd(creal(c), cimag(c))
+#define SIMD_DOUBLE
+#include "fastmath_kernels.h"
+#include "simd_kernels.h"
@@ -0,0 +1,456 @@
+/**
+ * Copyright (c) 2015-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+/* Approximate complex functions of the fast math mode (accuracy in
+   THZVector.h). The including file defines real, SIMD_NAME(NAME), and
+   SIMD_DOUBLE for double complex; it may define SIMD_LINKAGE (static for the
+   portable fallbacks). SIMD_DOUBLE and SIMD_LINKAGE are undefined again at
+   the end of this file, real and SIMD_NAME are left to simd_kernels.h.
+
+   Unlike simd_kernels.h, the bodies are plain C: branch-free code on the
+   real and imaginary parts, in loops that the compiler vectorizes for the
+   instruction set of the including file (given -fno-trapping-math and
+   -fno-math-errno, see CMakeLists.txt). Arguments are reduced with
+   Cody-Waite constants and the functions are then Taylor series, which are
+   short on the reduced ranges. abs, arg, log and sqrt give the results of
+   libm for zeros of either sign, infinities and NaNs (up to the sign of a
+   NaN and of the unspecified signs of C99 annex G); exp and pow expect finite
+   results, and lose accuracy once |im z| passes 6000 (float) or 1.6e6
+   (double), like any reduction by pi/2 in a few parts. */
+
+#include <stdint.h>
+
+#ifndef SIMD_LINKAGE
+#define SIMD_LINKAGE
+#endif
+
+#ifdef SIMD_DOUBLE
+#define FM_S double
+#define FM_U uint64_t
+#define FM_I int64_t
+#define FM_MANT 52
+#define FM_BIAS 1023
+#define FM_FABS fabs
+#define FM_SQRT sqrt
+#define FM_COPYSIGN copysign
+#define FM_SHIFT 6755399441055744.0 /* 1.5*2^52: x+FM_SHIFT rounds x to an integer */
+#define FM_EXP_LO -746.0
+#define FM_EXP_HI 710.0
+#define FM_LN2_1 6.93147180601954460144e-01
+#define FM_LN2_2 -4.20091507268108459794e-11
+#define FM_PIO2_1 1.57079632673412561417e+00
+#define FM_PIO2_2 6.07710050630396597660e-11
+#define FM_PIO2_3 2.02226624879595063154e-21
+#define FM_PI 3.14159265358979311600e+00
+#define FM_PI_LO 1.22464679914735320717e-16
+#define FM_PIO8 3.92699081698724139500e-01
+#define FM_TAN_PIO8 4.14213562373095034452e-01
+#else
+#define FM_S float
+#define FM_U uint32_t
+#define FM_I int32_t
+#define FM_MANT 23
+#define FM_BIAS 127
+#define FM_FABS fabsf
+#define FM_SQRT sqrtf
+#define FM_COPYSIGN copysignf
+#define FM_SHIFT 12582912.0f /* 1.5*2^23 */
+#define FM_EXP_LO -104.0f
+#define FM_EXP_HI 89.0f
+#define FM_LN2_1 6.931152344e-01f
+#define FM_LN2_2 3.194618330e-05f
+#define FM_PIO2_1 1.570800781e+00f
+#define FM_PIO2_2 -4.453584552e-06f
+#define FM_PIO2_3 -8.705515753e-10f
+#define FM_PI 3.141592741e+00f
+#define FM_PI_LO -8.742277657e-08f
+#define FM_PIO8 3.926990926e-01f
+#define FM_TAN_PIO8 4.142135680e-01f
+#endif
+
+#define FM_LOG2E ((FM_S)1.44269504088896338700)
+#define FM_2OPI ((FM_S)0.63661977236758134308)
+#define FM_SQRT2 ((FM_S)1.41421356237309504880)
+/* the boundaries of the ranges of atan centered on 0, pi/8 and pi/4 */
+#define FM_TAN_PIO16 ((FM_S)0.19891236737965800691)
+#define FM_TAN_3PIO16 ((FM_S)0.66817863791929891999)
+
+static THZ_INLINE FM_U SIMD_NAME(fmBits)(FM_S x)
+{
+  union { FM_S s; FM_U u; } v;
+  v.s = x;
+  return v.u;
+}
+
+static THZ_INLINE FM_S SIMD_NAME(fmScalar)(FM_U u)
+{
+  union { FM_S s; FM_U u; } v;
+  v.u = u;
+  return v.s;
+}
+
+/* 2^k, for k within the normal exponents */
+static THZ_INLINE FM_S SIMD_NAME(fmPow2)(FM_I k)
+{
+  return SIMD_NAME(fmScalar)((FM_U)(k + FM_BIAS) << FM_MANT);
+}
+
+/* (FM_S)k for |k| < 2^(FM_MANT-1), without an integer conversion, which
+   not all instruction sets have in vector form */
+static THZ_INLINE FM_S SIMD_NAME(fmReal)(FM_I k)
+{
+  return SIMD_NAME(fmScalar)(SIMD_NAME(fmBits)(FM_SHIFT) + (FM_U)k) - FM_SHIFT;
+}
+
+/* e^x */
+static THZ_INLINE FM_S SIMD_NAME(fmExp)(FM_S x)
+{
+  FM_S t, k, r, p;
+  FM_I n, n1;
+
+  x = (x < FM_EXP_LO ? FM_EXP_LO : x);
+  x = (x > FM_EXP_HI ? FM_EXP_HI : x);
+  t = x*FM_LOG2E + FM_SHIFT;
+  k = t - FM_SHIFT;
+  n = (FM_I)(SIMD_NAME(fmBits)(t) - SIMD_NAME(fmBits)(FM_SHIFT));
+  r = (x - k*FM_LN2_1) - k*FM_LN2_2;
+
+  /* |r| <= ln(2)/2 */
+#ifdef SIMD_DOUBLE
+  p = 1/6227020800.0;
+  p = p*r + 1/479001600.0;
+  p = p*r + 1/39916800.0;
+  p = p*r + 1/3628800.0;
+  p = p*r + 1/362880.0;
+  p = p*r + 1/40320.0;
+  p = p*r + 1/5040.0;
+#else
+  p = 1/5040.0f;
+#endif
+  p = p*r + (FM_S)(1/720.0);
+  p = p*r + (FM_S)(1/120.0);
+  p = p*r + (FM_S)(1/24.0);
+  p = p*r + (FM_S)(1/6.0);
+  p = p*r + (FM_S)0.5;
+  p = p*r*r + r + 1;
+
+  /* 2^n in two factors, so that the ends of the range neither overflow
+     early nor flush to zero early */
+  n1 = n >> 1;
+  return p * SIMD_NAME(fmPow2)(n1) * SIMD_NAME(fmPow2)(n - n1);
+}
+
+/* sin y and cos y */
+static THZ_INLINE void SIMD_NAME(fmSinCos)(FM_S y, FM_S *sy, FM_S *cy)
+{
+  FM_S t = y*FM_2OPI + FM_SHIFT;
+  FM_S k = t - FM_SHIFT;
+  FM_U q = SIMD_NAME(fmBits)(t) - SIMD_NAME(fmBits)(FM_SHIFT);
+  FM_S r = ((y - k*FM_PIO2_1) - k*FM_PIO2_2) - k*FM_PIO2_3;
+  FM_S r2 = r*r;
+  FM_S s, c;
+
+  /* |r| <= pi/4, y = r + q*pi/2 */
+#ifdef SIMD_DOUBLE
+  s = 1/355687428096000.0;
+  s = s*r2 - 1/1307674368000.0;
+  s = s*r2 + 1/6227020800.0;
+  s = s*r2 - 1/39916800.0;
+  c = 1/6402373705728000.0;
+  c = c*r2 - 1/20922789888000.0;
+  c = c*r2 + 1/87178291200.0;
+  c = c*r2 - 1/479001600.0;
+  c = c*r2 + 1/3628800.0;
+#else
+  s = -1/39916800.0f;
+  c = 1/3628800.0f;
+#endif
+  s = s*r2 + (FM_S)(1/362880.0);
+  s = s*r2 - (FM_S)(1/5040.0);
+  s = s*r2 + (FM_S)(1/120.0);
+  s = s*r2 - (FM_S)(1/6.0);
+  s = s*r2*r + r;
+  c = c*r2 - (FM_S)(1/40320.0);
+  c = c*r2 + (FM_S)(1/720.0);
+  c = c*r2 - (FM_S)(1/24.0);
+  c = c*r2 + (FM_S)0.5;
+  c = 1 - c*r2;
+
+  /* quadrant q: sin y = sin r, cos r, -sin r, -cos r */
+  *sy = (q & 1 ? c : s);
+  *cy = (q & 1 ? s : c);
+  *sy = (q & 2 ? -*sy : *sy);
+  *cy = ((q+1) & 2 ? -*cy : *cy);
+}
+
+/* |x + iy| = 2^e sqrt(s): x and y are scaled by 2^-e, for the largest to be
+   in [1, 2), so that s neither overflows nor underflows. s is infinite when
+   x or y is, even if the other one is NaN, as with hypot. */
+static THZ_INLINE FM_S SIMD_NAME(fmScaledNorm)(FM_S x, FM_S y, FM_I *e)
+{
+  FM_S ax = FM_FABS(x), ay = FM_FABS(y);
+  FM_S m = (ax > ay ? ax : ay);
+  int inf = (ax == (FM_S)INFINITY || ay == (FM_S)INFINITY);
+  FM_I k = (FM_I)(SIMD_NAME(fmBits)(m) >> FM_MANT) - FM_BIAS;
+  FM_S scale;
+
+  k = (k < 2-FM_BIAS ? 2-FM_BIAS : k);
+  k = (k > FM_BIAS-2 ? FM_BIAS-2 : k);
+  scale = SIMD_NAME(fmPow2)(-k);
+  ax *= scale;
+  ay *= scale;
+  *e = k;
+  return (inf ? (FM_S)INFINITY : ax*ax + ay*ay);
+}
+
+/* log(s)/2 + e*ln(2), for s = 0, infinite, NaN, or normal */
+static THZ_INLINE FM_S SIMD_NAME(fmHalfLog)(FM_S s, FM_I e)
+{
+  FM_U b = SIMD_NAME(fmBits)(s);
+  FM_I k = (FM_I)(b >> FM_MANT) - FM_BIAS;
+  FM_S f = SIMD_NAME(fmScalar)((b & (((FM_U)1 << FM_MANT) - 1)) | ((FM_U)FM_BIAS << FM_MANT));
+  FM_S u, u2, p, kk, l;
+
+  /* s = 2^k f, f in [sqrt(1/2), sqrt(2)) */
+  k += (f > FM_SQRT2);
+  f = (f > FM_SQRT2 ? f*(FM_S)0.5 : f);
+
+  /* log f = 2 atanh u, |u| <= 0.172 */
+  u = (f - 1)/(f + 1);
+  u2 = u*u;
+#ifdef SIMD_DOUBLE
+  p = 1/21.0;
+  p = p*u2 + 1/19.0;
+  p = p*u2 + 1/17.0;
+  p = p*u2 + 1/15.0;
+  p = p*u2 + 1/13.0;
+  p = p*u2 + 1/11.0;
+#else
+  p = 1/11.0f;
+#endif
+  p = p*u2 + (FM_S)(1/9.0);
+  p = p*u2 + (FM_S)(1/7.0);
+  p = p*u2 + (FM_S)(1/5.0);
+  p = p*u2 + (FM_S)(1/3.0);
+  p = p*u2*u + u;
+
+  /* (k + 2e) ln(2)/2 + p, p being half of log f */
+  kk = SIMD_NAME(fmReal)(k + 2*e);
+  l = (kk*FM_LN2_1 + (kk*FM_LN2_2 + 2*p))*(FM_S)0.5;
+
+  l = (s - s != 0 ? s : l);
+  return (s == 0 ? -(FM_S)INFINITY : l);
+}
+
+/* atan2(y, x), NaN if x or y is. The signs come from the sign bits, so that
+   -0 picks the side of the branch cut as in libm. */
+static THZ_INLINE FM_S SIMD_NAME(fmAtan2)(FM_S y, FM_S x)
+{
+  FM_S ax = FM_FABS(x), ay = FM_FABS(y);
+  FM_S mx = (ax > ay ? ax : ay), mn = (ax > ay ? ay : ax);
+  FM_S t = (mx > 0 ? (mn == mx ? 1 : mn/mx) : 0); /* 1 for two infinities */
+  int xneg = ((FM_I)SIMD_NAME(fmBits)(x) < 0);
+  FM_S a, c, u, u2, p, r;
+
+  /* t in [0, 1] as u around tan(c), c in {0, pi/8, pi/4}: |u| <= tan(pi/16) */
+  a = (t > FM_TAN_3PIO16 ? 1 : (t > FM_TAN_PIO16 ? FM_TAN_PIO8 : 0));
+  c = (t > FM_TAN_3PIO16 ? 2*FM_PIO8 : (t > FM_TAN_PIO16 ? FM_PIO8 : 0));
+  u = (t - a)/(1 + a*t);
+  u2 = u*u;
+#ifdef SIMD_DOUBLE
+  p = -1/23.0;
+  p = p*u2 + 1/21.0;
+  p = p*u2 - 1/19.0;
+  p = p*u2 + 1/17.0;
+  p = p*u2 - 1/15.0;
+  p = p*u2 + 1/13.0;
+#else
+  p = 1/13.0f;
+#endif
+  p = p*u2 - (FM_S)(1/11.0);
+  p = p*u2 + (FM_S)(1/9.0);
+  p = p*u2 - (FM_S)(1/7.0);
+  p = p*u2 + (FM_S)(1/5.0);
+  p = p*u2 - (FM_S)(1/3.0);
+  r = c + (p*u2*u + u);
+
+  /* back to the octant of (x, y), with pi and pi/2 in two parts */
+  r = (ay > ax ? (FM_PI*(FM_S)0.5 - r) + FM_PI_LO*(FM_S)0.5 : r);
+  r = (xneg ? (FM_PI - r) + FM_PI_LO : r);
+  r = FM_COPYSIGN(r, y);
+  return (x != x || y != y ? x + y : r);
+}
+
+SIMD_LINKAGE void SIMD_NAME(fastExp)(real *z, const real *x, const long n)
+{
+  const FM_S *xp = (const FM_S*)x;
+  FM_S *zp = (FM_S*)z;
+  long i;
+
+  #pragma omp simd
+  for(i = 0; i < n; i++)
+  {
+    FM_S e = SIMD_NAME(fmExp)(xp[2*i]);
+    FM_S s, c;
+
+    SIMD_NAME(fmSinCos)(xp[2*i+1], &s, &c);
+    zp[2*i] = e*c;
+    zp[2*i+1] = e*s;
+  }
+}
+
+SIMD_LINKAGE void SIMD_NAME(fastLog)(real *z, const real *x, const long n)
+{
+  const FM_S *xp = (const FM_S*)x;
+  FM_S *zp = (FM_S*)z;
+  long i;
+
+  #pragma omp simd
+  for(i = 0; i < n; i++)
+  {
+    FM_S re = xp[2*i], im = xp[2*i+1];
+    FM_I e;
+    FM_S s = SIMD_NAME(fmScaledNorm)(re, im, &e);
+
+    zp[2*i] = SIMD_NAME(fmHalfLog)(s, e);
+    zp[2*i+1] = SIMD_NAME(fmAtan2)(im, re);
+  }
+}
+
+SIMD_LINKAGE void SIMD_NAME(fastSqrt)(real *z, const real *x, const long n)
+{
+  const FM_S *xp = (const FM_S*)x;
+  FM_S *zp = (FM_S*)z;
+  long i;
+
+  #pragma omp simd
+  for(i = 0; i < n; i++)
+  {
+    FM_S re = xp[2*i], im = xp[2*i+1];
+    FM_I e, h;
+    FM_S s = SIMD_NAME(fmScaledNorm)(re, im, &e);
+    FM_S scale, t, d;
+    int iminf = (FM_FABS(im) == (FM_S)INFINITY);
+
+    /* t = sqrt((|z| + |x|)/2) on the parts scaled by 2^-e, e made even so
+       that the square root of 2^e is exact: |z| past the largest real or a
+       subnormal x or y neither overflows nor flushes to zero */
+    h = e & 1;
+    scale = SIMD_NAME(fmPow2)(h - e);
+    t = FM_SQRT((FM_SQRT(s)*SIMD_NAME(fmPow2)(h) + FM_FABS(re)*scale)*(FM_S)0.5);
+    d = (t == 0 ? im : im*scale/(2*t));
+    scale = SIMD_NAME(fmPow2)((e - h)/2);
+    t *= scale;
+    d *= scale;
+
+    /* sqrt z = t + i y/2t, or |y|/2t + i sign(y) t when x < 0; infinite y
+       gives inf + iy whatever x is */
+    zp[2*i] = (iminf ? (FM_S)INFINITY : (re < 0 ? FM_FABS(d) : t));
+    zp[2*i+1] = (iminf ? im : (re < 0 ? FM_COPYSIGN(t, im) : d));
+  }
+}
+
+/* z = x^c = exp(c log x); 0^c is 0, or 1 for c = 0 */
+SIMD_LINKAGE void SIMD_NAME(fastPow)(real *z, const real *x, const real c, const long n)
+{
+  const FM_S *xp = (const FM_S*)x;
+  const FM_S *cp = (const FM_S*)&c;
+  const FM_S cr = cp[0], ci = cp[1];
+  const FM_S zero = (cr == 0 && ci == 0 ? 1 : 0);
+  FM_S *zp = (FM_S*)z;
+  long i;
+
+  #pragma omp simd
+  for(i = 0; i < n; i++)
+  {
+    FM_S re = xp[2*i], im = xp[2*i+1];
+    FM_I e;
+    FM_S s = SIMD_NAME(fmScaledNorm)(re, im, &e);
+    FM_S lr = SIMD_NAME(fmHalfLog)(s, e);
+    FM_S li = SIMD_NAME(fmAtan2)(im, re);
+    FM_S wr = cr*lr - ci*li, wi = cr*li + ci*lr;
+    FM_S m = SIMD_NAME(fmExp)(wr);
+    FM_S co;
+    int isZero = (re == 0 && im == 0);
+
+    SIMD_NAME(fmSinCos)(wi, &s, &co);
+    zp[2*i] = (isZero ? zero : m*co);
+    zp[2*i+1] = (isZero ? 0 : m*s);
+  }
+}
+
+/* real results: z[i] = |x[i]| and arg x[i] */
+SIMD_LINKAGE void SIMD_NAME(fastAbs)(FM_S *z, const real *x, const long n)
+{
+  const FM_S *xp = (const FM_S*)x;
+  long i;
+
+  #pragma omp simd
+  for(i = 0; i < n; i++)
+  {
+    FM_I e;
+    FM_S s = SIMD_NAME(fmScaledNorm)(xp[2*i], xp[2*i+1], &e);
+    z[i] = FM_SQRT(s) * SIMD_NAME(fmPow2)(e);
+  }
+}
+
+SIMD_LINKAGE void SIMD_NAME(fastArg)(FM_S *z, const real *x, const long n)
+{
+  const FM_S *xp = (const FM_S*)x;
+  long i;
+
+  #pragma omp simd
+  for(i = 0; i < n; i++)
+    z[i] = SIMD_NAME(fmAtan2)(xp[2*i+1], xp[2*i]);
+}
+
+/* z[i] = mag[i] e^(i phase[i]) */
+SIMD_LINKAGE void SIMD_NAME(fastFromPolar)(real *z, const FM_S *mag, const FM_S *phase, const long n)
+{
+  FM_S *zp = (FM_S*)z;
+  long i;
+
+  #pragma omp simd
+  for(i = 0; i < n; i++)
+  {
+    FM_S s, c;
+
+    SIMD_NAME(fmSinCos)(phase[i], &s, &c);
+    zp[2*i] = mag[i]*c;
+    zp[2*i+1] = mag[i]*s;
+  }
+}
+
+#undef FM_S
+#undef FM_U
+#undef FM_I
+#undef FM_MANT
+#undef FM_BIAS
+#undef FM_FABS
+#undef FM_SQRT
+#undef FM_COPYSIGN
+#undef FM_SHIFT
+#undef FM_EXP_LO
+#undef FM_EXP_HI
+#undef FM_LN2_1
+#undef FM_LN2_2
+#undef FM_PIO2_1
+#undef FM_PIO2_2
+#undef FM_PIO2_3
+#undef FM_PI
+#undef FM_PI_LO
+#undef FM_PIO8
+#undef FM_TAN_PIO8
+#undef FM_LOG2E
+#undef FM_2OPI
+#undef FM_SQRT2
+#undef FM_TAN_PIO16
+#undef FM_TAN_3PIO16
+#undef SIMD_DOUBLE
+#undef SIMD_LINKAGE
@@ -0,0 +1,87 @@
+/**
+ * Copyright (c) 2015-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#ifndef THZ_SIMD_INC
+#define THZ_SIMD_INC
+
+#include "THZGeneral.h"
+
+/* Instruction set extensions reported by THZVector_simdExtensions() */
+#define THZ_SIMD_SSE3    1
+#define THZ_SIMD_AVX2    2
+#define THZ_SIMD_AVX512  4
+
+THZ_API int THZVector_simdExtensions(void);
+
+/* Complex kernels on contiguous arrays, one set per instruction set. Each
+   file under vector/ is compiled with the flags of its instruction set and
+   is only called after the cpu has been checked at load time.
+
+   cmul:     z = x * y
+   cmulconj: z = x * conj(y)
+   cmac:     z += c * x * y
+   cmacconj: z += c * x * conj(y)
+   cdotc:    returns the sum of x * conj(y)
+   cadd:     z = x + c * y
+   cscale:   z = c * x
+
+   n counts complex elements; z may alias x or y.
+
+   The fast math kernels of vector/fastmath_kernels.h come in the same sets:
+   fastExp, fastLog, fastSqrt and fastPow (z = x^c) are complex, fastAbs and
+   fastArg write n real results, and fastFromPolar makes z = mag e^(i phase)
+   from n magnitudes and phases. */
+#define THZ_SIMD_DECLARE(EXT) \
+  void THZFloatVector_cmul_##EXT(float complex *z, const float complex *x, const float complex *y, const long n); \
+  void THZFloatVector_cmulconj_##EXT(float complex *z, const float complex *x, const float complex *y, const long n); \
+  void THZFloatVector_cmac_##EXT(float complex *z, const float complex *x, const float complex *y, const float complex c, const long n); \
+  void THZFloatVector_cmacconj_##EXT(float complex *z, const float complex *x, const float complex *y, const float complex c, const long n); \
+  float complex THZFloatVector_cdotc_##EXT(const float complex *x, const float complex *y, const long n); \
+  void THZFloatVector_cadd_##EXT(float complex *z, const float complex *x, const float complex *y, const float complex c, const long n); \
+  void THZFloatVector_cscale_##EXT(float complex *z, const float complex *x, const float complex c, const long n); \
+  void THZDoubleVector_cmul_##EXT(double complex *z, const double complex *x, const double complex *y, const long n); \
+  void THZDoubleVector_cmulconj_##EXT(double complex *z, const double complex *x, const double complex *y, const long n); \
+  void THZDoubleVector_cmac_##EXT(double complex *z, const double complex *x, const double complex *y, const double complex c, const long n); \
+  void THZDoubleVector_cmacconj_##EXT(double complex *z, const double complex *x, const double complex *y, const double complex c, const long n); \
+  double complex THZDoubleVector_cdotc_##EXT(const double complex *x, const double complex *y, const long n); \
+  void THZDoubleVector_cadd_##EXT(double complex *z, const double complex *x, const double complex *y, const double complex c, const long n); \
+  void THZDoubleVector_cscale_##EXT(double complex *z, const double complex *x, const double complex c, const long n); \
+  void THZFloatVector_fastExp_##EXT(float complex *z, const float complex *x, const long n); \
+  void THZFloatVector_fastLog_##EXT(float complex *z, const float complex *x, const long n); \
+  void THZFloatVector_fastSqrt_##EXT(float complex *z, const float complex *x, const long n); \
+  void THZFloatVector_fastPow_##EXT(float complex *z, const float complex *x, const float complex c, const long n); \
+  void THZFloatVector_fastAbs_##EXT(float *z, const float complex *x, const long n); \
+  void THZFloatVector_fastArg_##EXT(float *z, const float complex *x, const long n); \
+  void THZFloatVector_fastFromPolar_##EXT(float complex *z, const float *mag, const float *phase, const long n); \
+  void THZDoubleVector_fastExp_##EXT(double complex *z, const double complex *x, const long n); \
+  void THZDoubleVector_fastLog_##EXT(double complex *z, const double complex *x, const long n); \
+  void THZDoubleVector_fastSqrt_##EXT(double complex *z, const double complex *x, const long n); \
+  void THZDoubleVector_fastPow_##EXT(double complex *z, const double complex *x, const double complex c, const long n); \
+  void THZDoubleVector_fastAbs_##EXT(double *z, const double complex *x, const long n); \
+  void THZDoubleVector_fastArg_##EXT(double *z, const double complex *x, const long n); \
+  void THZDoubleVector_fastFromPolar_##EXT(double complex *z, const double *mag, const double *phase, const long n);
+
+#ifdef THZ_HAVE_SSE3
+THZ_SIMD_DECLARE(SSE3)
+#endif
+
+#ifdef THZ_HAVE_AVX2
+THZ_SIMD_DECLARE(AVX2)
+
+/* gemm micro-kernels for the 8x3 (float) and 4x3 (double) tiles of
+   THZVector.h, built on fma */
+void THZFloatVector_gemmKernel_AVX2(const long kc, const float complex *a, const float complex *b, float complex *c, const long ldc);
+void THZDoubleVector_gemmKernel_AVX2(const long kc, const double complex *a, const double complex *b, double complex *c, const long ldc);
+#endif
+
+#ifdef THZ_HAVE_AVX512
+THZ_SIMD_DECLARE(AVX512)
+#endif
+
+#endif
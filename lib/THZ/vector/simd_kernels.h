@@ -0,0 +1,173 @@
+/**
+ * Copyright (c) 2015-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+/* Complex kernel bodies shared by every instruction set. The including file
+   defines:
+     real             the complex element type
+     SIMD_NAME(NAME)  the exported name of kernel NAME
+     V, W             the vector type and the number of complex per vector
+     VLOAD(p), VSTORE(p, v), VADD(a, b)
+     VCMUL(a, b), VCMULCONJ(a, b), VSET1(c), SIMD_CONJ(z)
+   and everything is undefined again at the end of this file. */
+
+void SIMD_NAME(cmul)(real *z, const real *x, const real *y, const long n)
+{
+  long i = 0;
+
+  for(; i <= n-2*W; i += 2*W)
+  {
+    V a0 = VLOAD(x+i), a1 = VLOAD(x+i+W);
+    V b0 = VLOAD(y+i), b1 = VLOAD(y+i+W);
+    VSTORE(z+i, VCMUL(a0, b0));
+    VSTORE(z+i+W, VCMUL(a1, b1));
+  }
+
+  for(; i <= n-W; i += W)
+    VSTORE(z+i, VCMUL(VLOAD(x+i), VLOAD(y+i)));
+
+  for(; i < n; i++)
+    z[i] = x[i] * y[i];
+}
+
+void SIMD_NAME(cmulconj)(real *z, const real *x, const real *y, const long n)
+{
+  long i = 0;
+
+  for(; i <= n-2*W; i += 2*W)
+  {
+    V a0 = VLOAD(x+i), a1 = VLOAD(x+i+W);
+    V b0 = VLOAD(y+i), b1 = VLOAD(y+i+W);
+    VSTORE(z+i, VCMULCONJ(a0, b0));
+    VSTORE(z+i+W, VCMULCONJ(a1, b1));
+  }
+
+  for(; i <= n-W; i += W)
+    VSTORE(z+i, VCMULCONJ(VLOAD(x+i), VLOAD(y+i)));
+
+  for(; i < n; i++)
+    z[i] = x[i] * SIMD_CONJ(y[i]);
+}
+
+void SIMD_NAME(cmac)(real *z, const real *x, const real *y, const real c, const long n)
+{
+  long i = 0;
+  V cv = VSET1(c);
+
+  if(c == 1)
+  {
+    for(; i <= n-W; i += W)
+      VSTORE(z+i, VADD(VLOAD(z+i), VCMUL(VLOAD(x+i), VLOAD(y+i))));
+  }
+  else
+  {
+    for(; i <= n-W; i += W)
+      VSTORE(z+i, VADD(VLOAD(z+i), VCMUL(VCMUL(VLOAD(x+i), VLOAD(y+i)), cv)));
+  }
+
+  for(; i < n; i++)
+    z[i] += c * x[i] * y[i];
+}
+
+void SIMD_NAME(cmacconj)(real *z, const real *x, const real *y, const real c, const long n)
+{
+  long i = 0;
+  V cv = VSET1(c);
+
+  if(c == 1)
+  {
+    for(; i <= n-W; i += W)
+      VSTORE(z+i, VADD(VLOAD(z+i), VCMULCONJ(VLOAD(x+i), VLOAD(y+i))));
+  }
+  else
+  {
+    for(; i <= n-W; i += W)
+      VSTORE(z+i, VADD(VLOAD(z+i), VCMUL(VCMULCONJ(VLOAD(x+i), VLOAD(y+i)), cv)));
+  }
+
+  for(; i < n; i++)
+    z[i] += c * x[i] * SIMD_CONJ(y[i]);
+}
+
+real SIMD_NAME(cdotc)(const real *x, const real *y, const long n)
+{
+  long i = 0, k;
+  real zero = 0, sum = 0;
+  real lanes[W];
+  V acc0 = VSET1(zero), acc1 = VSET1(zero);
+
+  for(; i <= n-2*W; i += 2*W)
+  {
+    acc0 = VADD(acc0, VCMULCONJ(VLOAD(x+i), VLOAD(y+i)));
+    acc1 = VADD(acc1, VCMULCONJ(VLOAD(x+i+W), VLOAD(y+i+W)));
+  }
+
+  for(; i <= n-W; i += W)
+    acc0 = VADD(acc0, VCMULCONJ(VLOAD(x+i), VLOAD(y+i)));
+
+  VSTORE(lanes, VADD(acc0, acc1));
+  for(k = 0; k < W; k++)
+    sum += lanes[k];
+
+  for(; i < n; i++)
+    sum += x[i] * SIMD_CONJ(y[i]);
+  return sum;
+}
+
+void SIMD_NAME(cadd)(real *z, const real *x, const real *y, const real c, const long n)
+{
+  long i = 0;
+  V cv = VSET1(c);
+
+  if(c == 1)
+  {
+    for(; i <= n-2*W; i += 2*W)
+    {
+      VSTORE(z+i, VADD(VLOAD(x+i), VLOAD(y+i)));
+      VSTORE(z+i+W, VADD(VLOAD(x+i+W), VLOAD(y+i+W)));
+    }
+  }
+  else
+  {
+    for(; i <= n-2*W; i += 2*W)
+    {
+      VSTORE(z+i, VADD(VLOAD(x+i), VCMUL(VLOAD(y+i), cv)));
+      VSTORE(z+i+W, VADD(VLOAD(x+i+W), VCMUL(VLOAD(y+i+W), cv)));
+    }
+  }
+
+  for(; i < n; i++)
+    z[i] = x[i] + c * y[i];
+}
+
+void SIMD_NAME(cscale)(real *z, const real *x, const real c, const long n)
+{
+  long i = 0;
+  V cv = VSET1(c);
+
+  for(; i <= n-2*W; i += 2*W)
+  {
+    VSTORE(z+i, VCMUL(VLOAD(x+i), cv));
+    VSTORE(z+i+W, VCMUL(VLOAD(x+i+W), cv));
+  }
+
+  for(; i < n; i++)
+    z[i] = c * x[i];
+}
+
+#undef real
+#undef SIMD_NAME
+#undef SIMD_CONJ
+#undef V
+#undef W
+#undef VLOAD
+#undef VSTORE
+#undef VADD
+#undef VCMUL
+#undef VCMULCONJ
+#undef VSET1
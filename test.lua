@@ -262,6 +262,115 @@ function ztest.dot()
    assert(res.im == 7 * sz, 'expected ' .. 7*sz .. ' but found: ' .. res.im)
 end
 
+function ztest.conjProducts()
+   local n = 100003
+   local a = torch.ZDoubleTensor(n):normal()
+   local b = torch.ZDoubleTensor(n):normal()
+   local ref = a:clone():cmul(b:clone():conj())
+   mytester:assertlt((a:clone():cmulconj(b) - ref):abs():max(), precision, 'cmulconj differs from cmul with conj')
+   local acc = torch.ZDoubleTensor(n):normal()
+   local expected = acc + ref * 0.5
+   acc:addcmulconj(0.5, a, b)
+   mytester:assertlt((acc - expected):abs():max(), precision, 'addcmulconj differs from add of cmul with conj')
+   local dot, sum = a:dot(b), ref:sum()
+   mytester:assertlt((math.abs(dot.re - sum.re) + math.abs(dot.im - sum.im)) / n, precision, 'dot is not the sum of a * conj(b)')
+end
+
+function ztest.exprFusion()
+   local x = torch.ZDoubleTensor(300, 257):normal()
+   local h = torch.ZDoubleTensor(257, 300):normal():t()
+   local noise = torch.ZDoubleTensor(300, 257):normal()
+   local ref = x:clone():cmul(h):add(0.5):exp():mul(2-z.im(1)):cmulconj(h):add(0.1, noise):sqrt():div(3)
+   local fused = x:lazy():cmul(h):add(0.5):exp():mul(2-z.im(1)):cmulconj(h):add(0.1, noise):sqrt():div(3):eval()
+   mytester:assertlt((fused - ref):abs():max(), precision, 'fused expression differs from the chain of ops')
+   -- into one of its operands, with nested expressions deeper than the registers
+   local e = x:lazy()
+   for i = 1, 10 do
+      e = x:lazy():add(e:mul(0.5))
+   end
+   ref = x * (2 - 0.5^10)
+   mytester:assertlt((e:eval(x) - ref):abs():max(), precision, 'nested expression differs')
+end
+
+function ztest.polar()
+   for _,T in ipairs{torch.ZFloatTensor, torch.ZDoubleTensor} do
+      local x = T(100, 57):normal()
+      local mag, phase = x:polar()
+      mytester:assertlt((mag - x:abs()):abs():max(), precision, 'polar magnitude differs from abs')
+      mytester:assertlt((phase - x:arg()):abs():max(), precision, 'polar phase differs from arg')
+      local y = T():fromPolar(mag, phase)
+      mytester:assertlt((y - x):abs():max(), precision, 'fromPolar does not invert polar')
+      -- non-contiguous operands
+      local xt = x:t()
+      local magt, phaset = mag:t(), phase:t()
+      xt:polar(magt, phaset)
+      y:t():fromPolar(magt, phaset)
+      mytester:assertlt((y - x):abs():max(), precision, 'fromPolar of transposed tensors differs')
+   end
+end
+
+function ztest.abs2()
+   for _,T in ipairs{torch.ZFloatTensor, torch.ZDoubleTensor} do
+      local x = T(40, 30, 20):normal()
+      local power = x:abs():pow(2)
+      mytester:assertlt((x:abs2() - power):abs():max(), precision, 'abs2 differs from abs^2')
+      mytester:assertlt(math.abs(x:sumAbs2() - power:sum()) / power:sum(), precision, 'sumAbs2 differs')
+      for dim = 1, 3 do
+         local ref = power:sum(dim)
+         mytester:assertlt((x:sumAbs2(dim) - ref):abs():max(), precision * 10, 'sumAbs2 along ' .. dim .. ' differs')
+         -- non-contiguous source
+         local xt = x:transpose(1, 3)
+         mytester:assertlt((xt:sumAbs2(4 - dim) - ref:transpose(1, 3)):abs():max(), precision * 10,
+                           'sumAbs2 of a transposed tensor differs')
+      end
+      mytester:assertlt(math.abs(x:norm().re - math.sqrt(power:sum())), precision * 10, 'norm 2 differs')
+   end
+end
+
+function ztest.fastMath()
+   for _,T in ipairs{torch.ZFloatTensor, torch.ZDoubleTensor} do
+      local x = T(100, 57):normal()
+      local mag, phase = x:polar()
+      local ref = {x:clone():exp(), x:clone():log(), x:clone():sqrt(), x:clone():pow(2.5),
+                   x:abs(), x:arg(), x:lazy():log():exp():eval(),
+                   mag, phase, T():fromPolar(mag, phase)}
+      ztorch.setFastMath(true)
+      local fastMag, fastPhase = x:polar()
+      local fast = {x:clone():exp(), x:clone():log(), x:clone():sqrt(), x:clone():pow(2.5),
+                    x:abs(), x:arg(), x:lazy():log():exp():eval(),
+                    fastMag, fastPhase, T():fromPolar(mag, phase)}
+      mytester:assert(ztorch.fastMath(), 'fast math mode not set')
+      ztorch.setFastMath(false)
+      for i = 1, #ref do
+         mytester:assertlt((fast[i] - ref[i]):abs():max(), precision, 'fast math result ' .. i .. ' differs')
+      end
+
+      -- NaNs propagate and -0 keeps the side of the branch cut, as in libm
+      local s = T(2)
+      s[1] = cpx.type(-4, -0.0)
+      s[2] = cpx.type(0/0, 1)
+      ztorch.setFastMath(true)
+      local phase, lg, sq = s:arg(), s:clone():log(), s:clone():sqrt()
+      ztorch.setFastMath(false)
+      mytester:assertlt(math.abs(phase[1] + math.pi), precision, 'fast arg(-4-0i) is not -pi')
+      mytester:assert(lg[1].im < 0 and sq[1].im < 0, 'fast log or sqrt of -4-0i is on the wrong side of the cut')
+      mytester:assert(phase[2] ~= phase[2] and lg[2].im ~= lg[2].im, 'fast arg of NaN is not NaN')
+
+      -- sqrt of |z| past the largest real, and of subnormals
+      local big, tiny = 3e38, 1e-45
+      if T == torch.ZDoubleTensor then
+         big, tiny = 1.5e308, 5e-324
+      end
+      s[1] = cpx.type(big, big)
+      s[2] = cpx.type(-tiny, tiny)
+      local exact = s:clone():sqrt()
+      ztorch.setFastMath(true)
+      sq = s:clone():sqrt()
+      ztorch.setFastMath(false)
+      mytester:assertlt((sq - exact):abs():cdiv(exact:abs()):max(), precision, 'fast sqrt of huge or subnormal z differs')
+   end
+end
+
 function ztest.mv()
    local t = torch.ZFloatTensor(3, 2):fill(1+z.im(2))
    local t2 = torch.ZFloatTensor(2):fill(2-z.im(3))
@@ -288,6 +397,61 @@ function ztest.mm()
    end
 end
 
+function ztest.mmBlocked()
+   -- big enough for the packed gemm, with edge tiles on both sides and
+   -- more than one kc-deep panel; each column is checked against mv.
+   -- addmmBlocked runs the packed gemm even on BLAS builds, where addmm
+   -- calls the library
+   local a = torch.ZDoubleTensor(37, 300):normal()
+   local b = torch.ZDoubleTensor(29, 300):normal():t()
+   local res = torch.ZDoubleTensor(37, 29):fill(1):addmm(0, 2, a, b)
+   local blocked = torch.ZDoubleTensor(37, 29):fill(1):addmmBlocked(0, 2, a, b)
+   for j=1,29 do
+      local ref = a * b:select(2, j)
+      mytester:assertlt((res:select(2, j) - ref * 2):abs():max(), precision, 'mm is wrong at column ' .. j)
+      mytester:assertlt((blocked:select(2, j) - ref * 2):abs():max(), precision, 'blocked mm is wrong at column ' .. j)
+   end
+
+   -- transposed operands and beta != 0
+   local c = torch.ZDoubleTensor(29, 37):normal()
+   local expected = c:clone():mul(0.5):addmm(1, b:t(), a:t())
+   c:addmmBlocked(0.5, 1, b:t(), a:t())
+   mytester:assertlt((c - expected):abs():max(), precision, 'blocked mm of transposed operands is wrong')
+end
+
+function ztest.addmm3m()
+   -- the 3M imaginary part has error up to k*eps*sum(|re a|+|im a|)*(|re b|+|im b|)
+   -- against k*eps*sum |a|*|b| for addmm; with normal entries both stay far
+   -- below 16*k*eps in single precision
+   local k = 256
+   local tolerance = 16 * k * 2^-23
+   local a = torch.ZFloatTensor(64, k):normal()
+   local b = torch.ZFloatTensor(k, 48):normal()
+   local c = torch.ZFloatTensor(64, 48):normal()
+   local ref = c:clone():addmm(2, 1, a, b)
+   mytester:assertlt((c:clone():addmm3m(2, 1, a, b) - ref):abs():max(), tolerance, 'addmm3m is not accurate enough')
+   mytester:assertlt((a:mm3m(b) - a * b):abs():max(), tolerance, 'mm3m is not accurate enough')
+end
+
+function ztest.mixedProducts()
+   local a = torch.ZDoubleTensor(5, 4):normal()
+   local w = torch.DoubleTensor(4, 3):normal()
+   local v = torch.DoubleTensor(4):normal()
+   local wz = torch.ZDoubleTensor(4, 3):copy(w)
+   local vz = torch.ZDoubleTensor(4):copy(v)
+   mytester:assertlt((a * w - a * wz):abs():max(), precision, 'complex by real mm is wrong')
+   mytester:assertlt((a * v - a * vz):abs():max(), precision, 'complex by real mv is wrong')
+   local c = torch.ZDoubleTensor(3, 5):normal()
+   local ref = c:clone():addmm(2, 3, wz:t(), a:t())
+   mytester:assertlt((c:addmm(2, 3, w:t(), a:t()) - ref):abs():max(), precision, 'real by complex addmm is wrong')
+   local y = torch.ZDoubleTensor(3):normal()
+   ref = y:clone():addmv(1, 1, wz:t(), a[1])
+   mytester:assertlt((y:addmv(1, 1, w:t(), a[1]) - ref):abs():max(), precision, 'real by complex addmv is wrong')
+   local p = torch.DoubleTensor(5, 4):normal()
+   ref = a:clone():cmul(torch.ZDoubleTensor(5, 4):copy(p))
+   mytester:assertlt((a:clone():cmul(p) - ref):abs():max(), precision, 'complex by real cmul is wrong')
+end
+
 function ztest.ger()
    local sz = 4
    local t = torch.ZFloatTensor(sz):fill(1+z.im(2))
@@ -347,6 +511,23 @@ function ztest.addmm_scale_dst()
    end
 end
 
+function ztest.baddbmm()
+   local b1 = torch.ZFloatTensor(5, 3, 4):normal()
+   local b2 = torch.ZFloatTensor(5, 4, 2):normal()
+   local t = torch.ZFloatTensor(5, 3, 2):normal()
+   local res = torch.ZFloatTensor():baddbmm(2, t, 3, b1, b2)
+   local prod = b1:bmm(b2)
+   local sum = torch.ZFloatTensor(3, 2):zero()
+   for i=1,5 do
+      local ref = torch.ZFloatTensor():addmm(2, t[i], 3, b1[i], b2[i])
+      mytester:assertlt((res[i] - ref):abs():max(), precision, 'baddbmm differs from addmm at ' .. i)
+      mytester:assertlt((prod[i] - b1[i] * b2[i]):abs():max(), precision, 'bmm differs from mm at ' .. i)
+      sum:add(b1[i] * b2[i])
+   end
+   local acc = torch.ZFloatTensor():addbmm(0, t[1], 1, b1, b2)
+   mytester:assertlt((acc - sum):abs():max(), precision, 'addbmm differs from the sum of products')
+end
+
 function ztest.addru()
    local sz = 4
    local t = torch.ZFloatTensor(sz):fill(1+z.im(2))
@@ -473,6 +654,305 @@ function ztest.abs()
    mytester:assertlt((res[2] - math.sqrt(74)), 1e-4, 'expected sqrt(74) but found ' .. res[2])
 end
 
+function ztest.cmulContiguous()
+   -- odd sizes exercise the SIMD kernels' scalar tails
+   for _,sz in ipairs{1, 7, 4099} do
+      local a = torch.ZFloatTensor(sz):normal()
+      local b = torch.ZFloatTensor(sz):normal()
+      local c = torch.ZFloatTensor(sz):normal()
+      local ref = torch.ZFloatTensor(sz)
+      for i=1,sz do
+         ref[i] = c[i] + 2 * a[i] * b[i] + (1-z.im(3)) * (a[i] * b[i])
+      end
+      local res = c:clone():addcmul(2, a, b):add(1-z.im(3), a:clone():cmul(b))
+      mytester:assertlt((res - ref):abs():max(), precision, 'contiguous kernels are wrong for size ' .. sz)
+   end
+end
+
+function ztest.stridedApply()
+   -- transposed, narrowed views go through the parallel apply engine; the
+   -- results must match the same ops on contiguous copies
+   local base = torch.ZDoubleTensor(60, 70, 50):zero()
+   local a = base:narrow(2, 3, 60):transpose(1, 3)
+   a:fill(1-z.im(2))
+   mytester:assert(base:narrow(2, 1, 2):abs():max() == 0, 'fill wrote outside of its view')
+   mytester:assert(base:narrow(2, 63, 8):abs():max() == 0, 'fill wrote outside of its view')
+   mytester:assertlt((a - (1-z.im(2))):abs():max(), precision, 'fill is wrong')
+
+   a:copy(torch.ZDoubleTensor(a:size()):normal())
+   local b = torch.ZDoubleTensor(60, 60, 50):normal():transpose(1, 3)
+   local ac, bc = a:clone(), b:clone()
+   mytester:assertlt((a:clone():cmul(b) - ac:clone():cmul(bc)):abs():max(), precision, 'cmul is wrong')
+   mytester:assertlt((torch.ZDoubleTensor():exp(a) - ac:clone():exp()):abs():max(), precision, 'exp is wrong')
+   mytester:assertlt((a:clone():addcdiv(2, a, b) - ac:clone():addcdiv(2, ac, bc)):abs():max(), precision, 'addcdiv is wrong')
+end
+
+function ztest.random()
+   ztorch.manualSeed(123)
+   local a = torch.ZDoubleTensor(200, 300):complexNormal(1-z.im(1), 2)
+   mytester:assert(ztorch.initialSeed() == 123, 'wrong initial seed')
+   mytester:assertlt(cpx.abs(a:sumall() / a:nElement() - (1-z.im(1))), 0.02, 'complexNormal has the wrong mean')
+   local d = a - (1-z.im(1))
+   mytester:assertlt(math.abs((d:dot(d)).re / a:nElement() - 4), 0.1, 'complexNormal has the wrong variance')
+
+   -- same seed, same values, also when filling a transposed view
+   ztorch.manualSeed(123)
+   local b = torch.ZDoubleTensor(300, 200):t():complexNormal(1-z.im(1), 2)
+   mytester:assertlt((a - b):abs():max(), precision, 'complexNormal is not reproducible')
+
+   local u = torch.ZFloatTensor(1000):uniform(-1, 3)
+   local re, im = u:re(), u:im()
+   mytester:assert(re:min() >= -1 and re:max() < 3 and im:min() >= -1 and im:max() < 3, 'uniform is out of bounds')
+end
+
+function ztest.alignment()
+   for _, n in ipairs{1, 3, 17, 1000, 65537} do
+      local a = torch.ZFloatTensor(n)
+      mytester:assert(a:isAligned() and a:storage():isAligned(), 'storage of size ' .. n .. ' is not aligned')
+      a:resize(3 * n + 1)
+      mytester:assert(a:isAligned(), 'resized storage is not aligned')
+   end
+   local b = torch.ZDoubleTensor(10, 8)
+   mytester:assert(b:narrow(2, 5, 4):isAligned(), 'offset of 64 bytes is not aligned')
+   mytester:assert(not b:narrow(2, 2, 4):isAligned(), 'offset of 16 bytes is aligned')
+end
+
+function ztest.mappedFile()
+   local filename = os.tmpname()
+   local a = torch.ZDoubleTensor(5, 7, 3):normal()
+   a:transpose(1, 3):writeMapped(filename)
+   local b = ztorch.loadMapped(filename)
+   mytester:assert(torch.typename(b) == 'torch.ZDoubleTensor', 'mapped tensor has the wrong type')
+   mytester:assert(b:isSameSizeAs(a:transpose(1, 3)), 'mapped tensor has the wrong size')
+   mytester:assertlt((b - a:transpose(1, 3)):abs():max(), precision, 'mapped tensor has the wrong values')
+
+   local c = ztorch.loadMapped(filename, true)
+   c:fill(2)
+   c = nil
+   collectgarbage()
+   mytester:assert(ztorch.loadMapped(filename)[{1, 2, 3}] == 2, 'shared writes do not reach the file')
+   os.remove(filename)
+end
+
+function ztest.serialization()
+   for _,ZTensor in ipairs{torch.ZFloatTensor, torch.ZDoubleTensor} do
+      local a = ZTensor(13, 7):normal()
+      for _,binary in ipairs{true, false} do
+         local f = torch.MemoryFile()
+         if binary then f:binary() end
+         f:writeObject(a:t())
+         f:seek(1)
+         local b = f:readObject()
+         f:close()
+         mytester:assert(torch.typename(b) == torch.typename(a), 'read tensor has the wrong type')
+         mytester:assert(b:isSameSizeAs(a:t()), 'read tensor has the wrong size')
+         mytester:assertlt((b - a:t()):abs():max(), precision, 'read tensor has the wrong values')
+      end
+   end
+end
+
+function ztest.compressedSerialization()
+   local a = torch.ZDoubleTensor(300, 257):normal()
+   a:narrow(1, 1, 100):zero()
+   for _, tolerance in ipairs{0, 1e-3} do
+      ztorch.setCompression(tolerance > 0 and 'lossy' or 'lossless', tolerance)
+      local f = torch.MemoryFile():binary()
+      f:writeObject(a)
+      f:seek(1)
+      local b = f:readObject()
+      f:close()
+      local err = (b - a):abs():max()
+      if tolerance > 0 then
+         mytester:assertlt(err, tolerance * math.sqrt(2) + precision, 'lossy compression exceeds its tolerance')
+      else
+         mytester:assert(err == 0, 'lossless compression changes the values')
+      end
+   end
+   ztorch.setCompression('none')
+end
+
+function ztest.chunks()
+   local input, output = os.tmpname(), os.tmpname()
+   local a = torch.ZFloatTensor(1000, 7, 3):normal()
+   a:writeMapped(input)
+   local writer = ztorch.chunkWriter(output, 'torch.ZFloatTensor', a:size())
+   local rows = 0
+   for chunk, first in ztorch.chunks(input, 64) do
+      mytester:assert(first == rows + 1, 'chunks skip rows')
+      mytester:assertlt((chunk - a:narrow(1, first, chunk:size(1))):abs():max(), precision, 'chunk has the wrong values')
+      writer:write(chunk:mul(2))
+      rows = rows + chunk:size(1)
+   end
+   writer:close()
+   mytester:assert(rows == 1000, 'chunks miss rows')
+   mytester:assertlt((ztorch.loadMapped(output) - a * 2):abs():max(), precision, 'streamed tensor has the wrong values')
+   os.remove(input)
+   os.remove(output)
+end
+
+function ztest.partViews()
+   local a = torch.ZFloatTensor(7, 5):normal()
+   local v = a:t():narrow(1, 2, 3)
+   local re, im = v:realView(), v:imagView()
+   mytester:assert(torch.typename(re) == 'torch.FloatTensor', 'realView is not a FloatTensor')
+   mytester:assertlt((re - v:re()):abs():max(), precision, 'realView differs from re')
+   mytester:assertlt((im - v:im()):abs():max(), precision, 'imagView differs from im')
+
+   local ref = v:clone():conj()
+   im:mul(-1)
+   mytester:assertlt((v - ref):abs():max(), precision, 'imagView does not share storage')
+   a = nil
+   v = nil
+   collectgarbage()
+   mytester:assertlt((re - ref:re()):abs():max(), precision, 'realView does not keep the storage alive')
+
+   local b = torch.randn(4, 3, 2)
+   local c = b:complexView()
+   mytester:assert(torch.typename(c) == 'torch.ZDoubleTensor' and c:dim() == 2, 'complexView has the wrong type')
+   mytester:assertlt((c - torch.ZDoubleTensor(4, 3):copy(b)):abs():max(), precision, 'complexView differs from copy')
+   local x = b[{2, 3, 1}]
+   c:mul(z.im(1))
+   mytester:assert(b[{2, 3, 1}] == c[{2, 3}].re and b[{2, 3, 2}] == c[{2, 3}].im, 'complexView does not share storage')
+   mytester:assert(b[{2, 3, 2}] == x, 'complexView does not write to the real tensor')
+   mytester:assertlt((b:narrow(1, 2, 2):complexView() - c:narrow(1, 2, 2)):abs():max(), precision, 'complexView of a narrowed tensor is wrong')
+end
+
+function ztest.numaAllocator()
+   for _, mode in ipairs{'local', 'interleave', 'bind'} do
+      local s = torch.ZDoubleStorage(ztorch.numaAllocator, 100000, ztorch.numaPolicy(mode))
+      local a = torch.ZDoubleTensor(s)
+      mytester:assert(s:isAligned() and a:isAligned(), mode .. ' storage is not aligned')
+      a:fill(1-z.im(2))
+      s:resize(150000)
+      mytester:assertlt(cpx.abs(a:sumall() - 100000 * (1-z.im(2))), precision, mode .. ' storage lost its data')
+   end
+   mytester:assert(ztorch.numaPolicy('bind', {0}) == ztorch.numaPolicy('bind', {0}), 'policies are not interned')
+end
+
+function ztest.cachingAllocator()
+   -- operands without a unit stride, which addmm copies into scratch tensors
+   local a = torch.ZDoubleTensor(50, 60, 2):normal():select(3, 1)
+   local b = torch.ZDoubleTensor(60, 70, 2):normal():select(3, 2)
+   local ref = torch.ZDoubleTensor(50, 70):zero():addmm(a:clone(), b:clone())
+   local c = torch.ZDoubleTensor(50, 70)
+   c:zero():addmm(a, b)
+   local s0 = ztorch.allocatorStats()
+   c:zero():addmm(a, b)
+   local s1 = ztorch.allocatorStats()
+   mytester:assertlt((c - ref):abs():max(), precision, 'addmm on scratch copies is wrong')
+   mytester:assert(s1.hits > s0.hits, 'repeated addmm does not reuse its temporaries')
+   mytester:assert(s1.highWater >= s1.inUse + s1.cached, 'inconsistent high-water mark')
+
+   ztorch.trimAllocator()
+   mytester:assert(ztorch.allocatorStats().cached == 0, 'trim leaves cached blocks')
+end
+
+function ztest.splitTensor()
+   local sz = 37
+   local a = torch.ZFloatTensor(sz, 3):normal()
+   local b = torch.ZFloatTensor(sz, 3):normal()
+   local sa = a:split()
+   local sb = torch.ZFloatSplitTensor(sz, 3):copy(b)
+   mytester:assert(torch.typename(sa) == 'torch.ZFloatSplitTensor')
+
+   local res = a:clone():cmul(b):add(2+z.im(1), b):mul(0.5-z.im(2)):addcmul(3, a, b)
+   local sres = sa:clone():cmul(sb):add(2+z.im(1), sb):mul(0.5-z.im(2)):addcmul(3, sa, sb)
+   local diff = (res - sres:interleaved()):abs():max()
+   mytester:assertlt(diff, precision, 'split kernels differ from interleaved ones')
+
+   -- views on both planes, real part shares storage
+   local st = sa:t()
+   mytester:assert(not st:isContiguous())
+   local rt = torch.ZFloatTensor(3, sz):copy(st)
+   mytester:assertlt((rt - a:t()):abs():max(), precision, 'transposed split view is wrong')
+   sa:re():fill(1)
+   mytester:assert(sa:interleaved()[{2, 2}].re == 1, 're() does not share storage')
+end
+
+function ztest.fft()
+   -- 12 takes the radix-4/3 passes, 17 goes through Bluestein
+   for _,n in ipairs{12, 17} do
+      local a = torch.ZDoubleTensor(n, 4):normal()
+      local ref = torch.ZDoubleTensor(n, 4):zero()
+      for k=1,n do
+         for j=1,n do
+            local w = cpx.exp(-2 * math.pi * z.im(1) * ((j-1)*(k-1) % n) / n)
+            for b=1,4 do
+               ref[k][b] = ref[k][b] + a[j][b] * w
+            end
+         end
+      end
+      local res = torch.ZDoubleTensor():fft(a, 1)
+      mytester:assertlt((res - ref):abs():max(), precision, 'fft is wrong for size ' .. n)
+      local t = a:t():clone()
+      t:fft()
+      mytester:assertlt((t - ref:t()):abs():max(), precision, 'in-place fft is wrong for size ' .. n)
+      t:ifft()
+      mytester:assertlt((t - a:t()):abs():max(), precision, 'ifft does not invert fft for size ' .. n)
+   end
+end
+
+function ztest.fftPlanCache()
+   local a = torch.ZFloatTensor(16, 64):normal()
+   a:prewarmFFT(2)
+   a:prewarmFFT(2, true)
+   ztorch.setFFTCacheCapacity(1)
+   local ref = a:clone():fft(2)
+   ztorch.clearFFTCache()
+   ztorch.setFFTCacheCapacity(16)
+   local res = a:clone():fft(2)
+   mytester:assertlt((res - ref):abs():max(), precision, 'cached and fresh plans differ')
+   mytester:assertlt((res:ifft(2) - a):abs():max(), precision, 'ifft with a cached plan is wrong')
+
+   -- the cache holds at most `capacity` plans and evicts to make room
+   ztorch.clearFFTCache()
+   mytester:assert(ztorch.fftCacheCount() == 0, 'clearFFTCache leaves plans')
+   a:prewarmFFT(2)
+   a:prewarmFFT(2, true)
+   a:prewarmFFT(1)
+   mytester:assert(ztorch.fftCacheCount() == 3, 'prewarmFFT does not cache its plans')
+   a:prewarmFFT(1)
+   mytester:assert(ztorch.fftCacheCount() == 3, 'a prewarmed plan is cached twice')
+   ztorch.setFFTCacheCapacity(2)
+   mytester:assert(ztorch.fftCacheCount() == 2, 'lowering the capacity does not evict')
+   a:prewarmFFT(1, true)
+   mytester:assert(ztorch.fftCacheCount() == 2, 'a new plan is cached beyond the capacity')
+   local _, ndouble = ztorch.fftCacheCount()
+   mytester:assert(ndouble == 0, 'float plans went to the double cache')
+   ztorch.setFFTCacheCapacity(16)
+end
+
+function ztest.conv2Spectral()
+   -- a batch of 24x24 images with 9x9 kernels takes the frequency-domain path of conv2Dmm
+   local input = torch.ZDoubleTensor(2, 3, 24, 24):normal()
+   local kernel = torch.ZDoubleTensor(4, 3, 9, 9):normal()
+   for _, opt in ipairs{'V', 'F'} do
+      local res = torch.ZDoubleTensor():conv2(input, kernel, opt)
+      local xres = torch.ZDoubleTensor():xcorr2(input, kernel, opt)
+      for b=1,2 do
+         -- conv2Dmv always runs the direct loops
+         local ref = torch.ZDoubleTensor():conv2(input[b], kernel, opt)
+         local xref = torch.ZDoubleTensor():xcorr2(input[b], kernel, opt)
+         mytester:assertlt((res[b] - ref):abs():max(), precision, 'spectral conv2 differs from the direct one')
+         mytester:assertlt((xres[b] - xref):abs():max(), precision, 'spectral xcorr2 differs from the direct one')
+      end
+   end
+end
+
+function ztest.conv3Spectral()
+   -- 7x7x7 kernels on 16^3 volumes take the frequency-domain path of conv3Dmv
+   local input = torch.ZDoubleTensor(4, 16, 16, 16):normal()
+   local kernel = torch.ZDoubleTensor(4, 4, 7, 7, 7):normal()
+   local res = torch.ZDoubleTensor():conv3(input, kernel)
+   local ref = torch.ZDoubleTensor(4, 10, 10, 10):zero()
+   for o=1,4 do
+      for i=1,4 do
+         ref[o]:add(torch.ZDoubleTensor():conv3(input[i], kernel[o][i]))
+      end
+   end
+   mytester:assertlt((res - ref):abs():max(), precision, 'spectral conv3 differs from the direct one')
+end
+
 function ztest.nnLinear()
    require 'nn'
    local m = nn.Linear(10,20):type('torch.ZFloatTensor')